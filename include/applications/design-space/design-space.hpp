@@ -62,16 +62,32 @@ class DesignSpaceExplorer
 {
  protected:
 
+  // One arch x problem combination, with its configuration held in memory.
+  struct DesignPoint
+  {
+    std::string name;
+    std::string config_yaml;
+  };
+
   //want a list of files for each workload
   std::string problemspec_filename_;
   std::string archspec_filename_;
 
+  // Cores shared by all design points, and mapper threads per point. Points
+  // run concurrently as long as their threads fit in the budget.
+  unsigned thread_budget_;
+  unsigned threads_per_point_;
+
   std::vector<PointResult> designs_;
-  std::vector<application::Mapper*> mappers_;
+
+  std::string BuildPointConfig(const ArchSpaceNode& arch, const ProblemSpaceNode& problem) const;
 
  public:
 
-  DesignSpaceExplorer(std::string problemfile, std::string archfile);
+  // A thread_budget of 0 uses all hardware threads; a threads_per_point of 0
+  // splits the budget evenly among the design points.
+  DesignSpaceExplorer(std::string problemfile, std::string archfile,
+                      unsigned thread_budget = 0, unsigned threads_per_point = 0);
 
   // ---------------------------------
   // Run the design space exploration.
@@ -0,0 +1,140 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "layout/layout.hpp"
+#include "util/numeric.hpp"
+
+namespace boost
+{
+namespace serialization
+{
+
+template <class Archive>
+void serialize(Archive& ar, layout::LayoutNest& nest, const unsigned int version)
+{
+  (void) version;
+  ar& nest.data_space;
+  ar& nest.type;
+  ar& nest.ranks;
+  ar& nest.factors;
+}
+
+} // namespace serialization
+} // namespace boost
+
+//--------------------------------------------//
+//             Search Checkpoints             //
+//--------------------------------------------//
+
+// State of one mapper thread at a mapping boundary. Mappings are kept as
+// their IDs in the thread's mapspace and rebuilt (and re-evaluated) when the
+// search is resumed.
+struct ThreadCheckpoint
+{
+  struct Fail
+  {
+    unsigned fail_class = 0;
+    unsigned level = 0;
+    uint128_t count = 0;
+    std::string reason;
+    uint128_t mapping_id = 0;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+      (void) version;
+      ar& fail_class;
+      ar& level;
+      ar& count;
+      ar& reason;
+      ar& mapping_id;
+    }
+  };
+
+  bool resumable = false; // false if the search algorithm cannot be resumed
+  std::string search_state;
+  std::string generator_state; // picks the sample mapping of each fail class
+
+  uint128_t total_mappings = 0;
+  uint128_t valid_mappings = 0;
+  uint128_t invalid_mappings_mapcnstr = 0;
+  uint128_t invalid_mappings_eval = 0;
+  std::uint32_t mappings_since_last_best_update = 0;
+
+  bool best_valid = false;
+  uint128_t best_mapping_id = 0;
+  std::vector<std::vector<layout::LayoutNest>> best_nests; // per level: interline, intraline, authblock_lines
+
+  std::vector<Fail> fails;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    (void) version;
+    ar& resumable;
+    ar& search_state;
+    ar& generator_state;
+    ar& total_mappings;
+    ar& valid_mappings;
+    ar& invalid_mappings_mapcnstr;
+    ar& invalid_mappings_eval;
+    ar& mappings_since_last_best_update;
+    ar& best_valid;
+    ar& best_mapping_id;
+    ar& best_nests;
+    ar& fails;
+  }
+};
+
+struct MapperCheckpoint
+{
+  std::uint64_t key = 0; // hash of everything that determines the search
+  std::vector<ThreadCheckpoint> threads;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    (void) version;
+    ar& key;
+    ar& threads;
+  }
+};
+
+// Checkpoints are binary archives. They are written to a temporary file and
+// renamed into place, so an interrupted write leaves the previous checkpoint
+// intact.
+bool ReadCheckpoint(const std::string& path, MapperCheckpoint& checkpoint);
+bool WriteCheckpoint(const std::string& path, const MapperCheckpoint& checkpoint);
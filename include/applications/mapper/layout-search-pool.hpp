@@ -0,0 +1,185 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "model/engine.hpp"
+#include "model/sparse-optimization-info.hpp"
+#include "layout/layout.hpp"
+#include "layoutspaces/layout-search.hpp"
+#include "crypto/crypto.hpp"
+
+//--------------------------------------------//
+//             Layout Search Pool             //
+//--------------------------------------------//
+
+// Shares the evaluation of layout candidates among all mapper threads.
+// Every mapper thread is a worker with its own task deque. A worker pushes
+// the candidates of its current mapping onto its deque and works through
+// them from the front, while workers that are waiting for their own
+// candidates or have exhausted their mapspace split steal from the back of
+// other deques. Candidates travel as LayoutIDs: the owner of a mapping
+// builds them in its own layout space, and a worker that steals one builds
+// it in a private layout space initialized from the owner's read-only
+// concordant layout. Each candidate records its own outcome, so the
+// submitting thread can reduce the results in submission order regardless
+// of which worker evaluated them.
+class LayoutSearchPool
+{
+ public:
+  // Everything a worker needs to build and evaluate layouts for one mapping.
+  struct MappingContext
+  {
+    std::uint64_t id = 0;
+    const Mapping* mapping = nullptr;
+    problem::Workload* workload = nullptr;
+    sparse::SparseOptimizationInfo* sparse_optimizations = nullptr;
+    crypto::CryptoConfig* crypto = nullptr;
+    bool break_on_failure = true;
+
+    // Set by AttachLayoutSpace(). The owner's layout space is only used by
+    // the owner; other workers only read its concordant layout, which does
+    // not change while candidates of this context are outstanding.
+    unsigned owner = 0;
+    layoutspace::Legal* owner_layoutspace = nullptr;
+    const model::Engine::Specs* arch_specs = nullptr;
+    const std::vector<layoutspace::IntralineConstraint>* intraline_constraints = nullptr;
+    bool skip_authblock = true;
+  };
+
+  struct Candidate
+  {
+    // Also tells whether to evaluate with all authblock factors cleared.
+    layoutspace::LayoutID id;
+    // False if the layout failed construction or evaluation, or the
+    // evaluation was cut off.
+    bool success = false;
+    std::uint64_t cycles = 0;
+    double energy_per_compute = 0.0;
+    std::uint64_t actual_computes = 0;
+  };
+
+ private:
+  struct Job
+  {
+    const MappingContext* context;
+    std::vector<Candidate>* candidates;
+    std::atomic<std::size_t> remaining;
+  };
+
+  struct Task
+  {
+    Job* job;
+    std::size_t index;
+  };
+
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    model::Engine* engine = nullptr;
+    // The engine's mapping-dependent state belongs to this context, and
+    // points into this private copy of its mapping.
+    std::uint64_t context_id = 0;
+    Mapping mapping;
+    // Private layout space for candidates of other workers' mappings, bound
+    // to the mapping of layoutspace_context_id.
+    layout::Layouts layout;
+    std::unique_ptr<layoutspace::Legal> layoutspace;
+    std::uint64_t layoutspace_context_id = 0;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<std::uint64_t> next_context_id_;
+  std::atomic<unsigned> retired_workers_;
+  // Tasks sitting in any deque. Idle workers sleep until there is one to
+  // steal or what they wait for has happened.
+  std::atomic<std::size_t> queued_tasks_;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cv_;
+
+  void NotifyIdle();
+  layoutspace::Legal& LayoutSpace(unsigned worker_id, const MappingContext& context);
+  bool PopTask(unsigned worker_id, Task& task);
+  bool StealTask(unsigned worker_id, Task& task);
+  void Execute(unsigned worker_id, const Task& task);
+
+ public:
+  LayoutSearchPool(unsigned num_workers);
+
+  LayoutSearchPool(const LayoutSearchPool&) = delete;
+  LayoutSearchPool& operator=(const LayoutSearchPool&) = delete;
+
+  unsigned NumWorkers() const;
+
+  // Registers the engine a worker evaluates on. It must be Spec'ed with the
+  // same architecture as every other worker's engine.
+  void Attach(unsigned worker_id, model::Engine* engine);
+
+  MappingContext NewMappingContext(const Mapping& mapping, problem::Workload& workload,
+                                   sparse::SparseOptimizationInfo* sparse_optimizations,
+                                   crypto::CryptoConfig* crypto, bool break_on_failure);
+
+  // Lets the pool build the context's candidates. The layout space must be
+  // Init()'ed for the context's mapping and stay untouched by anyone but its
+  // owner until the context's candidates are evaluated.
+  static void AttachLayoutSpace(MappingContext& context, unsigned owner,
+                                layoutspace::Legal& layoutspace,
+                                const model::Engine::Specs& arch_specs,
+                                const std::vector<layoutspace::IntralineConstraint>& intraline_constraints,
+                                bool skip_authblock);
+
+  // Evaluates a single layout on the worker's own engine. Only the
+  // layout-dependent part of the model is re-run if the engine still holds
+  // this mapping.
+  std::vector<model::EvalStatus> Evaluate(unsigned worker_id, const MappingContext& context,
+                                          const layout::Layouts& layout);
+
+  // Evaluates every candidate and returns once all of them are done. The
+  // calling worker takes part in the work and may also pick up other
+  // workers' candidates meanwhile.
+  void EvaluateCandidates(unsigned worker_id, const MappingContext& context,
+                          std::vector<Candidate>& candidates);
+
+  // Reports evaluated candidates to the search in issue order. Failed and
+  // cut-off candidates are reported as invalid, and only successful ones
+  // provide the compute count if it is not known yet. Returns the index of
+  // the candidate the search last took as its new best, or -1.
+  static int ReportCandidates(layoutspace::LayoutSearchAlgorithm& search,
+                              const std::vector<Candidate>& candidates,
+                              std::uint64_t& actual_computes);
+
+  // Called by a worker that has no more mappings of its own. Keeps stealing
+  // candidates from other workers until every worker has retired.
+  void Retire(unsigned worker_id);
+};
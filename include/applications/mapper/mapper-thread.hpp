@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <random>
@@ -37,6 +39,9 @@
 #include "layout/layout.hpp"
 #include "crypto/crypto.hpp"
 #include "layoutspaces/layoutspace.hpp"
+#include "layoutspaces/layout-search.hpp"
+#include "applications/mapper/layout-search-pool.hpp"
+#include "applications/mapper/checkpoint.hpp"
 
 
 struct EvaluationResult
@@ -50,6 +55,43 @@ struct EvaluationResult
   bool UpdateIfEqual(const EvaluationResult& other, const std::vector<std::string>& metrics);
 };
 
+//--------------------------------------------//
+//              Global Incumbent              //
+//--------------------------------------------//
+
+// Best result across all mapper threads, readable without locking. The cost
+// of the incumbent under the primary optimization metric is an atomic scalar
+// for cheap comparisons, and the full result is an immutable snapshot that is
+// swapped in (bumping the epoch) on every improvement, so a result is only
+// copied when it actually wins and readers only copy it when the epoch moved.
+class Incumbent
+{
+ private:
+  std::vector<std::string> metrics_;
+  // Primary-metric cost of the published result. It may briefly lag behind
+  // (be worse than) the snapshot, never lead it.
+  std::atomic<double> cost_;
+  std::atomic<std::uint64_t> epoch_;
+  std::shared_ptr<const EvaluationResult> result_; // std::atomic_load/_store only
+
+ public:
+  Incumbent(const std::vector<std::string>& metrics);
+
+  // Publish the result if it is better than the incumbent.
+  bool Offer(const EvaluationResult& result);
+
+  // Latest published result, null before the first one.
+  std::shared_ptr<const EvaluationResult> Get() const;
+
+  // Number of results published so far.
+  std::uint64_t Epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+  // True if every result whose cycles and energy are at least those of
+  // lower_bound loses to the incumbent. Only metrics that grow with cycles
+  // and energy (delay, energy, edp) can be decided this way.
+  bool Dominates(const model::Topology::Stats& lower_bound) const;
+};
+
 //--------------------------------------------//
 //              Failure Tracking              //
 //--------------------------------------------//
@@ -95,8 +137,8 @@ class MapperThread
   unsigned thread_id_;
   search::SearchAlgorithm* search_;
   mapspace::MapSpace* mapspace_;
-  layoutspace::Legal* layoutspace_;
   std::mutex* mutex_;
+  LayoutSearchPool* layout_search_pool_;
   uint128_t search_size_;
   std::uint32_t timeout_;
   std::uint32_t victory_condition_;
@@ -120,13 +162,29 @@ class MapperThread
   problem::Workload &workload_;
   layout::Layouts layout_;
   bool layout_initialized_;
+  layoutspace::LayoutSearchAlgorithm* layout_search_;
+  std::vector<layoutspace::IntralineConstraint> layout_constraints_;
   sparse::SparseOptimizationInfo* sparse_optimizations_;
   crypto::CryptoConfig* crypto_;
-  EvaluationResult* best_;
+  Incumbent* incumbent_;
 
   // Thread-local data (stats etc.).
   std::thread thread_;
   Stats stats_;
+  EvaluationResult own_best_; // best mapping found by this thread itself
+
+  // Checkpointing. The latest published state is guarded by
+  // checkpoint_mutex_; checkpoint_epoch_ is the request it answered.
+  const std::atomic<std::uint64_t>* checkpoint_request_;
+  std::atomic<std::uint64_t> checkpoint_epoch_;
+  std::atomic<bool> finished_;
+  std::mutex checkpoint_mutex_;
+  ThreadCheckpoint checkpoint_;
+  const ThreadCheckpoint* resume_from_;
+
+  bool RebuildMapping(uint128_t id, Mapping& mapping, bool break_on_failure);
+  void PublishCheckpoint(ThreadCheckpoint& checkpoint, std::uint64_t epoch, bool final);
+  void Resume(const ThreadCheckpoint& checkpoint, model::Engine& engine);
 
  public:
   MapperThread(
@@ -134,6 +192,7 @@ class MapperThread
     search::SearchAlgorithm* search,
     mapspace::MapSpace* mapspace,
     std::mutex* mutex,
+    LayoutSearchPool* layout_search_pool,
     uint128_t search_size,
     std::uint32_t timeout,
     std::uint32_t victory_condition,
@@ -157,9 +216,11 @@ class MapperThread
     problem::Workload &workload,
     layout::Layouts layout,
     bool layout_initialized,
+    layoutspace::LayoutSearchAlgorithm* layout_search,
+    const std::vector<layoutspace::IntralineConstraint>& layout_constraints,
     sparse::SparseOptimizationInfo* sparse_optimizations,
     crypto::CryptoConfig* crypto,
-    EvaluationResult* best
+    Incumbent* incumbent
   );
 
   void Start();
@@ -168,6 +229,16 @@ class MapperThread
 
   const Stats& GetStats() const;
 
+  // Publish the search state at the first mapping boundary after *request
+  // moves past the last published epoch, and once more on termination.
+  void EnableCheckpoints(const std::atomic<std::uint64_t>* request);
+  std::uint64_t CheckpointEpoch() const { return checkpoint_epoch_.load(std::memory_order_acquire); }
+  bool IsFinished() const { return finished_.load(std::memory_order_acquire); }
+  ThreadCheckpoint GetCheckpoint();
+
+  // Continue the search from a checkpoint of this thread (must outlive Run()).
+  void ResumeFrom(const ThreadCheckpoint* checkpoint);
+
   void Run();
 
 };
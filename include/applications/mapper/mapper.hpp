@@ -36,9 +36,11 @@
 
 #include "mapspaces/mapspace-factory.hpp"
 #include "layoutspaces/layoutspace.hpp"
+#include "layoutspaces/layout-search.hpp"
 #include "search/search-factory.hpp"
 #include "compound-config/compound-config.hpp"
 #include "applications/mapper/mapper-thread.hpp"
+#include "applications/mapper/result-cache.hpp"
 #include "model/sparse-optimization-parser.hpp"
 #include "layout/layout.hpp"
 #include "crypto/crypto.hpp"
@@ -84,6 +86,9 @@ class Mapper
   std::vector<mapspace::MapSpace*> split_mapspaces_;
   layoutspace::Legal* layoutspace_;
   std::vector<search::SearchAlgorithm*> search_;
+  search::WorkPool* work_pool_; // index factorizations shared between threads, if any
+  std::vector<layoutspace::LayoutSearchAlgorithm*> layout_search_;
+  std::vector<layoutspace::IntralineConstraint> layout_constraints_;
   sparse::SparseOptimizationInfo* sparse_optimizations_;
 
   uint128_t search_size_;
@@ -110,9 +115,20 @@ class Mapper
 
   char* cfg_string_;
 
-  EvaluationResult best_;
   EvaluationResult global_best_;
 
+  ResultCache* result_cache_;
+  std::string cache_key_; // everything but the layout constraints
+
+  std::string CacheKey() const;
+  bool RestoreCachedRun(const std::string& value, Mapper::Result& result);
+  void StoreCachedRun(const Mapper::Result& result);
+
+  std::uint32_t checkpoint_interval_; // seconds, 0 disables checkpoints
+  bool resume_ = false;
+
+  void SaveCheckpoint(const std::vector<MapperThread*>& threads);
+
  private:
 
   // Serialization
@@ -126,6 +142,14 @@ class Mapper
          std::string output_dir = ".",
          std::string name = "timeloop-mapper");
 
+  // Map one problem of a larger config (e.g. a layer of a network) against an
+  // architecture that has already been parsed. A null arch_specs parses it here.
+  Mapper(config::CompoundConfig* config,
+         config::CompoundConfigNode problem,
+         const model::Engine::Specs* arch_specs,
+         std::string output_dir = ".",
+         std::string name = "timeloop-mapper");
+
   // This class does not support being copied
   Mapper(const Mapper&) = delete;
   Mapper& operator=(const Mapper&) = delete;
@@ -134,6 +158,23 @@ class Mapper
 
   EvaluationResult GetGlobalBest();
 
+  // Layouts the search starts from (parsed or concordant dummy).
+  const layout::Layouts& GetLayouts() const;
+
+  // Pin intraline factors of the layouts searched by Run().
+  void SetIntralineConstraints(const std::vector<layoutspace::IntralineConstraint>& constraints);
+
+  // Continue the search from the checkpoint of an earlier run with the same
+  // configuration (<out_prefix>.checkpoint), if there is one.
+  void SetResume(bool resume);
+
+  static config::CompoundConfigNode ArchitectureNode(config::CompoundConfig* config);
+
+  // Parse the architecture and apply the ERT/ART (invoking Accelergy if needed).
+  static model::Engine::Specs ParseArchitecture(config::CompoundConfig* config,
+                                                std::string output_dir,
+                                                std::string semi_qualified_prefix);
+
   Mapper::Result Run();
 };
 
@@ -0,0 +1,100 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "applications/mapper/mapper.hpp"
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+namespace application
+{
+
+// Maps all layers of a network in one process. The architecture (and its
+// ERT/ART) is parsed once and shared by every layer, and each consumer layer's
+// input layout at the coupled storage level is pinned to the intraline factors
+// its producer's best layout wrote the data in.
+class NetworkMapper
+{
+ public:
+  struct LayerResult
+  {
+    std::string name;
+    std::string problem_file;
+    bool valid = false;
+    std::uint64_t cycles = 0;
+    double energy = 0;
+    Mapper::Result result;
+  };
+
+  struct Result
+  {
+    std::vector<LayerResult> layers;
+    std::string summary_string;
+  };
+
+ protected:
+  config::CompoundConfig* config_;
+  std::string output_dir_;
+  std::string semi_qualified_prefix_;
+
+  model::Engine::Specs arch_specs_;
+
+  std::vector<std::string> layer_files_;
+  std::vector<config::CompoundConfig*> layer_configs_;
+  std::vector<std::vector<unsigned>> producers_; // per layer, indices of its producers
+
+  std::string producer_data_space_;
+  std::string consumer_data_space_;
+  std::string coupled_level_;
+
+  bool resume_ = false;
+
+  std::vector<layoutspace::IntralineConstraint> CoupleToProducer(
+    const layout::Layouts& producer_layout,
+    const layout::Layouts& consumer_layout) const;
+
+ public:
+  NetworkMapper(config::CompoundConfig* config,
+                std::string output_dir = ".",
+                std::string name = "timeloop-mapper");
+
+  // This class does not support being copied
+  NetworkMapper(const NetworkMapper&) = delete;
+  NetworkMapper& operator=(const NetworkMapper&) = delete;
+
+  ~NetworkMapper();
+
+  // Resume every layer from its own checkpoint (see Mapper::SetResume()).
+  void SetResume(bool resume);
+
+  Result Run();
+};
+
+} // namespace application
@@ -0,0 +1,65 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "compound-config/compound-config.hpp"
+
+//--------------------------------------------//
+//                Result Cache                //
+//--------------------------------------------//
+
+// Content-addressed on-disk store of mapper results. Each entry lives in its
+// own file in the cache directory, named by a stable hash of its key text; the
+// key text is stored with the value, so a hash collision reads as a miss.
+// Entries are written to a temporary file and renamed into place, so several
+// processes can share one cache directory.
+class ResultCache
+{
+ private:
+  std::string directory_;
+
+  std::string EntryPath(const std::string& key) const;
+
+ public:
+  ResultCache(std::string directory);
+
+  bool Lookup(const std::string& key, std::string& value) const;
+  void Store(const std::string& key, const std::string& value) const;
+
+  // Stable 64-bit FNV-1a hash.
+  static std::uint64_t Hash(const std::string& text);
+
+  // Text of a YAML tree with map keys sorted, so configs that differ only in
+  // key order or formatting produce the same text. Map keys in skip_keys are
+  // left out at the top level.
+  static std::string CanonicalText(const YAML::Node& node,
+                                   const std::set<std::string>& skip_keys = {});
+};
@@ -58,8 +58,13 @@ class Model
 
   struct Stats
   {
-    double energy;
-    double cycles;
+    bool success = true;
+    std::string fail_reason;
+
+    double energy = 0;
+    double cycles = 0;
+    double utilization = 0;
+    double area = 0;
 
     std::string stats_string;
     std::string map_string;
@@ -77,30 +82,48 @@ class Model
   // been parsed.
 
   // The crypto engine 
-  crypto::CryptoConfig* crypto_; 
+  crypto::CryptoConfig* crypto_ = nullptr; 
 
   // The layout modeling
   layout::Layouts layout_; 
   bool layout_initialized_ = false;
   
   // The mapping.
-  Mapping* mapping_;
+  Mapping* mapping_ = nullptr;
 
   // Abstract representation of the architecture.
-  ArchProperties* arch_props_;
+  ArchProperties* arch_props_ = nullptr;
 
   // Constraints.
-  mapping::Constraints* constraints_;  
+  mapping::Constraints* constraints_ = nullptr;  
+  config::CompoundConfigNode arch_constraints_;
   
   // Application flags/config.
   bool verbose_ = false;
   bool auto_bypass_on_failure_ = false;
   std::string out_prefix_;
 
+  // Server mode: the architecture is parsed once, and evaluation failures
+  // are reported to the client instead of terminating the process.
+  bool serve_ = false;
+
   // Sparse optimization
-  sparse::SparseOptimizationInfo* sparse_optimizations_;
+  sparse::SparseOptimizationInfo* sparse_optimizations_ = nullptr;
+  bool is_sparse_topology_ = false;
+  config::CompoundConfigNode sparse_optimizations_config_;
+
+  // The architecture specs refer to the problem shape's data spaces, so
+  // every workload evaluated against them must use the same shape.
+  std::vector<std::string> shape_signature_;
 
  private:
+  std::vector<std::string> ShapeSignature() const;
+
+  // Parses everything that is specific to one evaluation: the problem (if
+  // present and parse_problem is set), sparse optimizations, constraints,
+  // mapping, crypto and layout. Returns an error message, or an empty
+  // string on success.
+  std::string ParseEvaluation(config::CompoundConfigNode rootNode, bool parse_problem);
 
   // Serialization
   friend class boost::serialization::access;
@@ -109,9 +132,13 @@ class Model
 
  public:
 
+  // In server mode, config supplies the architecture (plus ERT/ART and
+  // constraints) and a template problem whose shape all requests share;
+  // mappings are supplied later through Serve().
   Model(config::CompoundConfig* config,
         std::string output_dir = ".",
-        std::string name = "timeloop-model");
+        std::string name = "timeloop-model",
+        bool serve = false);
 
   // This class does not support being copied
   Model(const Model&) = delete;
@@ -119,8 +146,14 @@ class Model
 
   ~Model();
 
-  // Run the evaluation.
-  Stats Run();
+  // Run the evaluation. Without detailed output, only the scalar stats
+  // are filled in.
+  Stats Run(bool detailed_output = true);
+
+  // Server mode: evaluate a stream of requests, one per line of `in`, each
+  // a whitespace-separated list of YAML files (problem, mapping, layout,
+  // knobs, ...). Each request is answered with one line of JSON on `out`.
+  void Serve(std::istream& in, std::ostream& out);
 };
 
 
@@ -3,6 +3,33 @@
 #include <mutex>
 #include <isl/cpp.h>
 
+/**
+ * @brief The ISL context of the calling thread.
+ *
+ * Every thread gets its own context on first use, freed when the thread
+ * exits, so ISL-based analyses on different threads never share state. ISL
+ * objects must only be combined with objects of the same context; use
+ * TransferToIslCtx() to move an object built on another thread.
+ */
 isl::ctx& GetIslCtx();
 
-std::mutex& GetIslMutex();
+/**
+ * @brief Copy an ISL object into the calling thread's context.
+ *
+ * The object is printed and re-read, so the source is only read (by the
+ * calling thread) and stays valid in its own context.
+ */
+isl::set TransferToIslCtx(const isl::set& set);
+isl::map TransferToIslCtx(const isl::map& map);
+isl::multi_aff TransferToIslCtx(const isl::multi_aff& maff);
+
+/**
+ * @brief Serialize barvinok counting (isl_set_card, isl_map_card,
+ *   isl_pw_qpolynomial_sum) across threads.
+ *
+ * Barvinok and the libraries below it (PolyLib, NTL) keep global state, so
+ * counting is serialized by default even though ISL contexts are per thread.
+ * Builds whose counting stack is thread-safe can set
+ * TIMELOOP_PARALLEL_BARVINOK=1, in which case the returned lock is empty.
+ */
+std::unique_lock<std::mutex> LockBarvinok();
@@ -77,7 +77,11 @@ insert_equal_dims(
 
 map insert_dummy_dim_ins(map map, size_t pos, size_t n);
 
+// Barvinok counting; serialized across threads (see LockBarvinok()).
 isl_pw_qpolynomial* set_card(set set);
+__isl_give isl_pw_qpolynomial* set_card(__isl_take isl_set* p_set);
+__isl_give isl_pw_qpolynomial* map_card(__isl_take isl_map* p_map);
+__isl_give isl_pw_qpolynomial* pw_qpolynomial_sum(__isl_take isl_pw_qpolynomial* p_pwqp);
 
 isl_pw_qpolynomial* sum_map_range_card(map map);
 
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -27,6 +28,38 @@ struct LayoutNest {
   std::map<std::string, std::uint32_t> factors;  // Factor for each rank (if specified)
 };
 
+//------------------------------------------------------------------------------
+// RankTable: interned, dense form of the per-rank workload information.
+// Rank names are mapped once (at parse time) to consecutive IDs following the
+// order of rankToFactorizedDimensionID, and every per-rank attribute is kept in
+// a flat vector indexed by that ID. The table only depends on the workload, so
+// all Layouts of a run share one immutable instance.
+//------------------------------------------------------------------------------
+struct RankTable {
+  std::vector<std::string> names;                       // rank ID -> rank name
+  std::map<std::string, unsigned> ids;                  // rank name -> rank ID
+  std::vector<std::vector<std::uint32_t>> dims;         // rank ID -> factorized dimension IDs
+  std::vector<std::vector<std::uint32_t>> coefficients; // rank ID -> coefficient values
+  std::vector<std::uint32_t> zero_padding;              // rank ID -> zero padding (0 if none)
+
+  // Ranks that share a factorized dimension (directly or transitively), and
+  // the dimensions each such group spans.
+  std::vector<std::vector<unsigned>> rank_groups;
+  std::vector<std::vector<std::uint32_t>> dim_groups;
+
+  unsigned NumRanks() const { return names.size(); }
+  unsigned ID(const std::string& rank) const { return ids.at(rank); }
+  std::vector<unsigned> IDs(const std::vector<std::string>& ranks) const;
+
+  // Fills a flat factor array of a nest, indexed by rank ID (1 for unset
+  // ranks). The array is reused, so callers can keep one across nests.
+  void Factors(const LayoutNest& nest, std::vector<std::uint32_t>& factors) const;
+
+  // Same ranks with the same attributes, i.e. interchangeable tables.
+  bool operator==(const RankTable& other) const;
+  bool operator!=(const RankTable& other) const { return !(*this == other); }
+};
+
 struct Layout {
   std::string target;                        // e.g., "MainMemory"
   std::vector<LayoutNest> interline;         // One nest per data space for interline type
@@ -54,6 +87,8 @@ struct Layout {
   bool assume_warmup;                        // consider the added warmup latency for the first tile
 
   bool initialize = false;                   // True if external YAML provided layout for this target
+
+  std::shared_ptr<const RankTable> rank_table; // Dense rank-ID view, shared by all layouts of a workload
 };
 
 
@@ -89,6 +124,14 @@ struct LayoutConstraint {
 
 typedef std::vector<Layout> Layouts;
 
+//------------------------------------------------------------------------------
+// BuildRankTable()
+// Interns the ranks of a layout into a RankTable. GetRankTable() returns the
+// table attached to the layout, building one only if none is attached.
+//------------------------------------------------------------------------------
+std::shared_ptr<const RankTable> BuildRankTable(const Layout& layout);
+std::shared_ptr<const RankTable> GetRankTable(const Layout& layout);
+
 //------------------------------------------------------------------------------
 // Helper: parseOrderMapping()
 // Parses a mapping string (e.g., "C:0, M:1, R:2, S:3, N:4, P:5, Q:6")
@@ -0,0 +1,113 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <optional>
+#include <random>
+
+#include "layoutspaces/layout-search.hpp"
+
+namespace layoutspace
+{
+
+// Heuristic best-first search over the joint layout space. Every (splitting,
+// packing) pair that is visited is first evaluated without auth, and that
+// evaluation is used as an estimate for all of its auth choices. The visited
+// pairs include all the pairs that coordinate descent visits, plus sampled
+// pairs at other splittings. Pairs are then expanded into the AuthSpace in
+// order of their estimates, and expansion stops at the first pair whose
+// estimate does not beat the best full layout found so far.
+//
+// The estimate is not a lower bound: a larger auth factor spreads the
+// per-block auth cycles and energy over more data, so some auth choices are
+// cheaper than the auth-free evaluation. The pruning may therefore miss the
+// best layout; it trades that for evaluating far fewer joint candidates.
+// It is therefore only used when requested with
+// layout_search_algorithm: best_first; coordinate descent stays the default.
+class BestFirstLayoutSearch : public LayoutSearchAlgorithm
+{
+ private:
+  enum class Stage
+  {
+    Splitting, // (s, 0) for every splitting ID
+    Packing,   // sampled (s*, p > 0) at the best splitting s*
+    Joint,     // sampled (s, p > 0) pairs at all other splittings
+    Auth,      // auth expansion of the estimated pairs
+    Done
+  };
+
+  struct Node
+  {
+    std::uint64_t splitting;
+    std::uint64_t packing;
+    std::uint64_t cycles;
+    double energy_per_compute;
+  };
+
+  // Config.
+  SamplingConfig sampling_;
+  std::uint32_t victory_condition_;
+  std::mt19937_64 generator_;
+
+  // Live state.
+  const Legal* layoutspace_;
+  bool search_auth_;
+  Stage stage_;
+  std::size_t outstanding_;
+  std::uint64_t next_splitting_id_;
+  std::optional<Sampler> sampler_;
+  bool stop_sampling_;
+  std::uint64_t visited_candidate_counter_;
+  std::uint32_t less_improvement_counter_;
+
+  std::vector<Node> nodes_;
+  std::size_t current_node_;
+
+  // Best estimate (evaluated without auth) and best full layout.
+  bool has_estimate_;
+  std::uint64_t estimate_cycles_;
+  double estimate_energy_per_compute_;
+  std::uint64_t estimate_splitting_id_;
+  bool has_best_;
+  std::uint64_t best_cycles_;
+  double best_energy_per_compute_;
+
+  void StartStage(Stage stage);
+  bool ExpandNextNode();
+
+ public:
+  BestFirstLayoutSearch(const SamplingConfig& sampling, std::uint32_t victory_condition);
+
+  void Init(const Legal& layoutspace, bool search_auth);
+
+  bool Next(LayoutID& layout_id);
+
+  bool Report(const LayoutID& layout_id, bool valid, std::uint64_t cycles, double energy_per_compute);
+};
+
+} // namespace layoutspace
@@ -0,0 +1,86 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <optional>
+#include <random>
+
+#include "layoutspaces/layout-search.hpp"
+
+namespace layoutspace
+{
+
+// Greedy coordinate descent: all SplittingSpace IDs (without auth), then
+// sampled PackingSpace IDs at the best splitting (without auth), then sampled
+// AuthSpace IDs at the best splitting and packing.
+class CoordinateDescentLayoutSearch : public LayoutSearchAlgorithm
+{
+ private:
+  enum class Phase
+  {
+    Splitting,
+    Packing,
+    Auth,
+    Done
+  };
+
+  // Config.
+  SamplingConfig sampling_;
+  std::uint32_t victory_condition_;
+  std::mt19937_64 generator_;
+
+  // Live state.
+  const Legal* layoutspace_;
+  bool search_auth_;
+  Phase phase_;
+  std::size_t outstanding_;
+  std::uint64_t next_splitting_id_;
+  std::optional<Sampler> sampler_;
+  bool stop_phase_;
+  std::uint64_t visited_candidate_counter_;
+  std::uint32_t less_improvement_counter_;
+
+  bool has_best_;
+  std::uint64_t best_cycles_;
+  double best_energy_per_compute_;
+  std::uint64_t best_splitting_id_;
+  std::uint64_t best_packing_id_;
+
+  void StartPhase(Phase phase);
+
+ public:
+  CoordinateDescentLayoutSearch(const SamplingConfig& sampling, std::uint32_t victory_condition);
+
+  void Init(const Legal& layoutspace, bool search_auth);
+
+  bool Next(LayoutID& layout_id);
+
+  bool Report(const LayoutID& layout_id, bool valid, std::uint64_t cycles, double energy_per_compute);
+};
+
+} // namespace layoutspace
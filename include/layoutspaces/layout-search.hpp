@@ -0,0 +1,108 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "layoutspaces/layoutspace.hpp"
+#include "compound-config/compound-config.hpp"
+
+namespace layoutspace
+{
+
+//--------------------------------------------//
+//           Layout Search Algorithm          //
+//--------------------------------------------//
+
+// A point in the joint SplittingSpace x PackingSpace x AuthSpace of a mapping.
+struct LayoutID
+{
+  std::uint64_t splitting = 0;
+  std::uint64_t packing = 0;
+  std::uint64_t auth = 0;
+  // Evaluate with all authblock factors cleared. Such an evaluation only
+  // estimates the auth choices for the same splitting and packing; it is not
+  // a lower bound on them.
+  bool without_auth = false;
+};
+
+// Early-stop limits of the sampled phases: number of consecutive candidates
+// without improvement (also capped by the victory condition), and number of
+// marginal energy-only improvements tolerated in the AuthSpace.
+const std::uint32_t kPackingPatienceCap = 50;
+const std::uint32_t kAuthPatienceCap = 100;
+const std::uint32_t kLessImprovementThreshold = 10;
+
+// Lexicographic (cycles, energy per compute) comparison used by all layout
+// searches.
+inline bool IsBetterLayout(std::uint64_t cycles, double energy_per_compute,
+                           std::uint64_t best_cycles, double best_energy_per_compute)
+{
+  return cycles < best_cycles ||
+    (cycles == best_cycles && energy_per_compute < best_energy_per_compute);
+}
+
+// Returns true if the best result found so far by any mapper thread beats
+// the given cycles and energy per compute. Searches only apply it to
+// estimates, which are not lower bounds, so pruning with it is a heuristic.
+typedef std::function<bool(std::uint64_t cycles, double energy_per_compute)> LayoutCutoff;
+
+// Drives the layout co-search of one mapping. Next() may be called several
+// times before the matching Report() calls, which arrive in issue order.
+// Next() returns false when it cannot propose anything until the outstanding
+// candidates are reported; with nothing outstanding, false ends the search.
+class LayoutSearchAlgorithm
+{
+ public:
+  LayoutSearchAlgorithm() {}
+  virtual ~LayoutSearchAlgorithm() {}
+  virtual void Init(const Legal& layoutspace, bool search_auth) = 0;
+  virtual bool Next(LayoutID& layout_id) = 0;
+  // Returns true if the candidate is the new best layout for this mapping.
+  // Candidates that failed construction or evaluation are reported with
+  // valid = false; they must never become the best layout.
+  virtual bool Report(const LayoutID& layout_id, bool valid, std::uint64_t cycles, double energy_per_compute) = 0;
+
+  // Optional and off by default. Searches that evaluate auth-free estimates
+  // stop expanding the ones the cutoff rejects, which may skip layouts that
+  // would have beaten the incumbent.
+  void SetCutoff(LayoutCutoff cutoff) { cutoff_ = cutoff; }
+
+ protected:
+  LayoutCutoff cutoff_;
+};
+
+//--------------------------------------------//
+//             Parser and Factory             //
+//--------------------------------------------//
+
+LayoutSearchAlgorithm* ParseAndConstructSearch(config::CompoundConfigNode config,
+                                               std::uint32_t victory_condition);
+
+} // namespace layoutspace
@@ -27,6 +27,9 @@
 
 #pragma once
 
+#include <random>
+#include <unordered_map>
+
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "util/numeric.hpp"
@@ -48,6 +51,57 @@ struct Status
   std::string fail_reason;
 };
 
+// Intraline factors a layout must use for some ranks of one dataspace at one
+// storage level, e.g. a consumer layer's input ranks pinned to the layout its
+// producer wrote them in.
+struct IntralineConstraint
+{
+  std::string target;     // storage level name
+  std::string data_space; // dataspace name
+  std::map<std::string, std::uint32_t> factors; // rank -> intraline factor
+};
+
+//--------------------------------------------//
+//                  Sampling                  //
+//--------------------------------------------//
+
+// Mapper-level knobs for visiting the PackingSpace and AuthSpace.
+struct SamplingConfig
+{
+  // Spaces with at most this many candidates are enumerated in full.
+  std::uint32_t exhaustive_threshold = 64;
+  // Maximum number of candidates drawn per phase (0 = whole space).
+  std::uint32_t packing_budget = 0;
+  std::uint32_t authblock_budget = 0;
+};
+
+// Produces distinct candidate IDs from [0, size). Small spaces are walked in
+// order; larger ones in the order of a uniformly random permutation, drawn
+// lazily by a Fisher-Yates shuffle that only stores the positions it has
+// swapped, so no ID is drawn twice and memory grows with the number drawn
+// rather than with the space. Stops after the budget is spent.
+class Sampler
+{
+ private:
+  std::uint64_t size_;
+  std::uint64_t budget_;
+  std::uint64_t drawn_;
+  bool exhaustive_;
+  std::mt19937_64 generator_;
+  // Shuffled positions whose ID differs from the position itself.
+  std::unordered_map<std::uint64_t, std::uint64_t> swapped_;
+
+  std::uint64_t At(std::uint64_t position) const;
+
+ public:
+  Sampler(std::uint64_t size, std::uint64_t budget, std::uint64_t exhaustive_threshold, std::mt19937_64& generator);
+
+  // True if every ID of the space will be visited.
+  bool Exhaustive() const { return exhaustive_; }
+
+  bool Next(std::uint64_t& id);
+};
+
 //--------------------------------------------//
 //                    Legal                   //
 //--------------------------------------------//
@@ -127,9 +181,25 @@ class Legal
 
   protected:
     model::Engine::Specs arch_specs_;
-    const Mapping& mapping_;
+    const Mapping* mapping_;
     layout::Layouts& layout_;
-    
+
+    // Capacities only depend on the architecture and are parsed by the first Init().
+    bool arch_parsed_ = false;
+
+    // Set by Init() and cleared by Unbind(). While bound, the mapping passed
+    // to ConstructLayout() must be the one given to Init().
+    bool bound_ = false;
+
+    // Concordant layout of the mapping bound by Init(). ConstructLayout() patches
+    // layout_ back to it, restoring only the nests the previous construction touched.
+    layout::Layouts concordant_layout_;
+    std::vector<std::pair<unsigned, unsigned>> dirty_nests_; // (level, dataspace)
+    void RestoreConcordantLayout();
+
+    std::vector<IntralineConstraint> intraline_constraints_;
+    Status ApplyIntralineConstraints();
+
   public:
     std::uint64_t num_layout_candidates;
     std::vector<std::map<std::uint32_t, std::uint32_t>> storage_level_overall_dimval;
@@ -198,27 +268,64 @@ class Legal
           const Mapping& mapping,
           layout::Layouts& layout) :
           arch_specs_(arch_specs),
-          mapping_(mapping),
+          mapping_(&mapping),
+          layout_(layout){};
+
+    // Unbound Legal, reused across mappings: every Init() rebuilds the
+    // mapping-dependent tables while keeping their storage.
+    Legal(model::Engine::Specs arch_specs,
+          layout::Layouts& layout) :
+          arch_specs_(arch_specs),
+          mapping_(nullptr),
           layout_(layout){};
 
     Legal(const Legal& other) = default;
-    ~Legal();
+    ~Legal() = default;
+
 
+    const layout::Layouts& GetLayout() const
+    {
+      return layout_;
+    }
 
-    layout::Layouts GetLayout()
+    // The layout ConstructLayout() builds into. Callers may modify it
+    // temporarily, but must restore it before the next construction.
+    layout::Layouts& GetLayout()
     {
       return layout_;
     }
 
+    const layout::Layouts& GetConcordantLayout() const
+    {
+      return concordant_layout_;
+    }
+
     //------------------------------------------//
     //        Initialization and Setup          //
     //------------------------------------------//
 
     void Init(model::Engine::Specs arch_specs, const Mapping& mapping, layout::Layouts& layout, bool skip_authblock = false);
+
+    // Forgets the mapping bound by Init(), e.g. before it goes out of scope.
+    // ConstructLayout() then derives the concordant layout from its argument.
+    void Unbind()
+    {
+      bound_ = false;
+      mapping_ = nullptr;
+    }
+
+    // Constraints applied by every ConstructLayout() after the splitting and
+    // packing choices; candidates that cannot meet them fail construction.
+    void SetIntralineConstraints(const std::vector<IntralineConstraint>& constraints)
+    {
+      intraline_constraints_ = constraints;
+    }
     void ParseArchSpecs(model::Engine::Specs arch_specs, const Mapping& mapping);
 
     // Construct a specific layout using separate IDs for all three design spaces.
-    std::vector<Status> ConstructLayout(uint64_t layout_splitting_id, uint64_t layout_packing_id, uint64_t layout_auth_id, layout::Layouts* layouts, Mapping mapping, bool skip_authblock, bool break_on_failure = true);
+    // While bound, mapping must be the mapping bound by Init(), whose cached
+    // concordant layout is reused.
+    std::vector<Status> ConstructLayout(uint64_t layout_splitting_id, uint64_t layout_packing_id, uint64_t layout_auth_id, layout::Layouts* layouts, const Mapping& mapping, bool skip_authblock, bool break_on_failure = true);
 
     // Layout constraint methods
     void CreateConcordantLayout(const Mapping& mapping);
@@ -227,6 +334,10 @@ class Legal
     
     void SequentialFactorizeLayout(layout::Layouts& layout);
 
+    // Samplers over the PackingSpace and AuthSpace of the current mapping.
+    Sampler PackingSampler(const SamplingConfig& config, std::mt19937_64& generator) const;
+    Sampler AuthSampler(const SamplingConfig& config, std::mt19937_64& generator) const;
+
     // Helper methods for multi-rank splitting
     std::vector<std::vector<std::string>> GenerateRankCombinations(const std::vector<std::string>& ranks, size_t max_combo_size = 3);
     bool TestMultiRankSplittingWithCandidates(unsigned lvl, unsigned ds_idx, const std::vector<std::string>& rank_combination,
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "mapping/loop.hpp"
 #include "workload/shape-models/problem-shape.hpp"
@@ -38,6 +39,47 @@
 namespace analysis
 {
 
+// ---------------------------------------------------------------
+// Deltas of the spatial elements under a master spatial level, keyed
+// by (skewed) spatial index. Entries are numbered 0..size()-1 in the
+// order they were inserted, and are kept in a pool that Clear() does
+// not free. Unskewed indices are dense, so they are looked up through
+// a flat table; skewed indices go through a hash map.
+// ---------------------------------------------------------------
+class SpatialDeltas
+{
+ private:
+  const problem::Workload* workload_ = nullptr;
+  bool dense_ = true;
+
+  std::size_t size_ = 0;
+  std::vector<std::uint64_t> indices_;          // spatial index of each entry.
+  std::vector<problem::OperationSpace> deltas_; // pool, the first size_ are live.
+
+  std::vector<std::int64_t> dense_entries_;     // spatial index -> entry, or -1.
+  std::unordered_map<std::uint64_t, std::size_t> sparse_entries_;
+
+ public:
+  // Drops all entries and switches the lookup mode. The pool is discarded
+  // only if the workload changes.
+  void Reset(const problem::Workload* workload, bool dense, std::uint64_t num_spatial_elems);
+  void Clear();
+  void CopyFrom(const SpatialDeltas& other);
+
+  std::size_t size() const { return size_; }
+  std::uint64_t Index(std::size_t entry) const { return indices_[entry]; }
+  problem::OperationSpace& Delta(std::size_t entry) { return deltas_[entry]; }
+  const problem::OperationSpace& Delta(std::size_t entry) const { return deltas_[entry]; }
+
+  // Returns nullptr if there is no delta at this spatial index.
+  const problem::OperationSpace* Find(std::uint64_t index) const;
+  problem::OperationSpace& at(std::uint64_t index);
+  const problem::OperationSpace& at(std::uint64_t index) const;
+
+  // Adds an empty delta at a spatial index that must not be present yet.
+  problem::OperationSpace& Insert(std::uint64_t index);
+};
+
 // ---------------------------------------------------------------
 // Live state for a single spatial element in a single loop level.
 // ---------------------------------------------------------------
@@ -59,7 +101,7 @@ struct ElementState
   // One for each spatial element in next level
 
   // time * element_id
-  std::unordered_map<std::uint64_t, problem::OperationSpace> prev_spatial_deltas;
+  SpatialDeltas prev_spatial_deltas;
   //std::vector<std::unordered_map<std::uint64_t, problem::OperationSpace>> prev_spatial_deltas;
   // std::vector<std::vector<problem::OperationSpace>> prev_spatial_deltas;
 
@@ -47,8 +47,9 @@ class NestAnalysis
   // Cached copy of loop nest under evaluation (used for speedup).
   loop::Nest cached_nest;
   
-  // layout modeling
-  layout::Layouts layout_;
+  // layout modeling; the layouts are owned by the caller of Init() and must
+  // outlive the evaluation that uses them.
+  const layout::Layouts* layout_ = nullptr;
   bool layout_initialized_ = false;
 
   // Properties of the nest being analyzed (copied over during construction).
@@ -95,6 +96,12 @@ class NestAnalysis
   // extrapolation may be disabled at certain levels.
   std::vector<bool> disable_temporal_extrapolation_;
 
+  // Temporal loops that were evaluated by running every iteration instead of
+  // being extrapolated, and the number of iterations they ran, during the
+  // last ComputeWorkingSets().
+  std::uint64_t temporal_slow_path_loops_ = 0;
+  std::uint64_t temporal_slow_path_iterations_ = 0;
+
   // any level which is at the transition point from temporal to
   // spatial nests is a master spatial level.
   // there should be one such level between each set of
@@ -139,6 +146,22 @@ class NestAnalysis
   std::unordered_map<unsigned, problem::PerDataSpace<bool>> rmw_first_update_;
   std::unordered_map<unsigned, problem::PerDataSpace<bool>> no_coalesce_;
 
+  // Scratch space for ComputeSpatialWorkingSet(), one per loop level (each
+  // level is on the recursion stack at most once). It is kept across Reset()
+  // calls so that successive evaluations reuse its allocations.
+  struct SpatialScratch
+  {
+    analysis::SpatialDeltas spatial_deltas;
+    std::unordered_map<std::uint64_t, std::uint64_t> skew_table;
+    problem::PerDataSpace<std::vector<bool>> unaccounted_delta; // per delta entry.
+
+    SpatialScratch(unsigned num_data_spaces) :
+        unaccounted_delta(num_data_spaces)
+    {
+    }
+  };
+  std::vector<SpatialScratch> spatial_scratch_;
+
   // Other state.
 
   bool working_sets_computed_ = false;
@@ -176,7 +199,7 @@ class NestAnalysis
   void ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur);
 
   void FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_iterator cur,
-                         std::unordered_map<std::uint64_t, problem::OperationSpace>& spatial_deltas,
+                         analysis::SpatialDeltas& spatial_deltas,
                          std::unordered_map<std::uint64_t, std::uint64_t>& skew_table,
                          std::uint64_t base_index,
                          int depth,
@@ -187,19 +210,19 @@ class NestAnalysis
 
   void ComputeAccurateMulticastedAccesses(
       std::vector<analysis::LoopState>::reverse_iterator cur,
-      const std::unordered_map<std::uint64_t, problem::OperationSpace>& spatial_deltas,
-      problem::PerDataSpace<std::unordered_set<std::uint64_t>>& unaccounted_delta,
+      const analysis::SpatialDeltas& spatial_deltas,
+      problem::PerDataSpace<std::vector<bool>>& unaccounted_delta,
       problem::PerDataSpace<AccessStatMatrix>& access_stats);
 
   void ComputeNetworkLinkTransfers(
       std::vector<analysis::LoopState>::reverse_iterator cur,
-      const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-      problem::PerDataSpace<std::unordered_set<std::uint64_t>>& unaccounted_delta,
+      const analysis::SpatialDeltas& cur_spatial_deltas,
+      problem::PerDataSpace<std::vector<bool>>& unaccounted_delta,
       problem::PerDataSpace<std::uint64_t>& link_transfers);
  
   void CompareSpatioTemporalDeltas(
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& prev_spatial_deltas,
+    const analysis::SpatialDeltas& cur_spatial_deltas,
+    const analysis::SpatialDeltas& prev_spatial_deltas,
     const std::uint64_t cur_spatial_index,
     const std::uint64_t prev_spatial_index,
     std::vector<problem::PerDataSpace<bool>>& inter_elem_reuse,
@@ -214,7 +237,7 @@ class NestAnalysis
   void Init(problem::Workload* wc, const loop::Nest* nest,
             std::map<unsigned, std::uint64_t> fanoutX_map,
             std::map<unsigned, std::uint64_t> fanoutY_map);
-  void Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts layout,
+  void Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts& layout,
             std::map<unsigned, std::uint64_t> fanoutX_map,
             std::map<unsigned, std::uint64_t> fanoutY_map);
   void Reset();
@@ -224,12 +247,16 @@ class NestAnalysis
   CompoundDataMovementNest GetWorkingSets();
   CompoundComputeNest GetComputeInfo();
   problem::Workload* GetWorkload();
-  layout::Layouts GetLayout();
+  const layout::Layouts& GetLayout() const;
   bool IsLayoutInitialized();
 
   // currently need this for imperfect factorization in bank conflict computation
   std::uint64_t GetLoopOuterSize(const loop::Descriptor &loop) const; 
 
+  // Slow-path (non-extrapolated) temporal loop statistics.
+  std::uint64_t GetTemporalSlowPathLoops() const;
+  std::uint64_t GetTemporalSlowPathIterations() const;
+
   // Serialization.
   friend class boost::serialization::access;
 
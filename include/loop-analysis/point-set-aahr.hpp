@@ -30,6 +30,8 @@
 #include <iostream>
 #include <cassert>
 
+#include <boost/container/small_vector.hpp>
+
 #include "point.hpp"
 
 #define ASSERT(args...) assert(args)
@@ -62,6 +64,12 @@ struct Gradient
 //        AAHR Point Set implementation
 // ---------------------------------------------
 
+class AxisAlignedHyperRectangle;
+
+// Most AAHR lists (MultiAAHR members, subtraction splinters) hold one or two
+// entries, so keep that many inline.
+typedef boost::container::small_vector<AxisAlignedHyperRectangle, 2> AAHRList;
+
 class AxisAlignedHyperRectangle
 {
  protected:
@@ -78,9 +86,10 @@ class AxisAlignedHyperRectangle
   AxisAlignedHyperRectangle(std::uint32_t order, const Point min, const Point max);
   AxisAlignedHyperRectangle(std::uint32_t order, const std::vector<std::pair<Point, Point>> corner_sets);
   AxisAlignedHyperRectangle(const AxisAlignedHyperRectangle& a);
+  AxisAlignedHyperRectangle(AxisAlignedHyperRectangle&& a) noexcept;
 
-  // Copy-and-swap idiom.
-  AxisAlignedHyperRectangle& operator = (AxisAlignedHyperRectangle other);
+  AxisAlignedHyperRectangle& operator = (const AxisAlignedHyperRectangle& other);
+  AxisAlignedHyperRectangle& operator = (AxisAlignedHyperRectangle&& other) noexcept;
   friend void swap(AxisAlignedHyperRectangle& first, AxisAlignedHyperRectangle& second);
 
   Point Min() const;
@@ -95,7 +104,8 @@ class AxisAlignedHyperRectangle
   void ExtrudeAdd(const AxisAlignedHyperRectangle& s);
   void Add(const AxisAlignedHyperRectangle& s, bool extrude_if_discontiguous = false);
   Gradient Subtract(const AxisAlignedHyperRectangle& s);
-  std::vector<AxisAlignedHyperRectangle> MultiSubtract(const AxisAlignedHyperRectangle& b);
+  // Appends the disjoint pieces of (this - b) to out.
+  void MultiSubtract(const AxisAlignedHyperRectangle& b, AAHRList& out) const;
   bool MergeIfAdjacent(const Point& p);
 
   AxisAlignedHyperRectangle& operator += (const Point& p);
@@ -103,6 +113,9 @@ class AxisAlignedHyperRectangle
   AxisAlignedHyperRectangle operator - (const AxisAlignedHyperRectangle& s);
   bool operator == (const AxisAlignedHyperRectangle& s) const;
 
+  // Equal AAHRs have equal hashes.
+  std::size_t Hash() const;
+
   bool Contains(const Point& p) const;
 
   Point GetTranslation(const AxisAlignedHyperRectangle& s) const;
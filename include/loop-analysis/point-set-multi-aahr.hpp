@@ -38,7 +38,7 @@ class MultiAAHR
 
   // All AAHRs in the set are guaranteed to be disjoint.
   // This property must be maintained at all times.
-  std::vector<AxisAlignedHyperRectangle> aahrs_;
+  AAHRList aahrs_;
 
  public:
 
@@ -48,9 +48,10 @@ class MultiAAHR
   MultiAAHR(std::uint32_t order, const Point min, const Point max);
   MultiAAHR(std::uint32_t order, const std::vector<std::pair<Point, Point>> corner_sets);
   MultiAAHR(const MultiAAHR& a);
+  MultiAAHR(MultiAAHR&& a) noexcept;
 
-  // Copy-and-swap idiom.
-  MultiAAHR& operator = (MultiAAHR other);
+  MultiAAHR& operator = (const MultiAAHR& other);
+  MultiAAHR& operator = (MultiAAHR&& other) noexcept;
   friend void swap(MultiAAHR& first, MultiAAHR& second);
 
   std::size_t size() const;
@@ -65,6 +66,9 @@ class MultiAAHR
   MultiAAHR operator - (const MultiAAHR& other);
   bool operator == (const MultiAAHR& s) const;
 
+  // Equal sets have equal hashes regardless of the order of their AAHRs.
+  std::size_t Hash() const;
+
   Point GetTranslation(const MultiAAHR& s) const;
   void Translate(const Point& p);
 
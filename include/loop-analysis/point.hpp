@@ -31,24 +31,33 @@
 #include <iostream>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 typedef std::int32_t Coordinate;
 
+// Points up to this order keep their coordinates inline; larger points fall
+// back to the heap. Data-space ranks rarely exceed this.
+const std::uint32_t kMaxInlineOrder = 8;
+
 class Point
 {
  protected:
   std::uint32_t order_;
-  std::vector<Coordinate> coordinates_;
+  boost::container::small_vector<Coordinate, kMaxInlineOrder> coordinates_;
 
  public:
   // We really wanted to delete this constructor, but that would mean we can't
   // use DynamicArray<Point> (and consequently PerDataSpace<Point>).
   Point();
   Point(const Point& p);
+  Point(Point&& p) noexcept;
   Point(std::uint32_t order);
   Point(std::vector<Coordinate> coordinates);
-  
-  // Copy-and-swap idiom.
-  Point& operator = (Point other);
+
+  // Assign in place rather than copy-and-swap: swapping inline storage costs
+  // as much as a copy, so the idiom would copy twice.
+  Point& operator = (const Point& other);
+  Point& operator = (Point&& other) noexcept;
   friend void swap(Point& first, Point& second);
 
   bool operator == (const Point& other);
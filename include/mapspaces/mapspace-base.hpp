@@ -93,6 +93,10 @@ class MapSpace
 
   virtual std::vector<MapSpace*> Split(std::uint64_t num_splits) = 0;
 
+  // Copies that each span the whole mapspace, for searches that share out
+  // the index factorizations dynamically (see search::WorkPool).
+  virtual std::vector<MapSpace*> Replicate(std::uint64_t num_replicas) = 0;
+
   virtual void InitPruned(uint128_t local_index_factorization_id) = 0;
 
   virtual std::vector<Status> ConstructMapping(ID mapping_id, Mapping* mapping, bool break_on_failure = true) = 0;
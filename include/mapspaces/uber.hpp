@@ -101,6 +101,7 @@ class Uber : public MapSpace
 
   // Split the mapspace (used for parallelization).
   std::vector<MapSpace*> Split(std::uint64_t num_splits);
+  std::vector<MapSpace*> Replicate(std::uint64_t num_replicas);
   void InitSplit(std::uint64_t split_id, uint128_t split_if_size, std::uint64_t num_parent_splits);
   bool IsSplit();
 
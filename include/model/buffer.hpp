@@ -382,7 +382,8 @@ class BufferLevel : public Level
     uint64_t auth_block_size;
     uint64_t memory_line;
 
-    std::string reused_rank_id;
+    std::vector<unsigned> intraline_rank_ids; // layout::RankTable IDs of the intraline nest
+    int reused_rank_id = -1;
     problem::Shape::FlattenedDimensionID reused_dim_id;
 
     int reuse_max_order = -1;
@@ -391,6 +392,15 @@ class BufferLevel : public Level
     double crypto_hash_reads_per_line = 0;
   };
 
+  // Memoized (slowdown, correction ratio) results of
+  // ComputeBankConflictSlowdownPerDataSpace(), keyed by a canonical encoding of
+  // all of its inputs (see SlowdownSignature()).
+  struct SlowdownSignatureHash
+  {
+    std::size_t operator()(const std::vector<std::int64_t>& signature) const;
+  };
+  typedef std::unordered_map<std::vector<std::int64_t>, std::pair<double, double>, SlowdownSignatureHash> SlowdownCache;
+
   struct TileTypeDescriptor
   {
     std::vector<int> num_lines;
@@ -408,8 +418,26 @@ class BufferLevel : public Level
         return num_lines < other.num_lines;
       return dataspace_rb < other.dataspace_rb;
     }
+
+    bool operator==(const TileTypeDescriptor& other) const
+    {
+      return first_tile == other.first_tile &&
+             dataspace_mask == other.dataspace_mask &&
+             num_lines == other.num_lines &&
+             dataspace_rb == other.dataspace_rb;
+    }
   };
 
+  struct TileTypeDescriptorHash
+  {
+    std::size_t operator()(const TileTypeDescriptor& desc) const;
+  };
+
+  // Number of tiles of each type, sorted by descriptor. Tiles are counted in
+  // a hash table and flattened once, since the histograms are re-walked for
+  // every combination of rank-group tile types.
+  typedef std::vector<std::pair<TileTypeDescriptor, int>> TileTypeHistogram;
+
   struct LatencyStats
   {
     uint64_t total_cnt;
@@ -431,6 +459,15 @@ class BufferLevel : public Level
   problem::Workload* workload_ = nullptr;
   double overall_slowdown_ = 1.0;
 
+  // Slowdown memo cache. It is only valid for one rank table, which is held
+  // here so that its address cannot be reused by a different table.
+  SlowdownCache slowdown_cache_;
+  std::shared_ptr<const layout::RankTable> slowdown_cache_rank_table_;
+
+  // Reused flat factor arrays of the nests being evaluated.
+  std::vector<std::uint32_t> intra_factors_;
+  std::vector<std::uint32_t> auth_factors_;
+
   // Network endpoints.
   std::shared_ptr<Network> network_read_;
   std::shared_ptr<Network> network_fill_;
@@ -471,57 +508,60 @@ class BufferLevel : public Level
   void ComputeBufferEnergy(const tiling::CompoundDataMovementInfo& data_movement_info);
   void ComputeReductionEnergy();
   void ComputeAddrGenEnergy();
-  unsigned FindRankGroupRepresentative(std::vector<unsigned>& rep, unsigned idx);
-  std::pair<std::vector<std::vector<std::string>>, std::vector<std::vector<problem::Shape::FlattenedDimensionID>>> 
-    GroupRelatedRanks(const layout::Layout layout);
-  
-  std::map<BufferLevel::TileTypeDescriptor, int>
+  TileTypeHistogram
     CountPerGroupTileTypes(const layout::Layout& layout,
-                           std::vector<std::string>& ranks,
-                           std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                           std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                           std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                           std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                           const layout::RankTable& rank_table,
+                           const std::vector<unsigned>& ranks,
+                           const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                           const std::vector<int>& rank_id_to_mapping_parallelism,
+                           const std::vector<int>& rank_id_to_binding_parallelism,
+                           const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                            std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                            std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace);
   void CountPerGroupTileTypesRecursive(const layout::Layout& layout,
-                                       std::vector<std::string>& ranks,
-                                       std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                                       std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                                       std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                                       std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                                       const layout::RankTable& rank_table,
+                                       const std::vector<unsigned>& ranks,
+                                       const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                                       const std::vector<int>& rank_id_to_mapping_parallelism,
+                                       const std::vector<int>& rank_id_to_binding_parallelism,
+                                       const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                                        std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                                        std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                        std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned>& dim_it_idx,
+                                       const std::vector<std::vector<std::pair<unsigned, int>>>& dim_iterations,
                                        std::vector<unsigned>& dims_it,
                                        unsigned dim_idx,
-                                       std::map<TileTypeDescriptor, int>& cnt_tile_types);
+                                       int cnt,
+                                       std::unordered_map<TileTypeDescriptor, int, TileTypeDescriptorHash>& cnt_tile_types);
   void CountPerGroupTileTypesBase(const layout::Layout& layout,
-                                  std::vector<std::string>& ranks,
-                                  std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                                  std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                                  std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                                  std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                                  const layout::RankTable& rank_table,
+                                  const std::vector<unsigned>& ranks,
+                                  const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                                  const std::vector<int>& rank_id_to_mapping_parallelism,
+                                  const std::vector<int>& rank_id_to_binding_parallelism,
+                                  const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                                   std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                                   std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                   std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned>& dim_it_idx,
                                   std::vector<unsigned>& dims_it,
-                                  std::map<TileTypeDescriptor, int>& cnt_tile_types);
+                                  int cnt,
+                                  std::unordered_map<TileTypeDescriptor, int, TileTypeDescriptorHash>& cnt_tile_types);
   LatencyStats CheckTileTypes(const layout::Layout& layout,
+                              const layout::RankTable& rank_table,
                               const crypto::CryptoConfig *crypto_config,
                               const tiling::CompoundMask &mask,
-                              std::vector<std::vector<std::string>>& rank_groups,
-                              std::vector<std::map<TileTypeDescriptor, int>>& cnt_tile_types,
+                              const std::vector<std::vector<unsigned>>& rank_groups,
+                              const std::vector<const TileTypeHistogram*>& cnt_tile_types,
                               std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                               uint64_t compute_cycles);
   LatencyStats CheckTileTypesRecursive(const layout::Layout& layout,
                                        const crypto::CryptoConfig *crypto_config,
                                        const tiling::CompoundMask &mask,
-                                       std::vector<std::vector<std::string>>& rank_groups,
-                                       std::vector<std::map<TileTypeDescriptor, int>>& cnt_tile_types,
+                                       const std::vector<std::vector<unsigned>>& rank_groups,
+                                       const std::vector<const TileTypeHistogram*>& cnt_tile_types,
                                        std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                        uint64_t compute_cycles,
-                                       std::unordered_map<std::string, int>& rank_id_to_lines,
+                                       std::vector<int>& rank_id_to_lines,
                                        std::vector<bool> dataspace_rb,
                                        uint64_t cur_cnt,
                                        bool first_tile_possible,
@@ -531,33 +571,38 @@ class BufferLevel : public Level
                                   const tiling::CompoundMask &mask,
                                   std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                   uint64_t compute_cycles,
-                                  std::unordered_map<std::string, int>& rank_id_to_lines,
+                                  const std::vector<int>& rank_id_to_lines,
                                   std::vector<bool> dataspace_rb,
                                   uint64_t cur_cnt,
                                   bool first_tile);
-  std::pair<double, double> ComputeBankConflictSlowdownIndividual(const layout::Layout layout,
+  std::pair<double, double> ComputeBankConflictSlowdownIndividual(const layout::Layout& layout,
+                                                                  const layout::RankTable& rank_table,
                                                                   const tiling::CompoundMask &mask,
                                                                   const crypto::CryptoConfig *crypto_config,
                                                                   uint64_t compute_cycles,
                                                                   double total_data_requested,
-                                                                  //const std::vector<std::string> &rank_list,
-                                                                  std::unordered_map<problem::Shape::FlattenedDimensionID, int> dim_id_to_number_of_tiles,
-                                                                  //std::unordered_map<std::string, int> &rank_id_to_rank_list_index,
-                                                                  //std::unordered_map<std::string, int> &rank_id_to_number_of_tiles,
-                                                                  std::unordered_map<std::string, int> &rank_id_to_mapping_parallelism,
-                                                                  std::unordered_map<std::string, int> &rank_id_to_binding_parallelism,
-                                                                  std::unordered_map<std::string, std::vector<int>> &rank_id_to_dim_jumps,
-                                                                  std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace_base);
-  std::pair<double, double> ComputeBankConflictSlowdownPerDataSpace(const layout::Layout layout,
+                                                                  const std::vector<const TileTypeHistogram*>& cnt_tile_types,
+                                                                  std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace);
+  std::vector<std::int64_t> SlowdownSignature(const layout::Layout& layout,
+                                              const layout::RankTable& rank_table,
+                                              const tiling::CompoundMask &mask,
+                                              const crypto::CryptoConfig *crypto_config,
+                                              uint64_t compute_cycles,
+                                              const std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>>& dim_id_to_mapping_parallelism,
+                                              const std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
+                                              const std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t>& dim_id_to_outer_size,
+                                              const std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace_base) const;
+  std::pair<double, double> ComputeBankConflictSlowdownPerDataSpace(const layout::Layout& layout,
+                                                                    const layout::RankTable& rank_table,
                                                                     const tiling::CompoundMask &mask,
                                                                     const crypto::CryptoConfig *crypto_config,
                                                                     uint64_t compute_cycles,
-                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>> dim_id_to_mapping_parallelism,
-                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, int> dim_id_to_number_of_tiles,
-                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t> dim_id_to_outer_size,
-                                                                    std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace_base); // bank conflict analysis for current dataspace
+                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>>& dim_id_to_mapping_parallelism,
+                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
+                                                                    std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t>& dim_id_to_outer_size,
+                                                                    std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace_base); // bank conflict analysis for current dataspace
   tiling::CompoundTile ComputeBankConflictSlowdown(const tiling::CompoundTile &tile,
-                                                  layout::Layout layout,
+                                                  const layout::Layout& layout,
                                                   const tiling::CompoundMask &mask,
                                                   const analysis::NestAnalysis *analysis,
                                                   std::vector<loop::Descriptor> &current_level_loopnest,
@@ -591,6 +636,13 @@ class BufferLevel : public Level
                                problem::Shape::DataSpaceID pv, Specs& specs);
   static void ValidateTopology(BufferLevel::Specs& specs);
 
+  // Imperfect-rank bits of the rank groups whose tile types depend on them,
+  // given each group's histograms for all sub-bitmasks of its own bits. The
+  // bank conflict model enumerates only these bits jointly.
+  static std::uint32_t CoupledImperfectBits(
+    const std::vector<std::unordered_map<std::uint32_t, TileTypeHistogram>>& group_tile_types,
+    const std::vector<std::uint32_t>& group_imperfect_bits);
+
   void PopulateEnergyPerOp(unsigned num_ops);
 
   inline Specs& GetSpecs() { return specs_; }
@@ -617,8 +669,19 @@ class BufferLevel : public Level
                                 const double confidence_threshold,
                                 const bool break_on_failure) override;
 
+  // PreEvaluationCheck() in two steps: the per-data-space capacity needed by
+  // the working sets, which does not depend on the bypass mask, and the check
+  // of the un-masked total against this level's capacity.
+  problem::PerDataSpace<std::size_t> RequiredCapacities(const problem::PerDataSpace<std::size_t>& working_set_sizes,
+                                                        const problem::Workload* workload,
+                                                        const sparse::PerStorageLevelCompressionInfo& per_level_compression_info,
+                                                        const double confidence_threshold);
+  EvalStatus PreEvaluationCheck(const problem::PerDataSpace<std::size_t>& required_capacities,
+                                const tiling::CompoundMask& mask,
+                                const problem::Workload* workload);
+
   EvalStatus Evaluate(const tiling::CompoundTile &tile,
-                    const tiling::CompoundMask &mask, layout::Layout layout,
+                    const tiling::CompoundMask &mask, const layout::Layout& layout,
                     const analysis::NestAnalysis *analysis,
                     std::vector<loop::Descriptor> &current_level_loopnest,
                     std::vector<loop::Descriptor> &subtile_mapping_loopnest,
@@ -645,6 +708,10 @@ class BufferLevel : public Level
   // Accessors (post-evaluation).
   
   double Energy(problem::Shape::DataSpaceID pv) const override;
+  // Energy known as soon as this level has been evaluated, i.e., before
+  // FinalizeBufferEnergy() adds leakage and child-level overflow energy.
+  // Never exceeds the final Energy().
+  double PartialEnergy(problem::Shape::DataSpaceID pv = problem::GetShape()->NumDataSpaces) const;
  
   std::string Name() const override;
   double Area() const override;
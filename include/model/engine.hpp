@@ -87,9 +87,24 @@ class Engine : public Module
 
   std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
 
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, layout::Layouts layout, sparse::SparseOptimizationInfo* sparse_optimizations, crypto::CryptoConfig* crypto_config, bool break_on_failure = true);
+  // PreEvaluationCheck() of a batch of sibling mappings that share a loop
+  // nest and differ only in bypassing. Tile shapes and capacity requirements
+  // are computed once for the batch; back-to-back single calls on siblings
+  // share them in the same way.
+  std::vector<std::vector<EvalStatus>> PreEvaluationCheck(const std::vector<const Mapping*>& siblings, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
+
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, const layout::Layouts& layout, sparse::SparseOptimizationInfo* sparse_optimizations, crypto::CryptoConfig* crypto_config, bool break_on_failure = true);
   std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, crypto::CryptoConfig* crypto_config, bool break_on_failure = true);
   std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
+
+  // Re-evaluate the most recently evaluated mapping under a different layout,
+  // reusing its tiles, access counts and network results.
+  std::vector<EvalStatus> EvaluateLayout(const layout::Layouts& layout, crypto::CryptoConfig* crypto_config, bool break_on_failure = true);
+  bool LayoutEvaluationReady() const;
+
+  // Abandon evaluations whose partial stats the cutoff rejects (see
+  // Topology::SetCutoff()).
+  void SetCutoff(Topology::Cutoff cutoff);
   
   double Energy() const;
   double Area() const;
@@ -31,6 +31,7 @@ algorithmic contributors may be used tactual or promote products derived
 #include <memory>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 
 #include "loop-analysis/tiling.hpp"
 #include "loop-analysis/tiling-tile-info.hpp"
@@ -228,6 +229,11 @@ class Topology : public Module
     }
   };
 
+  // Evaluations can be abandoned part-way once a lower bound on the final
+  // stats shows the caller has no use for them. The bound is the max of the
+  // cycles of the levels evaluated so far and the sum of their energies.
+  typedef std::function<bool(const Stats& lower_bound)> Cutoff;
+
  private:
   std::vector<std::shared_ptr<Level>> levels_;
   std::map<std::string, std::shared_ptr<Network>> networks_;
@@ -256,6 +262,42 @@ class Topology : public Module
   Stats stats_;
 
   problem::Workload* workload_ = nullptr;
+
+  // Mapping-dependent state captured by Evaluate() so that EvaluateLayout()
+  // can re-run only the layout-dependent storage-level models.
+  struct LayoutEvalCache
+  {
+    bool valid = false;
+    analysis::NestAnalysis* analysis = nullptr;
+    tiling::NestOfCompoundTiles tiles;
+    tiling::NestOfCompoundMasks keep_masks;
+    std::vector<double> confidence_thresholds;
+    std::uint64_t compute_cycles = 0;
+    std::vector<std::vector<loop::Descriptor>> current_level_loopnests;
+    std::vector<std::vector<loop::Descriptor>> subtile_mapping_loopnests;
+    std::vector<std::vector<loop::Descriptor>> subtile_mapping_parallelisms;
+    EvalStatus arithmetic_status;
+    std::vector<EvalStatus> network_status;
+  };
+  LayoutEvalCache layout_eval_cache_;
+
+  // Per-level capacity requirements from the last PreEvaluationCheck(). They
+  // depend on the loop nest but not on bypassing, so mappings that differ
+  // only in their bypass masks (consecutive in a pruned search) share them.
+  struct PreEvalCache
+  {
+    bool valid = false;
+    loop::Nest nest;
+    std::map<unsigned, double> confidence_thresholds;
+    const problem::Workload* workload = nullptr;
+    const sparse::SparseOptimizationInfo* sparse_optimizations = nullptr;
+    std::vector<problem::PerDataSpace<std::size_t>> required_capacities;
+  };
+  PreEvalCache pre_eval_cache_;
+
+  Cutoff cutoff_;
+  bool is_cut_off_ = false;
+  Stats cutoff_bound_;
   
   // Serialization
   friend class boost::serialization::access;
@@ -273,6 +315,8 @@ class Topology : public Module
 
   void FloorPlan();
   void ComputeStats(bool eval_success);
+  bool EvaluateStorageLevels(const layout::Layouts* layout, crypto::CryptoConfig* crypto_config,
+                             bool break_on_failure, std::vector<EvalStatus>& eval_status);
 
   /** @note Non-const getters to deal with fxns that depend on non-const outputs
    *  for the above fxns based on the below approach: 
@@ -351,6 +395,20 @@ class Topology : public Module
   std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, analysis::NestAnalysis* analysis, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure);
   std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure, crypto::CryptoConfig* crypto_config = nullptr);
 
+  // Layout-only re-evaluation of the mapping from the last Evaluate() call.
+  // Only legal when LayoutEvaluationReady() is true, i.e., the last
+  // Evaluate() was run with a layout and got past the arithmetic level.
+  std::vector<EvalStatus> EvaluateLayout(const layout::Layouts& layout, crypto::CryptoConfig* crypto_config, bool break_on_failure);
+  bool LayoutEvaluationReady() const { return layout_eval_cache_.valid; }
+
+  // The cutoff is consulted before each storage level (innermost first) when
+  // breaking on failure. A cut-off evaluation fails at the level it stopped
+  // at; IsCutOff() then tells it apart from an invalid mapping and
+  // CutoffBound() holds the lower bound that was rejected.
+  void SetCutoff(Cutoff cutoff) { cutoff_ = cutoff; }
+  bool IsCutOff() const { return is_cut_off_; }
+  const Stats& CutoffBound() const { return cutoff_bound_; }
+
   inline const Stats& GetStats() const { return stats_; }
   inline const Specs& GetSpecs() const { return specs_; }
 
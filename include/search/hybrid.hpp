@@ -37,6 +37,8 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/work-pool.hpp"
+#include "search/visited-set.hpp"
 
 namespace search
 {
@@ -54,6 +56,7 @@ class HybridSearch : public SearchAlgorithm
   // Config.
   mapspace::MapSpace* mapspace_;
   unsigned id_;
+  WorkPool* pool_; // index factorizations shared with other threads, if any
   bool filter_revisits_;
 
   // Submodules.
@@ -64,7 +67,7 @@ class HybridSearch : public SearchAlgorithm
   std::array<uint128_t, unsigned(mapspace::Dimension::Num)> iterator_;
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
-  std::unordered_set<uint128_t> visited_;
+  VisitedSet* visited_;
 
   double best_cost_;
   std::ofstream best_cost_file_;
@@ -80,7 +83,12 @@ class HybridSearch : public SearchAlgorithm
   };
   
  public:
-  HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id);
+  HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+               WorkPool* pool = nullptr);
+
+  // This class does not support being copied
+  HybridSearch(const HybridSearch&) = delete;
+  HybridSearch& operator=(const HybridSearch&) = delete;
 
   ~HybridSearch();
 
@@ -89,6 +97,9 @@ class HybridSearch : public SearchAlgorithm
   bool Next(mapspace::ID& mapping_id);
 
   void Report(Status status, double cost = 0);
+
+  bool SaveState(std::ostream& out) const;
+  bool LoadState(std::istream& in);
 };
 
 } // namespace search
@@ -36,6 +36,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/work-pool.hpp"
 
 namespace search
 {
@@ -53,6 +54,7 @@ class LinearPrunedSearch : public SearchAlgorithm
   // Config.
   mapspace::MapSpace* mapspace_;
   unsigned id_;
+  WorkPool* pool_; // index factorizations shared with other threads, if any
 
   // Live state.
   State state_;
@@ -74,7 +76,8 @@ class LinearPrunedSearch : public SearchAlgorithm
   };
   
  public:
-  LinearPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id);
+  LinearPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                     WorkPool* pool = nullptr);
 
   ~LinearPrunedSearch();
 
@@ -36,6 +36,8 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/work-pool.hpp"
+#include "search/visited-set.hpp"
 
 namespace search
 {
@@ -53,7 +55,9 @@ class RandomPrunedSearch : public SearchAlgorithm
   // Config.
   mapspace::MapSpace* mapspace_;
   unsigned id_;
+  WorkPool* pool_; // index factorizations shared with other threads, if any
   uint128_t max_permutations_per_if_visit_;
+  bool filter_revisits_;
 
   // Submodules.
   RandomGenerator128 if_pgen_;
@@ -66,7 +70,7 @@ class RandomPrunedSearch : public SearchAlgorithm
   uint128_t permutations_visited_;
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
-  std::unordered_set<uint128_t> visited_;
+  VisitedSet* visited_;
 
   double best_cost_;
   std::ofstream best_cost_file_;
@@ -82,7 +86,12 @@ class RandomPrunedSearch : public SearchAlgorithm
   };
   
  public:
-  RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id);
+  RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                     WorkPool* pool = nullptr);
+
+  // This class does not support being copied
+  RandomPrunedSearch(const RandomPrunedSearch&) = delete;
+  RandomPrunedSearch& operator=(const RandomPrunedSearch&) = delete;
 
   ~RandomPrunedSearch();
 
@@ -91,6 +100,9 @@ class RandomPrunedSearch : public SearchAlgorithm
   bool Next(mapspace::ID& mapping_id);
 
   void Report(Status status, double cost = 0);
+
+  bool SaveState(std::ostream& out) const;
+  bool LoadState(std::istream& in);
 };
 
 } // namespace search
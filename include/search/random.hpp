@@ -35,6 +35,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/visited-set.hpp"
 
 namespace search
 {
@@ -52,7 +53,7 @@ class RandomSearch : public SearchAlgorithm
   // Config.
   mapspace::MapSpace* mapspace_;
   // std::unordered_set<std::uint64_t> bad_;
-  std::unordered_set<uint128_t> visited_;
+  VisitedSet* visited_;
   bool filter_revisits_;
 
   // Submodules.
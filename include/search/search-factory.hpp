@@ -28,6 +28,7 @@
 #pragma once
 
 #include "search/search.hpp"
+#include "search/work-pool.hpp"
 #include "compound-config/compound-config.hpp"
 
 namespace search
@@ -37,8 +38,14 @@ namespace search
 //             Parser and Factory             //
 //--------------------------------------------//
 
+// Algorithms that sweep index factorizations (hybrid, random_pruned and
+// linear_pruned) take them from the pool if one is given.
 SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
                                    mapspace::MapSpace* mapspace,
-                                   unsigned id);
+                                   unsigned id,
+                                   WorkPool* pool = nullptr);
+
+// True if the algorithm can take its index factorizations from a WorkPool.
+bool UsesWorkPool(config::CompoundConfigNode config);
 
 } // namespace search
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <iostream>
+
 #include "mapspaces/mapspace-base.hpp"
 
 namespace search
@@ -36,7 +38,10 @@ enum class Status
 {
   Success,
   MappingConstructionFailure,
-  EvalFailure
+  EvalFailure,
+  // Valid, but evaluation was abandoned once a lower bound on its cost could
+  // not beat the incumbent. No cost is reported.
+  CutOff
 };
 
 class SearchAlgorithm
@@ -46,6 +51,13 @@ class SearchAlgorithm
   virtual ~SearchAlgorithm() {}
   virtual bool Next(mapspace::ID& mapping_id) = 0;
   virtual void Report(Status status, double cost = 0) = 0;
+
+  // Search state between a Report() and the next Next(), so that a search
+  // can be checkpointed and resumed. LoadState() re-initializes the mapspace
+  // to where the search left off. Algorithms that cannot be resumed return
+  // false and restart from scratch.
+  virtual bool SaveState(std::ostream& out) const { (void) out; return false; }
+  virtual bool LoadState(std::istream& in) { (void) in; return false; }
 };
 
 } // namespace search
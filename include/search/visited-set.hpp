@@ -0,0 +1,129 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+#include "compound-config/compound-config.hpp"
+#include "util/numeric.hpp"
+
+namespace search
+{
+
+//--------------------------------------------//
+//                Visited Sets                //
+//--------------------------------------------//
+
+// Set of mapspace IDs a search has already visited, used to filter
+// revisits. Exact sets never reject an unvisited ID; approximate sets
+// (Bloom filters) bound their memory and may reject a small fraction of
+// unvisited IDs instead.
+class VisitedSet
+{
+ public:
+  virtual ~VisitedSet() {}
+
+  // Returns true and marks the ID visited if it had not been visited yet.
+  virtual bool Insert(uint128_t id) = 0;
+
+  // Number of successful Insert()s.
+  virtual uint128_t Size() const = 0;
+
+  virtual bool Exact() const = 0;
+
+  virtual void SaveState(std::ostream& out) const = 0;
+  virtual bool LoadState(std::istream& in) = 0;
+};
+
+class HashVisitedSet : public VisitedSet
+{
+ private:
+  std::unordered_set<uint128_t> visited_;
+
+ public:
+  bool Insert(uint128_t id);
+  uint128_t Size() const { return visited_.size(); }
+  bool Exact() const { return true; }
+  void SaveState(std::ostream& out) const;
+  bool LoadState(std::istream& in);
+};
+
+class BitmapVisitedSet : public VisitedSet
+{
+ private:
+  std::vector<std::uint64_t> words_;
+  uint128_t size_;
+
+ public:
+  BitmapVisitedSet(uint128_t space_size);
+  bool Insert(uint128_t id);
+  uint128_t Size() const { return size_; }
+  bool Exact() const { return true; }
+  void SaveState(std::ostream& out) const;
+  bool LoadState(std::istream& in);
+};
+
+// Double-hashed Bloom filter with a fixed number of bits. Past its design
+// capacity the false-positive rate rises instead of the memory.
+class BloomVisitedSet : public VisitedSet
+{
+ private:
+  std::vector<std::uint64_t> words_;
+  std::uint64_t num_bits_;
+  unsigned num_hashes_;
+  uint128_t size_;
+
+ public:
+  BloomVisitedSet(std::uint64_t num_bits, double false_positive_rate);
+  bool Insert(uint128_t id);
+  uint128_t Size() const { return size_; }
+  bool Exact() const { return false; }
+  void SaveState(std::ostream& out) const;
+  bool LoadState(std::istream& in);
+
+  // Number of IDs the filter holds at the requested false-positive rate.
+  std::uint64_t Capacity() const;
+};
+
+// Consecutive rejections after which a search stops trying to avoid a
+// revisit through an approximate set.
+const unsigned kMaxVisitedRejections = 1000;
+
+// Selected with the mapper's visited_set key:
+//   hash   - exact, one hash-set entry per visited ID.
+//   bitmap - exact, one bit per ID of the space.
+//   bloom  - approximate, sized by visited_set_max_mb and
+//            visited_set_false_positive_rate.
+//   auto   - bitmap if it fits in visited_set_max_mb, bloom otherwise.
+// The memory cap applies to each search thread.
+VisitedSet* ParseAndConstructVisitedSet(config::CompoundConfigNode config,
+                                        uint128_t space_size);
+
+} // namespace search
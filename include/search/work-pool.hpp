@@ -0,0 +1,75 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "util/numeric.hpp"
+
+namespace search
+{
+
+//--------------------------------------------//
+//                  WorkPool                  //
+//--------------------------------------------//
+
+// Index factorizations shared out dynamically between search threads.
+// Threads claim chunks of consecutive positions from a shared cursor; once
+// the cursor runs out, a thread steals the upper half of the largest range
+// still held by another thread. Every position is handed out exactly once.
+// Positions are mapped to index factorization IDs by a fixed stride that
+// is coprime to the space size, so a chunk samples the whole space rather
+// than one corner of it.
+class WorkPool
+{
+ private:
+  struct Range
+  {
+    uint128_t begin = 0;
+    uint128_t end = 0;
+  };
+
+  std::mutex mutex_;
+  uint128_t size_;
+  uint128_t chunk_size_;
+  uint128_t stride_;
+  uint128_t cursor_;
+  std::vector<Range> ranges_;
+  std::uint64_t steals_;
+
+ public:
+  WorkPool(uint128_t size, unsigned num_threads, uint128_t chunk_size, bool scatter = true);
+
+  // Next index factorization for a thread, false once the space is exhausted.
+  bool Next(unsigned thread_id, uint128_t& index_factorization_id);
+
+  std::uint64_t Steals();
+};
+
+} // namespace search
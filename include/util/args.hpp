@@ -27,9 +27,18 @@
 
 #pragma once
 
+#include <set>
 #include <vector>
 #include <string>
 
 bool ParseArgs(int argc, char* argv[],
                std::vector<std::string>& input_files,
                std::string& output_dir);
+
+// Also accepts "--<option>" flags (e.g., --resume) listed in known_options
+// and returns the ones given in options.
+bool ParseArgs(int argc, char* argv[],
+               std::vector<std::string>& input_files,
+               std::string& output_dir,
+               const std::set<std::string>& known_options,
+               std::set<std::string>& options);
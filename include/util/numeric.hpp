@@ -612,6 +612,10 @@ class PatternGenerator128
   PatternGenerator128(uint128_t bound);
 
   virtual uint128_t Next() = 0;
+
+  // Position in the pattern as text, so a search can be resumed.
+  virtual void SaveState(std::ostream& out) const = 0;
+  virtual void LoadState(std::istream& in) = 0;
 };
 
 class SequenceGenerator128 final : public PatternGenerator128
@@ -624,6 +628,9 @@ class SequenceGenerator128 final : public PatternGenerator128
   SequenceGenerator128(uint128_t bound, bool autoloop = true);
 
   uint128_t Next();
+
+  void SaveState(std::ostream& out) const;
+  void LoadState(std::istream& in);
 };
 
 class RandomGenerator128 final : public PatternGenerator128
@@ -639,6 +646,9 @@ class RandomGenerator128 final : public PatternGenerator128
   RandomGenerator128(uint128_t bound);
 
   uint128_t Next();
+
+  void SaveState(std::ostream& out) const;
+  void LoadState(std::istream& in);
 };
 
 //------------------------------------
@@ -112,6 +112,7 @@ class OperationSpace
   std::size_t GetSize(const int t) const;
   bool IsEmpty(const int t) const;
   bool CheckEquality(const OperationSpace& rhs, const int t) const;
+  std::size_t Hash(const int t) const; // consistent with CheckEquality()
   void PrintSizes();
   void Print(std::ostream& out = std::cerr) const;
   void Print(Shape::DataSpaceID pv, std::ostream& out = std::cerr) const;
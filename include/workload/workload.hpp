@@ -202,6 +202,20 @@ class Workload
     shape_.Parse(config);
   }
 
+  // Discards the parsed shape and instance so that the workload can be parsed
+  // again (Shape::Parse() appends to the existing shape).
+  void Reset()
+  {
+    factorized_bounds_.clear();
+    flattened_bounds_.clear();
+    coefficients_.clear();
+    paddings_.clear();
+    densities_.clear();
+    workload_tensor_size_set_ = false;
+    default_dense_ = true;
+    shape_ = Shape();
+  }
+
  private:
   // Serialization
   friend class boost::serialization::access;
@@ -27,6 +27,9 @@
 
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "applications/design-space/design-space.hpp"
 
@@ -55,10 +58,34 @@ void PointResult::PrintEvaluationResult(std::ostream& out)
 //                Application                 //
 //--------------------------------------------//
 
-DesignSpaceExplorer::DesignSpaceExplorer(std::string problemfile, std::string archfile)
+DesignSpaceExplorer::DesignSpaceExplorer(std::string problemfile, std::string archfile,
+                                         unsigned thread_budget, unsigned threads_per_point)
 {
   problemspec_filename_ = problemfile;
   archspec_filename_ = archfile;
+  thread_budget_ = thread_budget > 0 ? thread_budget : std::max(std::thread::hardware_concurrency(), 1U);
+  threads_per_point_ = threads_per_point;
+}
+
+//
+// BuildPointConfig() - merge the arch and problem specs into one configuration.
+// Top-level keys of the problem spec override those of the arch spec.
+//
+std::string DesignSpaceExplorer::BuildPointConfig(const ArchSpaceNode& arch, const ProblemSpaceNode& problem) const
+{
+  YAML::Node combined = YAML::Clone(arch.yaml_);
+  for (auto it = problem.yaml_.begin(); it != problem.yaml_.end(); it++)
+  {
+    combined[it->first.as<std::string>()] = YAML::Clone(it->second);
+  }
+
+  // Points share the terminal and the core budget.
+  combined["mapper"]["num_threads"] = threads_per_point_;
+  combined["mapper"]["live_status"] = false;
+
+  YAML::Emitter out;
+  out << combined;
+  return std::string(out.c_str());
 }
 
 // ---------------
@@ -108,57 +135,88 @@ void DesignSpaceExplorer::Run()
     
   std::cout << "*** total arch: " << aspec_space.GetSize() << "   total prob: " << pspec_space.GetSize() << std::endl;        
 
-  std::cout << "****** SOLVING ******" << std::endl;        
-  //main loop, do the full product of problems x arches
+  // Split the core budget between concurrent points and their mapper threads.
+  std::size_t num_points = std::size_t(aspec_space.GetSize()) * pspec_space.GetSize();
+  if (threads_per_point_ == 0)
+  {
+    threads_per_point_ = std::max<std::size_t>(1, thread_budget_ / std::max<std::size_t>(num_points, 1));
+  }
+  unsigned concurrent_points = std::max(1U, thread_budget_ / threads_per_point_);
+  concurrent_points = std::min<std::size_t>(concurrent_points, std::max<std::size_t>(num_points, 1));
+  std::cout << "*** thread budget: " << thread_budget_ << "   concurrent points: " << concurrent_points
+            << "   mapper threads per point: " << threads_per_point_ << std::endl;
+
+  // Build all point configurations up front; YAML nodes are not safe to
+  // share between threads.
+  std::vector<DesignPoint> points;
   for (int arch_id = 0; arch_id < aspec_space.GetSize(); arch_id ++)
   {
     //retrieved via reference
-    ArchSpaceNode curr_arch = aspec_space.GetNode(arch_id);
-
-    std::cout << "*** working on arch : " << curr_arch.name_ << "  " << arch_id << std::endl;        
-
+    ArchSpaceNode& curr_arch = aspec_space.GetNode(arch_id);
     for (int problem_id = 0; problem_id < pspec_space.GetSize(); problem_id ++)
     {
       //retrieved via reference
-      ProblemSpaceNode curr_problem = pspec_space.GetNode(problem_id);
-        
-      // use problem and arch to run a mapper
+      ProblemSpaceNode& curr_problem = pspec_space.GetNode(problem_id);
+
       std::string config_name = curr_arch.name_ + "--" + curr_problem.name_;
-      std::cout << "*** working on config : " << config_name << std::endl;        
-      replace(config_name.begin(),config_name.end(),'/', '.'); 
-
-      std::string file_name = "results/" + config_name;
-
-      //output the two yaml to a single file
-      //CompoundConfigNode arch = CompoundConfigNode(nullptr, YAML::Clone(curr_arch.yaml_));
-      //CompoundConfigNode problem = CompoundConfigNode(nullptr, YAML::Clone(curr_problem.yaml_));
-      std::ofstream combined_yaml_file("temp_dse.yaml");
-      combined_yaml_file << curr_arch.yaml_ << std::endl; // <------------ HERE.
-      combined_yaml_file << curr_problem.yaml_ << std::endl; // <------------ HERE.
-      combined_yaml_file.close();
-      //pull tempfile into a compound config
-      config::CompoundConfig config("temp_dse.yaml");
-
-      //std::cout << "arch yaml: \n" << curr_arch.yaml_ << std::endl;
-      application::Mapper* mapper = new application::Mapper(&config, file_name);
-      //SimpleMapper mapper = SimpleMapper(config_name, arch, problem);
-      mapper->Run();
-      PointResult result(mapper->name_, mapper->GetGlobalBest());
-      mappers_.push_back(mapper);
-      designs_.push_back(result);
-      std::cout << "*** total arch: " << aspec_space.GetSize() << "   total prob: " << pspec_space.GetSize() << std::endl;        
-        
+      replace(config_name.begin(),config_name.end(),'/', '.');
+      points.push_back({config_name, BuildPointConfig(curr_arch, curr_problem)});
     }
   }
 
   std::string result_filename =  "overview_" + archspec_filename_ + problemspec_filename_ + ".txt";
-  replace(result_filename.begin(),result_filename.end(),'/', '.'); 
+  replace(result_filename.begin(),result_filename.end(),'/', '.');
   std::ofstream result_txt_file("results/" + result_filename);
-  //print final results
-  designs_[0].PrintEvaluationResultsHeader(result_txt_file);
-  for (size_t i = 0; i < designs_.size(); i++)
+
+  std::cout << "****** SOLVING ******" << std::endl;
+  // Results are streamed to the overview file as points complete.
+  std::mutex result_mutex;
+  std::atomic<std::size_t> next_point(0);
+  std::vector<EvaluationResult> results(points.size());
+  bool header_written = false;
+
+  auto worker = [&]()
+  {
+    for (std::size_t p = next_point++; p < points.size(); p = next_point++)
+    {
+      auto& point = points[p];
+      {
+        std::lock_guard<std::mutex> lock(result_mutex);
+        std::cout << "*** working on config : " << point.name << std::endl;
+      }
+
+      config::CompoundConfig config(point.config_yaml, "yaml");
+      application::Mapper mapper(&config, "results/" + point.name);
+      mapper.Run();
+      results[p] = mapper.GetGlobalBest();
+
+      std::lock_guard<std::mutex> lock(result_mutex);
+      PointResult result(point.name, results[p]);
+      if (!header_written)
+      {
+        result.PrintEvaluationResultsHeader(result_txt_file);
+        header_written = true;
+      }
+      result.PrintEvaluationResult(result_txt_file);
+      result_txt_file.flush();
+      std::cout << "*** finished config : " << point.name << "   total arch: " << aspec_space.GetSize()
+                << "   total prob: " << pspec_space.GetSize() << std::endl;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned w = 0; w < concurrent_points; w++)
   {
-    designs_[i].PrintEvaluationResult(result_txt_file);
+    workers.emplace_back(worker);
+  }
+  for (auto& w : workers)
+  {
+    w.join();
   }
   result_txt_file.close();
+
+  for (std::size_t p = 0; p < points.size(); p++)
+  {
+    designs_.emplace_back(points[p].name, results[p]);
+  }
 }
@@ -41,7 +41,12 @@ int main(int argc, char* argv[])
   archspec_filename = std::string(argv[1]);
   problemspec_filename = std::string(argv[2]);
 
-  DesignSpaceExplorer application(problemspec_filename, archspec_filename);  
+  // Optional: total thread budget and mapper threads per design point.
+  unsigned thread_budget = argc >= 4 ? std::stoul(argv[3]) : 0;
+  unsigned threads_per_point = argc >= 5 ? std::stoul(argv[4]) : 0;
+
+  DesignSpaceExplorer application(problemspec_filename, archspec_filename,
+                                  thread_budget, threads_per_point);
   application.Run();
 
   return 0;
@@ -64,7 +64,7 @@ LooptreeModel::Result LooptreeModel::Run()
     const auto einsum_id =
       std::get<mapping::Compute>(mapping_.NodeAt(buf.branch_leaf_id)).kernel;
 
-    auto p_occ_count = isl_map_card(stats.effective_occupancy.map.copy());
+    auto p_occ_count = isl::map_card(stats.effective_occupancy.map.copy());
     auto key = std::tie(buf.buffer_id, buf.dspace_id, einsum_id);
     model_result.occupancy[key] = std::make_pair(
       stats.effective_occupancy.dim_in_tags,
@@ -72,21 +72,21 @@ LooptreeModel::Result LooptreeModel::Run()
     );
     isl_pw_qpolynomial_free(p_occ_count);
 
-    auto p_fill_count = isl_map_card(stats.fill.map.copy());
+    auto p_fill_count = isl::map_card(stats.fill.map.copy());
     model_result.fills[key] = std::make_pair(
       stats.fill.dim_in_tags,
       isl_pw_qpolynomial_to_str(p_fill_count)
     );
     isl_pw_qpolynomial_free(p_fill_count);
 
-    auto p_parent_reads_count = isl_map_card(stats.parent_reads.map.copy());
+    auto p_parent_reads_count = isl::map_card(stats.parent_reads.map.copy());
     model_result.reads_to_parent[key] = std::make_pair(
       stats.parent_reads.dim_in_tags,
       isl_pw_qpolynomial_to_str(p_parent_reads_count)
     );
     isl_pw_qpolynomial_free(p_parent_reads_count);
 
-    auto p_peer_fills_count = isl_map_card(stats.link_transfer.map.copy());
+    auto p_peer_fills_count = isl::map_card(stats.link_transfer.map.copy());
     p_peer_fills_count = isl_pw_qpolynomial_intersect_domain(
       p_peer_fills_count,
       stats.fill.map.domain().release()
@@ -103,7 +103,7 @@ LooptreeModel::Result LooptreeModel::Run()
     const auto& dim_tags = occupancy.dim_in_tags;
     const auto& node =
       std::get<mapping::Compute>(mapping_.NodeAt(lcomp.branch_leaf_id));
-    auto p_ops = isl_map_card(occupancy.map.copy());
+    auto p_ops = isl::map_card(occupancy.map.copy());
     model_result.ops[node.kernel] = std::make_pair(
       dim_tags,
       isl_pw_qpolynomial_to_str(p_ops)
@@ -140,7 +140,7 @@ LooptreeModel::Result LooptreeModel::Run()
       unbounded_identity,
       isl_map_domain(non_spatial_map)
     );
-    const auto temporal_steps = isl_map_card(bounded_identity);
+    const auto temporal_steps = isl::map_card(bounded_identity);
     model_result.temporal_steps[node.kernel] = std::make_pair(
       new_dim_tags,
       isl_pw_qpolynomial_to_str(temporal_steps)
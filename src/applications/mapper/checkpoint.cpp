@@ -0,0 +1,84 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "applications/mapper/checkpoint.hpp"
+
+bool ReadCheckpoint(const std::string& path, MapperCheckpoint& checkpoint)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  try
+  {
+    boost::archive::binary_iarchive ar(file);
+    ar >> checkpoint;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "WARNING: ignoring unreadable checkpoint " << path << ": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool WriteCheckpoint(const std::string& path, const MapperCheckpoint& checkpoint)
+{
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid();
+
+  std::ofstream file(tmp_path.str(), std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cerr << "WARNING: cannot write checkpoint " << path << std::endl;
+    return false;
+  }
+  {
+    boost::archive::binary_oarchive ar(file);
+    ar << checkpoint;
+  }
+  file.close();
+
+  if (!file || std::rename(tmp_path.str().c_str(), path.c_str()) != 0)
+  {
+    std::cerr << "WARNING: cannot write checkpoint " << path << std::endl;
+    std::remove(tmp_path.str().c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,333 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+#include "applications/mapper/layout-search-pool.hpp"
+
+// Layout candidates of one mapping are re-evaluated incrementally (only the
+// layout-dependent storage models are re-run) unless this is disabled.
+bool gIncrementalLayoutEvaluation =
+  (getenv("TIMELOOP_DISABLE_INCREMENTAL_LAYOUT_EVAL") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_INCREMENTAL_LAYOUT_EVAL"), "0") == 0);
+
+// Layout candidates are shared among all mapper threads unless this is
+// disabled, in which case every thread evaluates its own candidates.
+bool gParallelLayoutSearch =
+  (getenv("TIMELOOP_DISABLE_PARALLEL_LAYOUT_SEARCH") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_PARALLEL_LAYOUT_SEARCH"), "0") == 0);
+
+LayoutSearchPool::LayoutSearchPool(unsigned num_workers) :
+    next_context_id_(1),
+    retired_workers_(0),
+    queued_tasks_(0)
+{
+  for (unsigned w = 0; w < num_workers; w++)
+  {
+    workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+  }
+}
+
+unsigned LayoutSearchPool::NumWorkers() const
+{
+  return workers_.size();
+}
+
+void LayoutSearchPool::Attach(unsigned worker_id, model::Engine* engine)
+{
+  auto& worker = *workers_.at(worker_id);
+  worker.engine = engine;
+  worker.context_id = 0;
+}
+
+LayoutSearchPool::MappingContext LayoutSearchPool::NewMappingContext(
+  const Mapping& mapping, problem::Workload& workload,
+  sparse::SparseOptimizationInfo* sparse_optimizations,
+  crypto::CryptoConfig* crypto, bool break_on_failure)
+{
+  MappingContext context;
+  context.id = next_context_id_++;
+  context.mapping = &mapping;
+  context.workload = &workload;
+  context.sparse_optimizations = sparse_optimizations;
+  context.crypto = crypto;
+  context.break_on_failure = break_on_failure;
+  return context;
+}
+
+void LayoutSearchPool::AttachLayoutSpace(MappingContext& context, unsigned owner,
+                                         layoutspace::Legal& layoutspace,
+                                         const model::Engine::Specs& arch_specs,
+                                         const std::vector<layoutspace::IntralineConstraint>& intraline_constraints,
+                                         bool skip_authblock)
+{
+  context.owner = owner;
+  context.owner_layoutspace = &layoutspace;
+  context.arch_specs = &arch_specs;
+  context.intraline_constraints = &intraline_constraints;
+  context.skip_authblock = skip_authblock;
+}
+
+layoutspace::Legal& LayoutSearchPool::LayoutSpace(unsigned worker_id, const MappingContext& context)
+{
+  assert(context.owner_layoutspace != nullptr);
+  if (worker_id == context.owner)
+  {
+    return *context.owner_layoutspace;
+  }
+
+  auto& worker = *workers_.at(worker_id);
+  if (worker.layoutspace_context_id != context.id)
+  {
+    worker.layout = context.owner_layoutspace->GetConcordantLayout();
+    if (!worker.layoutspace)
+    {
+      worker.layoutspace.reset(new layoutspace::Legal(*context.arch_specs, worker.layout));
+    }
+    worker.layoutspace->SetIntralineConstraints(*context.intraline_constraints);
+    worker.layoutspace->Init(*context.arch_specs, *context.mapping, worker.layout, context.skip_authblock);
+    worker.layoutspace_context_id = context.id;
+  }
+  return *worker.layoutspace;
+}
+
+void LayoutSearchPool::NotifyIdle()
+{
+  std::lock_guard<std::mutex> lock(idle_mutex_);
+  idle_cv_.notify_all();
+}
+
+std::vector<model::EvalStatus> LayoutSearchPool::Evaluate(unsigned worker_id, const MappingContext& context,
+                                                          const layout::Layouts& layout)
+{
+  auto& worker = *workers_.at(worker_id);
+  assert(worker.engine != nullptr);
+
+  if (gIncrementalLayoutEvaluation && worker.context_id == context.id && worker.engine->LayoutEvaluationReady())
+  {
+    return worker.engine->EvaluateLayout(layout, context.crypto, context.break_on_failure);
+  }
+
+  // The engine keeps pointers into the mapping for later incremental
+  // evaluations, so it evaluates this worker's own copy.
+  worker.mapping = *context.mapping;
+  worker.context_id = context.id;
+  return worker.engine->Evaluate(worker.mapping, *context.workload, layout,
+                                 context.sparse_optimizations, context.crypto, context.break_on_failure);
+}
+
+bool LayoutSearchPool::PopTask(unsigned worker_id, Task& task)
+{
+  auto& worker = *workers_[worker_id];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (worker.tasks.empty())
+  {
+    return false;
+  }
+  task = worker.tasks.front();
+  worker.tasks.pop_front();
+  queued_tasks_--;
+  return true;
+}
+
+bool LayoutSearchPool::StealTask(unsigned worker_id, Task& task)
+{
+  for (unsigned offset = 1; offset < workers_.size(); offset++)
+  {
+    auto& victim = *workers_[(worker_id + offset) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty())
+    {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      queued_tasks_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void LayoutSearchPool::Execute(unsigned worker_id, const Task& task)
+{
+  auto& job = *task.job;
+  auto& context = *job.context;
+  auto& candidate = job.candidates->at(task.index);
+
+  auto& layoutspace = LayoutSpace(worker_id, context);
+  auto construction_status = layoutspace.ConstructLayout(candidate.id.splitting, candidate.id.packing, candidate.id.auth,
+                                                         nullptr, *context.mapping, context.skip_authblock, false);
+  bool constructed = std::accumulate(construction_status.begin(), construction_status.end(), true,
+                                     [](bool cur, const layoutspace::Status& status)
+                                     { return cur && status.success; });
+  if (!constructed)
+  {
+    candidate.success = false;
+    candidate.cycles = 0;
+    candidate.energy_per_compute = 0.0;
+    candidate.actual_computes = 0;
+    if (--job.remaining == 0)
+    {
+      NotifyIdle();
+    }
+    return;
+  }
+  auto& layout = layoutspace.GetLayout();
+
+  // Evaluate with all authblock factors cleared to eliminate their effect.
+  // The factor maps are swapped out and restored afterwards, so the layout
+  // space still finds its own construction in place.
+  std::vector<std::map<std::string, std::uint32_t>> hidden_authblock_factors;
+  if (candidate.id.without_auth)
+  {
+    for (auto& level_layout : layout)
+      for (auto& authblock_nest : level_layout.authblock_lines)
+      {
+        hidden_authblock_factors.emplace_back();
+        hidden_authblock_factors.back().swap(authblock_nest.factors);
+      }
+  }
+
+  auto status_per_level = Evaluate(worker_id, context, layout);
+
+  if (candidate.id.without_auth)
+  {
+    unsigned idx = 0;
+    for (auto& level_layout : layout)
+      for (auto& authblock_nest : level_layout.authblock_lines)
+        authblock_nest.factors.swap(hidden_authblock_factors[idx++]);
+  }
+
+  auto& engine = *workers_[worker_id]->engine;
+  candidate.success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                      [](bool cur, const model::EvalStatus& status)
+                                      { return cur && status.success; });
+  candidate.cycles = engine.Cycles();
+  std::uint64_t actual_computes = engine.GetTopology().ActualComputes();
+  candidate.actual_computes = actual_computes;
+  candidate.energy_per_compute = (actual_computes > 0) ? (engine.Energy() / actual_computes) : 0.0;
+
+  if (--job.remaining == 0)
+  {
+    NotifyIdle();
+  }
+}
+
+void LayoutSearchPool::EvaluateCandidates(unsigned worker_id, const MappingContext& context,
+                                          std::vector<Candidate>& candidates)
+{
+  if (candidates.empty())
+  {
+    return;
+  }
+
+  Job job;
+  job.context = &context;
+  job.candidates = &candidates;
+  job.remaining = candidates.size();
+
+  if (!gParallelLayoutSearch || workers_.size() == 1)
+  {
+    for (std::size_t i = 0; i < candidates.size(); i++)
+    {
+      Execute(worker_id, { &job, i });
+    }
+    return;
+  }
+
+  {
+    auto& worker = *workers_.at(worker_id);
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    for (std::size_t i = 0; i < candidates.size(); i++)
+    {
+      worker.tasks.push_back({ &job, i });
+    }
+    queued_tasks_ += candidates.size();
+  }
+  NotifyIdle();
+
+  // Work on our own candidates first and help others while the rest of
+  // ours are being evaluated elsewhere. The job lives on this stack frame,
+  // so we must not return before every task has finished.
+  while (job.remaining > 0)
+  {
+    Task task;
+    if (PopTask(worker_id, task) || StealTask(worker_id, task))
+    {
+      Execute(worker_id, task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [&] { return job.remaining == 0 || queued_tasks_ > 0; });
+  }
+}
+
+int LayoutSearchPool::ReportCandidates(layoutspace::LayoutSearchAlgorithm& search,
+                                       const std::vector<Candidate>& candidates,
+                                       std::uint64_t& actual_computes)
+{
+  int best = -1;
+  for (unsigned i = 0; i < candidates.size(); i++)
+  {
+    // A candidate that failed or was cut off by the incumbent leaves
+    // partial stats behind; it is invalid and says nothing about the
+    // compute count.
+    auto& candidate = candidates[i];
+    if (candidate.success && actual_computes == 0)
+    {
+      actual_computes = candidate.actual_computes;
+    }
+    if (search.Report(candidate.id, candidate.success, candidate.cycles, candidate.energy_per_compute) &&
+        candidate.success)
+    {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void LayoutSearchPool::Retire(unsigned worker_id)
+{
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    retired_workers_++;
+    idle_cv_.notify_all();
+  }
+
+  while (retired_workers_ < workers_.size())
+  {
+    Task task;
+    if (StealTask(worker_id, task))
+    {
+      Execute(worker_id, task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [&] { return retired_workers_ == workers_.size() || queued_tasks_ > 0; });
+  }
+}
@@ -30,6 +30,7 @@
 #include <cstring>
 
 #include "applications/mapper/mapper.hpp"
+#include "applications/mapper/network-mapper.hpp"
 #include "util/banner.hpp"
 #include "util/args.hpp"
 #include "compound-config/compound-config.hpp"
@@ -60,6 +61,26 @@ void handler(int s)
   }
 }
 
+void WriteResult(const application::Mapper::Result& result, const std::string& out_prefix)
+{
+  const auto fname_to_string = std::map<std::string, const std::string&>({
+    {"stats.txt", result.stats_string},
+    {"map+stats.xml", result.xml_mapping_stats_string},
+    {"map.txt", result.mapping_string},
+    {"map.yaml", result.mapping_yaml_string},
+    {"map.cpp", result.mapping_cpp_string},
+    {"map.tensella.txt", result.tensella_string},
+    {"orojenesis.csv", result.orojenesis_string}
+  });
+
+  for (const auto& [fname_suffix, content_string] : fname_to_string)
+  {
+    std::ofstream file(out_prefix + "." + fname_suffix);
+    file << content_string;
+    file.close();
+  }
+}
+
 //--------------------------------------------//
 //                    MAIN                    //
 //--------------------------------------------//
@@ -76,7 +97,9 @@ int main(int argc, char* argv[])
 
   std::vector<std::string> input_files;
   std::string output_dir = ".";
-  bool success = ParseArgs(argc, argv, input_files, output_dir);
+  std::set<std::string> options;
+  bool success = ParseArgs(argc, argv, input_files, output_dir, { "--resume" }, options);
+  bool resume = options.count("--resume") > 0;
   if (!success)
   {
     std::cerr << "ERROR: error parsing command line." << std::endl;
@@ -91,29 +114,35 @@ int main(int argc, char* argv[])
   }
   std::cout << std::endl;
   
-  application::Mapper application(config, output_dir);
-  
-  const auto result = application.Run();
-
   // Output file names.
   std::string out_prefix = output_dir + "/" + "timeloop-mapper";
 
-  const auto fname_to_string = std::map<std::string, const std::string&>({
-    {"stats.txt", result.stats_string},
-    {"map+stats.xml", result.xml_mapping_stats_string},
-    {"map.txt", result.mapping_string},
-    {"map.yaml", result.mapping_yaml_string},
-    {"map.cpp", result.mapping_cpp_string},
-    {"map.tensella.txt", result.tensella_string},
-    {"orojenesis.csv", result.orojenesis_string}
-  });
-
-  for (const auto& [fname_suffix, content_string] : fname_to_string)
+  if (config->getRoot().exists("network"))
   {
-    std::ofstream file(out_prefix + "." + fname_suffix);
-    file << content_string;
+    // All layers of a network in one process, sharing the architecture.
+    application::NetworkMapper application(config, output_dir);
+    application.SetResume(resume);
+
+    const auto result = application.Run();
+
+    for (const auto& layer : result.layers)
+    {
+      WriteResult(layer.result, out_prefix + "." + layer.name);
+    }
+
+    std::ofstream file(out_prefix + ".network.txt");
+    file << result.summary_string;
     file.close();
+
+    return 0;
   }
 
+  application::Mapper application(config, output_dir);
+  application.SetResume(resume);
+
+  const auto result = application.Run();
+
+  WriteResult(result, out_prefix);
+
   return 0;
 }
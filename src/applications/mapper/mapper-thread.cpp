@@ -25,15 +25,28 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstring>
 #include <ncurses.h>
 
 #include "applications/mapper/mapper-thread.hpp"
 #include "layoutspaces/layoutspace.hpp"
 
-#define LESS_IMPROVEMENT_COUNTER_THRESHOLD 10
-
 bool gTerminate = false;
 
+// Evaluations stop modeling outer levels once their partial stats, which
+// bound the final ones from below, lose to the best result of any thread
+// unless this is disabled.
+bool gIncumbentLayoutCutoff =
+  (getenv("TIMELOOP_DISABLE_INCUMBENT_CUTOFF") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_INCUMBENT_CUTOFF"), "0") == 0);
+
+// Layout searches also stop expanding layouts whose auth-free estimate loses
+// to the best result of any thread if this is enabled. The estimate is not a
+// lower bound, so this may drop layouts that would have won.
+bool gLayoutEstimateCutoff =
+  (getenv("TIMELOOP_ENABLE_LAYOUT_ESTIMATE_CUTOFF") != NULL) &&
+  (strcmp(getenv("TIMELOOP_ENABLE_LAYOUT_ESTIMATE_CUTOFF"), "0") != 0);
+
 enum class Betterness
 {
   Better,
@@ -87,23 +100,29 @@ static double Cost(const model::Topology::Stats& stats, const std::string metric
   return cost;
 }
 
-static Betterness IsBetterRecursive_(const model::Topology::Stats& candidate, const model::Topology::Stats& incumbent,
-                                     const std::vector<std::string>::const_iterator metric,
-                                     const std::vector<std::string>::const_iterator end)
-{
-  const double tolerance = 0.001;
-
-  double candidate_cost = Cost(candidate, *metric);
-  double incumbent_cost = Cost(incumbent, *metric);
+static const double kBetternessTolerance = 0.001;
 
+static double RelativeImprovement(double candidate_cost, double incumbent_cost)
+{
   // Compute % improvement relative to incumbent. We need to
   // special-case cost == 0 to avoid a divide-by-zero error. Note that
   // cost == 0 is a legitimate cost for a mapping. Also note that lower
   // cost is better.
   double absolute_improvement = incumbent_cost - candidate_cost;
-  double relative_improvement = incumbent_cost == 0 ?
+  return incumbent_cost == 0 ?
     (candidate_cost == 0 ? 0 : absolute_improvement / candidate_cost) :
     absolute_improvement / incumbent_cost;
+}
+
+static Betterness IsBetterRecursive_(const model::Topology::Stats& candidate, const model::Topology::Stats& incumbent,
+                                     const std::vector<std::string>::const_iterator metric,
+                                     const std::vector<std::string>::const_iterator end)
+{
+  const double tolerance = kBetternessTolerance;
+
+  double candidate_cost = Cost(candidate, *metric);
+  double incumbent_cost = Cost(incumbent, *metric);
+  double relative_improvement = RelativeImprovement(candidate_cost, incumbent_cost);
 
   if (fabs(relative_improvement) > tolerance)
   {
@@ -183,6 +202,59 @@ bool EvaluationResult::UpdateIfEqual(const EvaluationResult& other, const std::v
   return updated;
 }
 
+//--------------------------------------------//
+//              Global Incumbent              //
+//--------------------------------------------//
+
+Incumbent::Incumbent(const std::vector<std::string>& metrics) :
+    metrics_(metrics),
+    cost_(0),
+    epoch_(0)
+{
+  assert(!metrics_.empty());
+}
+
+bool Incumbent::Offer(const EvaluationResult& result)
+{
+  if (!result.valid)
+    return false;
+
+  // A clear loss on the primary metric cannot win on the others; decide it
+  // from the scalar alone. The scalar never claims a better cost than the
+  // snapshot's, so this never rejects a winner.
+  double cost = Cost(result.stats, metrics_.front());
+  if (Epoch() > 0 && RelativeImprovement(cost, cost_.load(std::memory_order_acquire)) < -kBetternessTolerance)
+    return false;
+
+  auto current = std::atomic_load(&result_);
+  std::shared_ptr<const EvaluationResult> published;
+  while (!current || IsBetter(result.stats, current->stats, metrics_))
+  {
+    if (!published)
+      published = std::make_shared<const EvaluationResult>(result);
+    if (std::atomic_compare_exchange_weak(&result_, &current, published))
+    {
+      cost_.store(cost, std::memory_order_release);
+      epoch_.fetch_add(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<const EvaluationResult> Incumbent::Get() const
+{
+  return std::atomic_load(&result_);
+}
+
+bool Incumbent::Dominates(const model::Topology::Stats& lower_bound) const
+{
+  auto& metric = metrics_.front();
+  if (Epoch() == 0 || (metric != "delay" && metric != "energy" && metric != "edp"))
+    return false;
+  return RelativeImprovement(Cost(lower_bound, metric), cost_.load(std::memory_order_acquire)) < -kBetternessTolerance;
+}
+
 //--------------------------------------------//
 //              Failure Tracking              //
 //--------------------------------------------//
@@ -274,6 +346,7 @@ MapperThread::MapperThread(
   search::SearchAlgorithm* search,
   mapspace::MapSpace* mapspace,
   std::mutex* mutex,
+  LayoutSearchPool* layout_search_pool,
   uint128_t search_size,
   std::uint32_t timeout,
   std::uint32_t victory_condition,
@@ -297,14 +370,17 @@ MapperThread::MapperThread(
   problem::Workload &workload,
   layout::Layouts layout,
   bool layout_initialized,
+  layoutspace::LayoutSearchAlgorithm* layout_search,
+  const std::vector<layoutspace::IntralineConstraint>& layout_constraints,
   sparse::SparseOptimizationInfo* sparse_optimizations,
   crypto::CryptoConfig* crypto,
-  EvaluationResult* best
+  Incumbent* incumbent
   ):
     thread_id_(thread_id),
     search_(search),
     mapspace_(mapspace),
     mutex_(mutex),
+    layout_search_pool_(layout_search_pool),
     search_size_(search_size),
     timeout_(timeout),
     victory_condition_(victory_condition),
@@ -328,11 +404,17 @@ MapperThread::MapperThread(
     workload_(workload),
     layout_(layout),
     layout_initialized_(layout_initialized),
+    layout_search_(layout_search),
+    layout_constraints_(layout_constraints),
     sparse_optimizations_(sparse_optimizations),
     crypto_(crypto),
-    best_(best),
+    incumbent_(incumbent),
     thread_(),
-    stats_()
+    stats_(),
+    checkpoint_request_(nullptr),
+    checkpoint_epoch_(0),
+    finished_(false),
+    resume_from_(nullptr)
 {
 }
 
@@ -352,6 +434,153 @@ const MapperThread::Stats& MapperThread::GetStats() const
   return stats_;
 }
 
+void MapperThread::EnableCheckpoints(const std::atomic<std::uint64_t>* request)
+{
+  checkpoint_request_ = request;
+}
+
+ThreadCheckpoint MapperThread::GetCheckpoint()
+{
+  std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+  return checkpoint_;
+}
+
+void MapperThread::ResumeFrom(const ThreadCheckpoint* checkpoint)
+{
+  resume_from_ = checkpoint;
+}
+
+// Mapping IDs are relative to the pruned sub-space of their index
+// factorization, which is the least significant digit of the ID.
+bool MapperThread::RebuildMapping(uint128_t id, Mapping& mapping, bool break_on_failure)
+{
+  auto if_size = mapspace_->Size(mapspace::Dimension::IndexFactorization);
+  if (if_size == 0)
+  {
+    return false;
+  }
+  mapspace_->InitPruned(id % if_size);
+
+  mapspace::ID mapping_id(mapspace_->AllSizes());
+  if (id >= mapping_id.EndInteger())
+  {
+    return false;
+  }
+  mapping_id.Set(id);
+
+  auto construction_status = mapspace_->ConstructMapping(mapping_id, &mapping, break_on_failure);
+  return std::accumulate(construction_status.begin(), construction_status.end(), true,
+                         [](bool cur, const mapspace::Status& status)
+                         { return cur && status.success; });
+}
+
+// Called at a mapping boundary with the counters of Run() filled in.
+void MapperThread::PublishCheckpoint(ThreadCheckpoint& checkpoint, std::uint64_t epoch, bool final)
+{
+  std::ostringstream search_state;
+  checkpoint.resumable = search_->SaveState(search_state);
+  checkpoint.search_state = search_state.str();
+
+  std::ostringstream generator_state;
+  generator_state << stats_.generator;
+  checkpoint.generator_state = generator_state.str();
+
+  checkpoint.best_valid = own_best_.valid;
+  checkpoint.best_nests.clear();
+  if (own_best_.valid)
+  {
+    checkpoint.best_mapping_id = own_best_.mapping.id;
+    for (auto& level : own_best_.layout)
+    {
+      checkpoint.best_nests.push_back(level.interline);
+      checkpoint.best_nests.push_back(level.intraline);
+      checkpoint.best_nests.push_back(level.authblock_lines);
+    }
+  }
+
+  checkpoint.fails.clear();
+  for (auto& [fail_class, fail_bucket] : stats_.fail_stats)
+  {
+    for (auto& [level, fail_info] : fail_bucket)
+    {
+      checkpoint.fails.push_back({ unsigned(fail_class), level, fail_info.count,
+                                   fail_info.reason, fail_info.mapping.id });
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    checkpoint_ = std::move(checkpoint);
+  }
+  checkpoint_epoch_.store(epoch, std::memory_order_release);
+  if (final)
+  {
+    finished_.store(true, std::memory_order_release);
+  }
+}
+
+// Restores the best mapping and the fail stats (rebuilding and re-evaluating
+// their mappings), then the search itself, which re-initializes the mapspace
+// to where it left off.
+void MapperThread::Resume(const ThreadCheckpoint& checkpoint, model::Engine& engine)
+{
+  std::istringstream generator_state(checkpoint.generator_state);
+  generator_state >> stats_.generator;
+
+  for (auto& fail : checkpoint.fails)
+  {
+    FailInfo fail_info;
+    fail_info.count = fail.count;
+    fail_info.reason = fail.reason;
+    fail_info.mapping = Mapping(&workload_);
+    RebuildMapping(fail.mapping_id, fail_info.mapping, false);
+    stats_.fail_stats[FailClass(fail.fail_class)][fail.level] = fail_info;
+  }
+
+  if (checkpoint.best_valid && checkpoint.best_nests.size() == 3 * layout_.size())
+  {
+    layout::Layouts best_layout = layout_;
+    for (unsigned lvl = 0; lvl < best_layout.size(); lvl++)
+    {
+      best_layout[lvl].interline = checkpoint.best_nests[3*lvl];
+      best_layout[lvl].intraline = checkpoint.best_nests[3*lvl+1];
+      best_layout[lvl].authblock_lines = checkpoint.best_nests[3*lvl+2];
+    }
+
+    Mapping mapping(&workload_);
+    bool success = RebuildMapping(checkpoint.best_mapping_id, mapping, true);
+    if (success)
+    {
+      auto status_per_level = engine.Evaluate(mapping, workload_, best_layout, sparse_optimizations_, crypto_);
+      success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                [](bool cur, const model::EvalStatus& status)
+                                { return cur && status.success; });
+    }
+    if (success)
+    {
+      EvaluationResult result = { true, mapping, engine.GetTopology().GetStats(), best_layout };
+      stats_.thread_best = result;
+      own_best_ = result;
+      incumbent_->Offer(result);
+    }
+    else
+    {
+      mutex_->lock();
+      log_stream_ << "[" << std::setw(3) << thread_id_ << "] WARNING: "
+                  << "cannot re-evaluate the best mapping of the checkpoint." << std::endl;
+      mutex_->unlock();
+    }
+  }
+
+  std::istringstream search_state(checkpoint.search_state);
+  if (!search_->LoadState(search_state))
+  {
+    std::cerr << "ERROR: cannot restore the search state of thread " << thread_id_
+              << " from the checkpoint; remove it to start from scratch." << std::endl;
+    exit(1);
+  }
+}
+
 void MapperThread::Run()
 {
   uint128_t total_mappings = 0;
@@ -359,15 +588,53 @@ void MapperThread::Run()
   uint128_t invalid_mappings_mapcnstr = 0;
   uint128_t invalid_mappings_eval = 0;
   std::uint32_t mappings_since_last_best_update = 0;
+  std::uint64_t synced_epoch = 0;
 
   const int ncurses_line_offset = 6;
 
   std::vector<EvaluationResult> index_factor_best_vec;
   model::Engine engine;
   engine.Spec(arch_specs_);
+  layout_search_pool_->Attach(thread_id_, &engine);
+
+  if (resume_from_ != nullptr && resume_from_->resumable)
+  {
+    Resume(*resume_from_, engine);
+    total_mappings = resume_from_->total_mappings;
+    valid_mappings = resume_from_->valid_mappings;
+    invalid_mappings_mapcnstr = resume_from_->invalid_mappings_mapcnstr;
+    invalid_mappings_eval = resume_from_->invalid_mappings_eval;
+    mappings_since_last_best_update = resume_from_->mappings_since_last_best_update;
+  }
+
+  // Mappings (and layouts) whose partial evaluation already loses to the
+  // incumbent are abandoned before their outer levels are modeled. Logging
+  // and diagnostics need full stats for every mapping, so they keep the
+  // complete evaluation.
+  if (gIncumbentLayoutCutoff && !diagnostics_on_ && !log_all_mappings_ &&
+      !log_orojenesis_mappings_ && !log_suboptimal_)
+  {
+    engine.SetCutoff([this](const model::Topology::Stats& lower_bound)
+                     { return incumbent_->Dominates(lower_bound); });
+  }
+
+  // The layout space is rebuilt for every mapping, reusing its tables.
+  layoutspace::Legal layoutspace(arch_specs_, layout_);
+  layoutspace.SetIntralineConstraints(layout_constraints_);
 
   mapspace::ID prev_mapping_id;
 
+  auto publish_checkpoint = [&](bool final)
+  {
+    ThreadCheckpoint checkpoint;
+    checkpoint.total_mappings = total_mappings;
+    checkpoint.valid_mappings = valid_mappings;
+    checkpoint.invalid_mappings_mapcnstr = invalid_mappings_mapcnstr;
+    checkpoint.invalid_mappings_eval = invalid_mappings_eval;
+    checkpoint.mappings_since_last_best_update = mappings_since_last_best_update;
+    PublishCheckpoint(checkpoint, checkpoint_request_->load(std::memory_order_acquire), final);
+  };
+
   // =================
   // Main mapper loop -- search mapping
   // =================
@@ -443,6 +710,13 @@ void MapperThread::Run()
       terminate = true;
     }
 
+    // Publish the search state while it sits between two mappings.
+    if (checkpoint_request_ != nullptr &&
+        (terminate || checkpoint_request_->load(std::memory_order_acquire) > CheckpointEpoch()))
+    {
+      publish_checkpoint(terminate);
+    }
+
     // Try to obtain the next mapping from the search algorithm.
     mapspace::ID mapping_id;
     if (!search_->Next(mapping_id))
@@ -500,25 +774,19 @@ void MapperThread::Run()
     //
     if (total_mappings != 0 && sync_interval_ > 0 && total_mappings % sync_interval_ == 0)
     {
-      mutex_->lock();
-
-      // Sync from global best to thread_best.
-      bool global_pulled = false;
-      if (best_->valid)
+      // Sync from global best to thread_best. The thread_best is published
+      // as soon as it improves, so only the pull is left; it copies the
+      // global best only if something was published since the last sync.
+      auto epoch = incumbent_->Epoch();
+      if (epoch != synced_epoch)
       {
-        if (stats_.thread_best.UpdateIfBetter(*best_, optimization_metrics_))
+        synced_epoch = epoch;
+        auto global_best = incumbent_->Get();
+        if (global_best)
         {
-          global_pulled = true;
+          stats_.thread_best.UpdateIfBetter(*global_best, optimization_metrics_);
         }
       }
-
-      // Sync from thread_best to global best.
-      if (stats_.thread_best.valid && !global_pulled)
-      {
-        best_->UpdateIfBetter(stats_.thread_best, optimization_metrics_);
-      }
-
-      mutex_->unlock();
     }
 
     //
@@ -623,7 +891,6 @@ void MapperThread::Run()
                                { return cur && status.success; });
     }else{
       // When layout is not initialized, just using bandwidth layout to search the mapping first.
-      layoutspace_ = new layoutspace::Legal(arch_specs_, mapping, layout_);
 
       // --- Add AuthBlock nest with dummy values for DRAM and MainMemory ---
       bool skip_authblock = (crypto_ == nullptr);
@@ -647,214 +914,100 @@ void MapperThread::Run()
         }
       }
 
-      layoutspace_->Init(arch_specs_, mapping, layout_, (crypto_ == nullptr)); // need the layout for architecture information.
-      auto concordant_layout = layoutspace_->GetLayout();
-      // Initialize global optimal tracking variables
-      std::uint64_t mapping_specific_best_latency = UINT64_MAX;
-      double mapping_specific_best_energy_per_compute = std::numeric_limits<double>::max();
-      layout::Layouts mapping_specific_best_layout;
-      bool has_valid_layout = false;
-      
-      // Track best IDs for each design space
-      uint64_t local_best_layout_splitting_id = 0;
-      uint64_t local_best_layout_packing_id = 0;
-      // Phase 1: Search SplittingSpace (with cleared authblock_lines and default PackingSpace=0)
-      for (uint64_t layout_splitting_id = 0; layout_splitting_id < layoutspace_->splitting_candidates; layout_splitting_id++)
-      {
-        auto construction_status = layoutspace_->ConstructLayout(layout_splitting_id, 0, 0, &layout_, mapping, skip_authblock, false);
-        bool layout_success = std::accumulate(construction_status.begin(), construction_status.end(), true,
-                                    [](bool cur, const layoutspace::Status& status)
-                                    { return cur && status.success; });
-        if(!layout_success) {
-          continue;
-        }
-
-        layout::Layouts layout_no_auth = layout::Layouts(layout_);
-        for (unsigned lvl = 0; lvl < layout_no_auth.size(); lvl++) {
-          for (unsigned ds_idx = 0; ds_idx < layout_no_auth[lvl].authblock_lines.size(); ds_idx++) {
-            // Clear all authblock factors to eliminate their effect
-            layout_no_auth[lvl].authblock_lines[ds_idx].factors.clear();
-          }
-        }
+      layoutspace.Init(arch_specs_, mapping, layout_, (crypto_ == nullptr)); // need the layout for architecture information.
 
-        auto status_per_level = engine.Evaluate(mapping, workload_, layout_no_auth, sparse_optimizations_, crypto_, !diagnostics_on_);
-
-        // Extract run-time latency and energy efficiency from evaluation results
-        std::uint64_t runtime_latency = engine.Cycles();
-        double total_energy = engine.Energy();
-        std::uint64_t actual_computes = engine.GetTopology().ActualComputes();
-        double energy_per_compute = (actual_computes > 0) ? (total_energy / actual_computes) : 0.0;
-
-        // Track optimal values (prefer smaller values)
-        bool is_better = false;
-        std::string improvement_reason = "";
-
-        if (!has_valid_layout) {
-          // First valid layout
-          is_better = true;
-          improvement_reason = "SplittingSpace: first valid layout";
-        }
-        else if (runtime_latency < mapping_specific_best_latency) {
-          // Better latency
-          is_better = true;
-          improvement_reason = "SplittingSpace: better latency";
-        }
-        else if (runtime_latency == mapping_specific_best_latency && energy_per_compute < mapping_specific_best_energy_per_compute) {
-          // Same latency but better energy efficiency
-          is_better = true;
-          improvement_reason = "SplittingSpace: same latency, better energy efficiency";
-        }
+      // Candidates are built and evaluated by the layout search pool,
+      // possibly on other mapper threads. Results are reported to the
+      // layout search algorithm in the order the candidates were issued, so
+      // the outcome does not depend on scheduling.
+      auto layout_context = layout_search_pool_->NewMappingContext(mapping, workload_, sparse_optimizations_, crypto_, !diagnostics_on_);
+      LayoutSearchPool::AttachLayoutSpace(layout_context, thread_id_, layoutspace, arch_specs_, layout_constraints_, skip_authblock);
+      auto evaluate_layout = [&](const layout::Layouts& candidate)
+      {
+        return layout_search_pool_->Evaluate(thread_id_, layout_context, candidate);
+      };
+      const std::size_t num_workers = layout_search_pool_->NumWorkers();
+      std::vector<LayoutSearchPool::Candidate> candidates;
 
-        if (is_better) {
-          mapping_specific_best_latency = runtime_latency;
-          mapping_specific_best_energy_per_compute = energy_per_compute;
-          mapping_specific_best_layout = layout_; // Store the layout with cleared authblock_lines
-          local_best_layout_splitting_id = layout_splitting_id;
-          has_valid_layout = true;
-        }
-      }
+      layoutspace::LayoutID best_layout_id;
+      bool has_valid_layout = false;
 
-      // Phase 2: Search PackingSpace (with best SplittingSpace and default AuthSpace=0)
-      // Note: authblock_lines clearing from Phase 1 does not affect this phase as layout is reconstructed
-      if (layoutspace_->packing_candidates > 1) {
-        uint64_t visited_candidate_counter = 0;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<uint64_t> dist(0, layoutspace_->packing_candidates - 1);
-        for (uint64_t i = 0; i < layoutspace_->packing_candidates; i++)
+      // Layout estimates are (cycles, energy per compute); the compute count
+      // does not depend on the layout, so it is taken from the first
+      // successfully evaluated candidate to turn an estimate into energy.
+      std::uint64_t actual_computes = 0;
+      layout_search_->SetCutoff(!gIncumbentLayoutCutoff || !gLayoutEstimateCutoff ? layoutspace::LayoutCutoff() :
+        [&](std::uint64_t cycles, double energy_per_compute)
         {
-          uint64_t layout_packing_id = dist(gen);
-          auto construction_status = layoutspace_->ConstructLayout(local_best_layout_splitting_id, layout_packing_id, 0,  &layout_, mapping, skip_authblock, false);
-          bool layout_success = std::accumulate(construction_status.begin(), construction_status.end(), true,
-                                      [](bool cur, const layoutspace::Status& status)
-                                      { return cur && status.success; });
-          if(!layout_success) {
-            continue;
-          }
-
-          layout::Layouts layout_no_auth = layout::Layouts(layout_);
-          for (unsigned lvl = 0; lvl < layout_no_auth.size(); lvl++) {
-            for (unsigned ds_idx = 0; ds_idx < layout_no_auth[lvl].authblock_lines.size(); ds_idx++) {
-              // Clear all authblock factors to eliminate their effect
-              layout_no_auth[lvl].authblock_lines[ds_idx].factors.clear();
-            }
-          }
-
-          auto status_per_level = engine.Evaluate(mapping, workload_, layout_no_auth, sparse_optimizations_, crypto_, !diagnostics_on_);
-
-          // Extract run-time latency and energy efficiency from evaluation results
-          std::uint64_t runtime_latency = engine.Cycles();
-          double total_energy = engine.Energy();
-          std::uint64_t actual_computes = engine.GetTopology().ActualComputes();
-          double energy_per_compute = (actual_computes > 0) ? (total_energy / actual_computes) : 0.0;
-
-          // Check if better than current best
-          bool is_better = false;
-          std::string improvement_reason = "";
-
-          if (runtime_latency < mapping_specific_best_latency) {
-            is_better = true;
-            improvement_reason = "PackingSpace: better latency";
-          }
-          else if (runtime_latency == mapping_specific_best_latency && energy_per_compute < mapping_specific_best_energy_per_compute) {
-            is_better = true;
-            improvement_reason = "PackingSpace: same latency, better energy efficiency";
-          }
-
-          if (is_better) {
-            visited_candidate_counter = 0;
-            mapping_specific_best_latency = runtime_latency;
-            mapping_specific_best_energy_per_compute = energy_per_compute;
-            mapping_specific_best_layout = layout_;
-            local_best_layout_packing_id = layout_packing_id;
-            has_valid_layout = true;
-          }
-
-          if (visited_candidate_counter > std::min(std::max(victory_condition_, (uint32_t)1), (uint32_t)50)) {
-            break;
-          }
-          visited_candidate_counter++;
-        }
-      }
-
-      // Phase 3: Search AuthSpace (with best SplittingSpace and best PackingSpace)
-      // Note: authblock_lines are fully functional in this phase
-      uint64_t layout_auth_id = 0;
-      if (crypto_ != nullptr && layoutspace_->authblock_candidates > 1) {
-        mapping_specific_best_latency = UINT64_MAX;
-        mapping_specific_best_energy_per_compute = std::numeric_limits<double>::max();
-        uint32_t less_improvement_counter = 0;
-        uint64_t visited_candidate_counter = 0;
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<uint64_t> dist(0, layoutspace_->authblock_candidates - 1);
-        for (uint64_t i = 0; i < layoutspace_->authblock_candidates; i++)
+          if (actual_computes == 0)
+            return false;
+          model::Topology::Stats estimate;
+          estimate.Reset();
+          estimate.cycles = cycles;
+          estimate.energy = energy_per_compute * actual_computes;
+          return incumbent_->Dominates(estimate);
+        });
+
+      layout_search_->Init(layoutspace, crypto_ != nullptr);
+      while (true)
+      {
+        candidates.clear();
+        layoutspace::LayoutID layout_id;
+        while (candidates.size() < num_workers && layout_search_->Next(layout_id))
         {
-          layout_auth_id = dist(gen);
-          auto construction_status = layoutspace_->ConstructLayout(local_best_layout_splitting_id, local_best_layout_packing_id, layout_auth_id, &layout_, mapping, skip_authblock, false);
-          bool layout_success = std::accumulate(construction_status.begin(), construction_status.end(), true,
-                                      [](bool cur, const layoutspace::Status& status)
-                                      { return cur && status.success; });
-          if(!layout_success) {
-            continue;
-          }
-
-          auto status_per_level = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, crypto_, !diagnostics_on_);
-
-          // Extract run-time latency and energy efficiency from evaluation results
-          std::uint64_t runtime_latency = engine.Cycles();
-          double total_energy = engine.Energy();
-          std::uint64_t actual_computes = engine.GetTopology().ActualComputes();
-          double energy_per_compute = (actual_computes > 0) ? (total_energy / actual_computes) : 0.0;
-
-          // Check if better than current best
-          bool is_better = false;
-          std::string improvement_reason = "";
-
-          if (runtime_latency < mapping_specific_best_latency) {
-            is_better = true;
-            improvement_reason = "AuthSpace: better latency";
-            less_improvement_counter = 0;
-          }
-          else if (runtime_latency == mapping_specific_best_latency && energy_per_compute < mapping_specific_best_energy_per_compute) {
-            is_better = true;
-            improvement_reason = "AuthSpace: same latency, better energy efficiency";
-            if ((mapping_specific_best_energy_per_compute - energy_per_compute) < 0.1) {
-              less_improvement_counter++;
-            }
-          }
+          candidates.emplace_back();
+          candidates.back().id = layout_id;
+        }
+        if (candidates.empty()) {
+          break;
+        }
 
-          if (is_better) {
-            visited_candidate_counter = 0;
-            mapping_specific_best_latency = runtime_latency;
-            mapping_specific_best_energy_per_compute = energy_per_compute;
-            mapping_specific_best_layout = layout_;
-          }
+        layout_search_pool_->EvaluateCandidates(thread_id_, layout_context, candidates);
 
-          if (less_improvement_counter > LESS_IMPROVEMENT_COUNTER_THRESHOLD || visited_candidate_counter > std::min(std::max(victory_condition_, (uint32_t)1), (uint32_t)100)) {
-            break;
-          }
-          visited_candidate_counter++;
+        int best = LayoutSearchPool::ReportCandidates(*layout_search_, candidates, actual_computes);
+        if (best >= 0) {
+          best_layout_id = candidates[best].id;
+          has_valid_layout = true;
         }
       }
 
       // Update the best result with the optimal layout
       if (has_valid_layout) {
-        // Update the thread best with the optimal layout and re-evaluate to get final stats
-        layout_ = mapping_specific_best_layout;
-        status_per_level = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, crypto_, !diagnostics_on_);
+        // Rebuild the optimal layout (with intact authblock_lines) and
+        // re-evaluate it to get final stats
+        layoutspace.ConstructLayout(best_layout_id.splitting, best_layout_id.packing, best_layout_id.auth,
+                                    &layout_, mapping, skip_authblock, false);
+        status_per_level = evaluate_layout(layout_);
         success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                  [](bool cur, const model::EvalStatus& status)
                                  { return cur && status.success; });
 
       } else {
-        layoutspace_->SequentialFactorizeLayout(concordant_layout);
-        status_per_level = engine.Evaluate(mapping, workload_, concordant_layout, sparse_optimizations_, crypto_, !diagnostics_on_);
+        auto concordant_layout = layoutspace.GetConcordantLayout();
+        layoutspace.SequentialFactorizeLayout(concordant_layout);
+        status_per_level = evaluate_layout(concordant_layout);
         success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                  [](bool cur, const model::EvalStatus& status)
                                  { return cur && status.success; });
       }
+      // The mapping is rebuilt for the next iteration.
+      layoutspace.Unbind();
+    }
+
+    if (!success && engine.GetTopology().IsCutOff())
+    {
+      // The mapping fit, but its partial cost already ruled it out against
+      // the incumbent. It never finished evaluating, so it is not counted as
+      // a valid mapping and the search gets no cost for it: the partial cost
+      // is only a lower bound.
+      invalid_mappings_mapcnstr = 0;
+      invalid_mappings_eval = 0;
+      search_->Report(search::Status::CutOff);
+      if (penalize_consecutive_bypass_fails_ || !only_bypass_changed)
+      {
+        mappings_since_last_best_update++;
+      }
+      continue;
     }
 
     if (!success)
@@ -973,6 +1126,9 @@ void MapperThread::Run()
     // Is the new mapping "better" than the previous best mapping?
     if (stats_.thread_best.UpdateIfBetter(result, optimization_metrics_))
     {
+      own_best_ = stats_.thread_best;
+      incumbent_->Offer(stats_.thread_best);
+
       if (log_stats_)
       {
         // FIXME: improvement only captures the primary stat.
@@ -1022,4 +1178,14 @@ void MapperThread::Run()
       }
     }
   } // while ()
+
+  // A search that ran out of mappings only terminates after Next(), so its
+  // final state has not been published yet.
+  if (checkpoint_request_ != nullptr && !IsFinished())
+  {
+    publish_checkpoint(true);
+  }
+
+  // Help evaluate the layout candidates of threads that are still searching.
+  layout_search_pool_->Retire(thread_id_);
 }
\ No newline at end of file
@@ -25,12 +25,19 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <thread>
 #include <mutex>
 #include <iomanip>
 #include <ncurses.h>
 
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/string.hpp>
+
 #include "util/accelergy_interface.hpp"
 
 #include "applications/mapper/mapper.hpp"
@@ -38,6 +45,8 @@
 #include "layoutspaces/layoutspace.hpp"
 #include "crypto/crypto.hpp"
 
+extern bool gTerminate;
+
 //--------------------------------------------//
 //                Application                 //
 //--------------------------------------------//
@@ -45,6 +54,29 @@
 namespace application
 {
 
+// What a result cache entry holds: the output strings, the cost of the best
+// mapping and the nests of its layout. The mapping itself is only kept in its
+// formatted (output string) form.
+struct CachedRun
+{
+  bool valid = false;
+  std::uint64_t cycles = 0;
+  double energy = 0;
+  std::vector<std::string> outputs;
+  std::vector<std::vector<layout::LayoutNest>> nests; // per level: interline, intraline, authblock_lines
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    (void) version;
+    ar& valid;
+    ar& cycles;
+    ar& energy;
+    ar& outputs;
+    ar& nests;
+  }
+};
+
 template <class Archive>
 void Mapper::serialize(Archive& ar, const unsigned int version)
 {
@@ -57,6 +89,15 @@ void Mapper::serialize(Archive& ar, const unsigned int version)
 Mapper::Mapper(config::CompoundConfig* config,
               std::string output_dir,
               std::string name) :
+    Mapper(config, config->getRoot().lookup("problem"), nullptr, output_dir, name)
+{
+}
+
+Mapper::Mapper(config::CompoundConfig* config,
+               config::CompoundConfigNode problem,
+               const model::Engine::Specs* arch_specs,
+               std::string output_dir,
+               std::string name) :
     name_(name)
 {
   auto rootNode = config->getRoot();
@@ -73,7 +114,6 @@ Mapper::Mapper(config::CompoundConfig* config,
   }
 
   // Problem configuration.
-  auto problem = rootNode.lookup("problem");
   problem::ParseWorkload(problem, workload_);
   std::cout << "Problem configuration complete." << std::endl;
   std::cout << "Print out overall CoefficientIDToName of the given problem" << std::endl;
@@ -132,54 +172,25 @@ Mapper::Mapper(config::CompoundConfig* config,
   // Mapper (this application) configuration.
   auto mapper = rootNode.lookup("mapper");
   std::string semi_qualified_prefix = name;
-  mapper.lookupValue("out_prefix", semi_qualified_prefix);
+  if (!arch_specs)
+  {
+    // Callers sharing a parsed architecture across problems name each problem's outputs.
+    mapper.lookupValue("out_prefix", semi_qualified_prefix);
+  }
   out_prefix_ = output_dir + "/" + semi_qualified_prefix;
 
   // Architecture configuration.
-  config::CompoundConfigNode arch;
-  if (rootNode.exists("arch"))
-  {
-    arch = rootNode.lookup("arch");
-  }
-  else if (rootNode.exists("architecture"))
-  {
-    arch = rootNode.lookup("architecture");
-  }
+  config::CompoundConfigNode arch = ArchitectureNode(config);
 
   bool is_sparse_topology = rootNode.exists("sparse_optimizations");
-  arch_specs_ = model::Engine::ParseSpecs(arch, is_sparse_topology);
-
-  if (rootNode.exists("ERT"))
+  if (arch_specs)
   {
-    auto ert = rootNode.lookup("ERT");
-    std::cout << "Found Accelergy ERT (energy reference table), replacing internal energy model." << std::endl;
-    arch_specs_.topology.ParseAccelergyERT(ert);
-    if (rootNode.exists("ART")){ // Nellie: well, if the users have the version of Accelergy that generates ART
-      auto art = rootNode.lookup("ART");
-      std::cout << "Found Accelergy ART (area reference table), replacing internal area model." << std::endl;
-      arch_specs_.topology.ParseAccelergyART(art);
-    }
+    // Already parsed (and ERT/ART applied) by the caller, e.g. once per network.
+    arch_specs_ = *arch_specs;
   }
   else
   {
-#ifdef USE_ACCELERGY
-    // Call accelergy ERT with all input files
-    if (arch.exists("subtree") || arch.exists("local"))
-    {
-      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
-      std::string ertPath = out_prefix_ + ".ERT.yaml";
-      auto ertConfig = new config::CompoundConfig(ertPath.c_str());
-      auto ert = ertConfig->getRoot().lookup("ERT");
-      std::cout << "Generate Accelergy ERT (energy reference table) to replace internal energy model." << std::endl;
-      arch_specs_.topology.ParseAccelergyERT(ert);
-
-      std::string artPath = out_prefix_ + ".ART.yaml";
-      auto artConfig = new config::CompoundConfig(artPath.c_str());
-      auto art = artConfig->getRoot().lookup("ART");
-      std::cout << "Generate Accelergy ART (area reference table) to replace internal area model." << std::endl;
-      arch_specs_.topology.ParseAccelergyART(art);
-    }
-#endif
+    arch_specs_ = ParseArchitecture(config, output_dir, semi_qualified_prefix);
   }
 
   std::cout << "Architecture configuration complete." << std::endl;
@@ -306,6 +317,51 @@ Mapper::Mapper(config::CompoundConfig* config,
   emit_whoop_nest_ = false;
   mapper.lookupValue("emit_whoop_nest", emit_whoop_nest_);
 
+  // Everything that determines the search outcome. Keys both the result
+  // cache and checkpoints.
+  if (!config->hasLConfig())
+  {
+    cache_key_ = "problem=" + ResultCache::CanonicalText(problem.getYNode()) +
+                 "\nmapper=" + ResultCache::CanonicalText(mapper.getYNode(), {"out_prefix", "live_status", "result_cache",
+                                                                              "checkpoint_interval"}) +
+                 "\nthreads=" + std::to_string(num_threads_) +
+                 "\nconfig=" + ResultCache::CanonicalText(rootNode.getYNode(), {"problem", "mapper", "network"});
+  }
+
+  // Result cache.
+  result_cache_ = nullptr;
+  std::string result_cache_dir;
+  if (mapper.lookupValue("result_cache", result_cache_dir))
+  {
+    if (config->hasLConfig())
+    {
+      std::cerr << "WARNING: result_cache needs a YAML configuration, caching is disabled." << std::endl;
+    }
+    else
+    {
+      result_cache_ = new ResultCache(result_cache_dir);
+      std::cout << "Using result cache " << result_cache_dir << std::endl;
+    }
+  }
+
+  // Seconds between checkpoints of the search state (0 disables them).
+  checkpoint_interval_ = 0;
+  mapper.lookupValue("checkpoint_interval", checkpoint_interval_);
+
+  // Share index factorizations between threads at run time instead of
+  // statically splitting the mapspace. Threads claim dynamic_split_chunk
+  // of them at a time and steal from each other once none are left.
+  bool dynamic_split = false;
+  mapper.lookupValue("dynamic_split", dynamic_split);
+  unsigned dynamic_split_chunk = 4;
+  mapper.lookupValue("dynamic_split_chunk", dynamic_split_chunk);
+  if (dynamic_split && !search::UsesWorkPool(mapper))
+  {
+    std::cerr << "WARNING: dynamic_split is only supported by the hybrid, random_pruned "
+              << "and linear_pruned search algorithms, splitting statically." << std::endl;
+    dynamic_split = false;
+  }
+
   std::cout << "Mapper configuration complete." << std::endl;
 
   // MapSpace configuration.
@@ -343,7 +399,22 @@ Mapper::Mapper(config::CompoundConfig* config,
 
   bool filter_spatial_fanout = sparse_optimizations_->action_spatial_skipping_info.size() == 0;
   mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_, filter_spatial_fanout);
-  split_mapspaces_ = mapspace_->Split(num_threads_);
+  work_pool_ = nullptr;
+  if (dynamic_split)
+  {
+    // linear_pruned keeps its linear order; the others sample the space.
+    std::string search_alg = "hybrid";
+    mapper.lookupValue("algorithm", search_alg);
+    split_mapspaces_ = mapspace_->Replicate(num_threads_);
+    work_pool_ = new search::WorkPool(mapspace_->Size(mapspace::Dimension::IndexFactorization),
+                                      num_threads_, dynamic_split_chunk, search_alg != "linear_pruned");
+    std::cout << "Mapspace shared dynamically between " << num_threads_ << " threads, "
+              << dynamic_split_chunk << " index factorizations per claim." << std::endl;
+  }
+  else
+  {
+    split_mapspaces_ = mapspace_->Split(num_threads_);
+  }
 
   std::cout << "Mapspace construction complete." << std::endl;
 
@@ -351,7 +422,8 @@ Mapper::Mapper(config::CompoundConfig* config,
   auto search = rootNode.lookup("mapper");
   for (unsigned t = 0; t < num_threads_; t++)
   {
-    search_.push_back(search::ParseAndConstruct(search, split_mapspaces_.at(t), t));
+    search_.push_back(search::ParseAndConstruct(search, split_mapspaces_.at(t), t, work_pool_));
+    layout_search_.push_back(layoutspace::ParseAndConstructSearch(search, victory_condition_));
   }
   std::cout << "Search configuration complete." << std::endl;
   // Store the complete configuration in a string.
@@ -425,6 +497,71 @@ Mapper::Mapper(config::CompoundConfig* config,
   }
 }
 
+config::CompoundConfigNode Mapper::ArchitectureNode(config::CompoundConfig* config)
+{
+  auto rootNode = config->getRoot();
+  config::CompoundConfigNode arch;
+  if (rootNode.exists("arch"))
+  {
+    arch = rootNode.lookup("arch");
+  }
+  else if (rootNode.exists("architecture"))
+  {
+    arch = rootNode.lookup("architecture");
+  }
+  return arch;
+}
+
+model::Engine::Specs Mapper::ParseArchitecture(config::CompoundConfig* config,
+                                               std::string output_dir,
+                                               std::string semi_qualified_prefix)
+{
+  auto rootNode = config->getRoot();
+  auto arch = ArchitectureNode(config);
+
+  bool is_sparse_topology = rootNode.exists("sparse_optimizations");
+  auto arch_specs = model::Engine::ParseSpecs(arch, is_sparse_topology);
+
+  if (rootNode.exists("ERT"))
+  {
+    auto ert = rootNode.lookup("ERT");
+    std::cout << "Found Accelergy ERT (energy reference table), replacing internal energy model." << std::endl;
+    arch_specs.topology.ParseAccelergyERT(ert);
+    if (rootNode.exists("ART")){ // Nellie: well, if the users have the version of Accelergy that generates ART
+      auto art = rootNode.lookup("ART");
+      std::cout << "Found Accelergy ART (area reference table), replacing internal area model." << std::endl;
+      arch_specs.topology.ParseAccelergyART(art);
+    }
+  }
+  else
+  {
+#ifdef USE_ACCELERGY
+    // Call accelergy ERT with all input files
+    if (arch.exists("subtree") || arch.exists("local"))
+    {
+      std::string out_prefix = output_dir + "/" + semi_qualified_prefix;
+      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
+      std::string ertPath = out_prefix + ".ERT.yaml";
+      auto ertConfig = new config::CompoundConfig(ertPath.c_str());
+      auto ert = ertConfig->getRoot().lookup("ERT");
+      std::cout << "Generate Accelergy ERT (energy reference table) to replace internal energy model." << std::endl;
+      arch_specs.topology.ParseAccelergyERT(ert);
+
+      std::string artPath = out_prefix + ".ART.yaml";
+      auto artConfig = new config::CompoundConfig(artPath.c_str());
+      auto art = artConfig->getRoot().lookup("ART");
+      std::cout << "Generate Accelergy ART (area reference table) to replace internal area model." << std::endl;
+      arch_specs.topology.ParseAccelergyART(art);
+    }
+#else
+    (void) output_dir;
+    (void) semi_qualified_prefix;
+#endif
+  }
+
+  return arch_specs;
+}
+
 Mapper::~Mapper()
 {
   if (mapspace_)
@@ -432,6 +569,11 @@ Mapper::~Mapper()
     delete mapspace_;
   }
 
+  if (result_cache_)
+  {
+    delete result_cache_;
+  }
+
   if (sparse_optimizations_)
   {
     delete sparse_optimizations_;
@@ -444,6 +586,19 @@ Mapper::~Mapper()
       delete search;
     }
   }
+
+  for (auto& layout_search: layout_search_)
+  {
+    if (layout_search)
+    {
+      delete layout_search;
+    }
+  }
+
+  if (work_pool_)
+  {
+    delete work_pool_;
+  }
 }
 
 EvaluationResult Mapper::GetGlobalBest()
@@ -451,11 +606,143 @@ EvaluationResult Mapper::GetGlobalBest()
   return global_best_;
 }
 
+const layout::Layouts& Mapper::GetLayouts() const
+{
+  return layout_;
+}
+
+void Mapper::SetIntralineConstraints(const std::vector<layoutspace::IntralineConstraint>& constraints)
+{
+  layout_constraints_ = constraints;
+}
+
+void Mapper::SetResume(bool resume)
+{
+  resume_ = resume;
+}
+
+// Collects the latest published state of every thread into the checkpoint
+// file. Threads publish at their next mapping boundary after a request.
+void Mapper::SaveCheckpoint(const std::vector<MapperThread*>& threads)
+{
+  MapperCheckpoint checkpoint;
+  checkpoint.key = ResultCache::Hash(CacheKey());
+  for (auto thread : threads)
+  {
+    checkpoint.threads.push_back(thread->GetCheckpoint());
+  }
+  ::WriteCheckpoint(out_prefix_ + ".checkpoint", checkpoint);
+}
+
 // ---------------
 // Run the mapper.
 // ---------------
+std::string Mapper::CacheKey() const
+{
+  std::ostringstream key;
+  key << cache_key_ << "\nconstraints=";
+  for (auto& constraint : layout_constraints_)
+  {
+    key << constraint.target << "/" << constraint.data_space << ":";
+    for (auto& [rank, factor] : constraint.factors)
+    {
+      key << rank << "=" << factor << " ";
+    }
+    key << ";";
+  }
+  return key.str();
+}
+
+bool Mapper::RestoreCachedRun(const std::string& value, Mapper::Result& result)
+{
+  CachedRun cached;
+  try
+  {
+    std::istringstream value_stream(value);
+    boost::archive::text_iarchive ar(value_stream);
+    ar >> cached;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "WARNING: ignoring unreadable result cache entry: " << e.what() << std::endl;
+    return false;
+  }
+
+  if (cached.outputs.size() != 7 || cached.nests.size() != 3 * layout_.size())
+  {
+    return false;
+  }
+
+  result.mapping_cpp_string = cached.outputs[0];
+  result.mapping_yaml_string = cached.outputs[1];
+  result.mapping_string = cached.outputs[2];
+  result.stats_string = cached.outputs[3];
+  result.tensella_string = cached.outputs[4];
+  result.xml_mapping_stats_string = cached.outputs[5];
+  result.orojenesis_string = cached.outputs[6];
+
+  global_best_.valid = cached.valid;
+  global_best_.stats.cycles = cached.cycles;
+  global_best_.stats.energy = cached.energy;
+  global_best_.layout = layout_;
+  for (unsigned lvl = 0; lvl < layout_.size(); lvl++)
+  {
+    global_best_.layout[lvl].interline = cached.nests[3*lvl];
+    global_best_.layout[lvl].intraline = cached.nests[3*lvl+1];
+    global_best_.layout[lvl].authblock_lines = cached.nests[3*lvl+2];
+  }
+  return true;
+}
+
+void Mapper::StoreCachedRun(const Mapper::Result& result)
+{
+  CachedRun cached;
+  cached.valid = global_best_.valid;
+  cached.cycles = global_best_.stats.cycles;
+  cached.energy = global_best_.stats.energy;
+  cached.outputs = { result.mapping_cpp_string, result.mapping_yaml_string, result.mapping_string,
+                     result.stats_string, result.tensella_string, result.xml_mapping_stats_string,
+                     result.orojenesis_string };
+  auto& best_layout = global_best_.valid ? global_best_.layout : layout_;
+  if (best_layout.size() != layout_.size())
+  {
+    return;
+  }
+  for (auto& level : best_layout)
+  {
+    cached.nests.push_back(level.interline);
+    cached.nests.push_back(level.intraline);
+    cached.nests.push_back(level.authblock_lines);
+  }
+
+  std::ostringstream value_stream;
+  {
+    boost::archive::text_oarchive ar(value_stream);
+    ar << cached;
+  }
+  result_cache_->Store(CacheKey(), value_stream.str());
+}
+
 Mapper::Result Mapper::Run()
 {
+  // Identical searches (same problem, architecture, constraints, crypto,
+  // knobs and mapper options) return the stored result.
+  if (result_cache_)
+  {
+    std::string value;
+    Result result;
+    if (result_cache_->Lookup(CacheKey(), value) && RestoreCachedRun(value, result))
+    {
+      std::cout << "Result cache hit, skipping search." << std::endl;
+      if (global_best_.valid)
+      {
+        std::string layout_filename = out_prefix_ + ".layout.yaml";
+        layout::DumpLayoutToYAML(global_best_.layout, layout_filename);
+      }
+      return result;
+    }
+  }
+
   // Output file names.
   std::string log_file_name = out_prefix_ + ".log";
   std::string map_cfg_file_name = out_prefix_ + ".map.cfg";
@@ -498,14 +785,40 @@ Mapper::Result Mapper::Run()
     refresh();
   }
 
+  // Checkpoint of an earlier run to continue from.
+  std::string checkpoint_file_name = out_prefix_ + ".checkpoint";
+  MapperCheckpoint resume_checkpoint;
+  bool resuming = false;
+  if (resume_)
+  {
+    if (!ReadCheckpoint(checkpoint_file_name, resume_checkpoint))
+    {
+      std::cerr << "WARNING: no checkpoint " << checkpoint_file_name << ", starting from scratch." << std::endl;
+    }
+    else if (resume_checkpoint.key != ResultCache::Hash(CacheKey()) ||
+             resume_checkpoint.threads.size() != num_threads_)
+    {
+      std::cerr << "WARNING: checkpoint " << checkpoint_file_name << " is from a different configuration, "
+                << "starting from scratch." << std::endl;
+    }
+    else
+    {
+      std::cout << "Resuming search from " << checkpoint_file_name << std::endl;
+      resuming = true;
+    }
+  }
+
   // Prepare the threads.
   std::mutex mutex;
+  LayoutSearchPool layout_search_pool(num_threads_);
+  Incumbent incumbent(optimization_metrics_);
   std::vector<MapperThread*> threads_;
   for (unsigned t = 0; t < num_threads_; t++)
   {
     threads_.push_back(new MapperThread(t, search_.at(t),
                                         split_mapspaces_.at(t),
                                         &mutex,
+                                        &layout_search_pool,
                                         search_size_,
                                         timeout_,
                                         victory_condition_,
@@ -529,9 +842,20 @@ Mapper::Result Mapper::Run()
                                         workload_,
                                         layout_,
                                         layout_initialized_,
+                                        layout_search_.at(t),
+                                        layout_constraints_,
                                         sparse_optimizations_,
                                         crypto_,
-                                        &best_));
+                                        &incumbent));
+  }
+
+  std::atomic<std::uint64_t> checkpoint_request(0);
+  for (unsigned t = 0; t < num_threads_; t++)
+  {
+    if (resuming)
+      threads_.at(t)->ResumeFrom(&resume_checkpoint.threads.at(t));
+    if (checkpoint_interval_ > 0)
+      threads_.at(t)->EnableCheckpoints(&checkpoint_request);
   }
 
   // Launch the threads.
@@ -540,12 +864,49 @@ Mapper::Result Mapper::Run()
     threads_.at(t)->Start();
   }
 
+  // Checkpoint the search at every interval until all threads are done.
+  if (checkpoint_interval_ > 0)
+  {
+    auto all_finished = [&]()
+    {
+      return std::all_of(threads_.begin(), threads_.end(),
+                         [](MapperThread* thread) { return thread->IsFinished(); });
+    };
+    auto last_checkpoint = std::chrono::steady_clock::now();
+    while (!all_finished())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      if (std::chrono::steady_clock::now() - last_checkpoint < std::chrono::seconds(checkpoint_interval_))
+        continue;
+
+      auto epoch = ++checkpoint_request;
+      while (!std::all_of(threads_.begin(), threads_.end(),
+                          [epoch](MapperThread* thread)
+                          { return thread->IsFinished() || thread->CheckpointEpoch() >= epoch; }))
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      SaveCheckpoint(threads_);
+      last_checkpoint = std::chrono::steady_clock::now();
+    }
+  }
+
   // Wait for the threads to join.
   for (unsigned t = 0; t < num_threads_; t++)
   {
     threads_.at(t)->Join();
   }
 
+  if (checkpoint_interval_ > 0)
+  {
+    SaveCheckpoint(threads_);
+  }
+
+  if (work_pool_)
+  {
+    std::cout << "Work pool: " << work_pool_->Steals() << " ranges stolen between threads." << std::endl;
+  }
+
   // Close log and end curses.
   if (live_status_)
   {
@@ -846,6 +1207,11 @@ Mapper::Result Mapper::Run()
   result.xml_mapping_stats_string = xml_map_stats_str.str();
   result.orojenesis_string = orojenesis_stream.str();
 
+  if (result_cache_ && !gTerminate)
+  {
+    StoreCachedRun(result);
+  }
+
   return result;
 }
 
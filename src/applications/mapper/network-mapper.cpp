@@ -0,0 +1,284 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
+#include "applications/mapper/network-mapper.hpp"
+
+extern bool gTerminate;
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+namespace application
+{
+
+namespace
+{
+
+// Order layer files as resnet18_1, resnet18_2, ..., resnet18_10.
+bool LayerFileLess(const std::string& a, const std::string& b)
+{
+  auto split = [](const std::string& path)
+  {
+    std::string stem = std::filesystem::path(path).stem().string();
+    std::size_t pos = stem.find_last_not_of("0123456789") + 1;
+    long number = pos < stem.size() ? std::stol(stem.substr(pos)) : -1;
+    return std::make_pair(stem.substr(0, pos), number);
+  };
+  return split(a) < split(b);
+}
+
+} // namespace
+
+NetworkMapper::NetworkMapper(config::CompoundConfig* config,
+                             std::string output_dir,
+                             std::string name) :
+    config_(config),
+    output_dir_(output_dir),
+    semi_qualified_prefix_(name)
+{
+  auto rootNode = config->getRoot();
+  auto network = rootNode.lookup("network");
+  rootNode.lookup("mapper").lookupValue("out_prefix", semi_qualified_prefix_);
+
+  // Layers: a directory of per-layer problem files, or an explicit list.
+  std::string layer_dir;
+  if (network.lookupValue("layers", layer_dir))
+  {
+    if (!std::filesystem::is_directory(layer_dir))
+    {
+      std::cerr << "ERROR: network layers directory " << layer_dir << " not found." << std::endl;
+      exit(1);
+    }
+    for (auto& entry : std::filesystem::directory_iterator(layer_dir))
+    {
+      auto ext = entry.path().extension().string();
+      if (entry.is_regular_file() && (ext == ".yaml" || ext == ".yml"))
+      {
+        layer_files_.push_back(entry.path().string());
+      }
+    }
+    std::sort(layer_files_.begin(), layer_files_.end(), LayerFileLess);
+  }
+  else if (!network.lookupArrayValue("layers", layer_files_))
+  {
+    std::cerr << "ERROR: network must specify layers as a directory or a list of problem files." << std::endl;
+    exit(1);
+  }
+
+  if (layer_files_.empty())
+  {
+    std::cerr << "ERROR: network has no layers." << std::endl;
+    exit(1);
+  }
+
+  for (auto& layer_file : layer_files_)
+  {
+    auto layer_config = new config::CompoundConfig(layer_file.c_str());
+    if (!layer_config->getRoot().exists("problem"))
+    {
+      std::cerr << "ERROR: network layer " << layer_file << " has no problem." << std::endl;
+      exit(1);
+    }
+    layer_configs_.push_back(layer_config);
+  }
+
+  // Producer/consumer pairs (1-based layer indices), each layer feeding the
+  // next one by default.
+  producers_.resize(layer_files_.size());
+  if (network.exists("dependencies"))
+  {
+    auto dependencies = network.lookup("dependencies");
+    assert(dependencies.isList());
+    for (int i = 0; i < dependencies.getLength(); i++)
+    {
+      unsigned producer = 0, consumer = 0;
+      if (!dependencies[i].lookupValue("producer", producer) ||
+          !dependencies[i].lookupValue("consumer", consumer) ||
+          producer < 1 || consumer > layer_files_.size() || producer >= consumer)
+      {
+        std::cerr << "ERROR: network dependency " << i << " needs a producer layer "
+                  << "that precedes its consumer layer (1-based)." << std::endl;
+        exit(1);
+      }
+      producers_[consumer-1].push_back(producer-1);
+    }
+  }
+  else
+  {
+    for (unsigned l = 1; l < layer_files_.size(); l++)
+    {
+      producers_[l].push_back(l-1);
+    }
+  }
+
+  producer_data_space_ = "Outputs";
+  network.lookupValue("producer_data_space", producer_data_space_);
+  consumer_data_space_ = "Inputs";
+  network.lookupValue("consumer_data_space", consumer_data_space_);
+
+  // Architecture configuration, shared by all layers.
+  arch_specs_ = Mapper::ParseArchitecture(config, output_dir, semi_qualified_prefix_);
+  std::cout << "Architecture configuration complete." << std::endl;
+
+  coupled_level_ = arch_specs_.topology.StorageLevelNames().back();
+  network.lookupValue("coupled_level", coupled_level_);
+
+  std::cout << "Network configuration complete: " << layer_files_.size()
+            << " layers, coupled at " << coupled_level_ << "." << std::endl;
+}
+
+NetworkMapper::~NetworkMapper()
+{
+  for (auto& layer_config : layer_configs_)
+  {
+    delete layer_config;
+  }
+}
+
+void NetworkMapper::SetResume(bool resume)
+{
+  resume_ = resume;
+}
+
+//
+// CoupleToProducer() - the consumer's ranks take the intraline factors of the
+// producer's ranks at the same position (e.g. Outputs N,L,P,Q -> Inputs N,V,H,W).
+//
+std::vector<layoutspace::IntralineConstraint> NetworkMapper::CoupleToProducer(
+  const layout::Layouts& producer_layout,
+  const layout::Layouts& consumer_layout) const
+{
+  std::vector<layoutspace::IntralineConstraint> constraints;
+  for (auto& producer_level : producer_layout)
+  {
+    if (producer_level.target != coupled_level_)
+    {
+      continue;
+    }
+    for (auto& consumer_level : consumer_layout)
+    {
+      if (consumer_level.target != coupled_level_ ||
+          !producer_level.dataSpaceToRank.count(producer_data_space_) ||
+          !consumer_level.dataSpaceToRank.count(consumer_data_space_))
+      {
+        continue;
+      }
+      auto& producer_ranks = producer_level.dataSpaceToRank.at(producer_data_space_);
+      auto& consumer_ranks = consumer_level.dataSpaceToRank.at(consumer_data_space_);
+      for (auto& nest : producer_level.intraline)
+      {
+        if (nest.data_space != producer_data_space_)
+        {
+          continue;
+        }
+        layoutspace::IntralineConstraint constraint;
+        constraint.target = coupled_level_;
+        constraint.data_space = consumer_data_space_;
+        for (unsigned r = 0; r < std::min(producer_ranks.size(), consumer_ranks.size()); r++)
+        {
+          auto factor_it = nest.factors.find(producer_ranks[r]);
+          if (factor_it != nest.factors.end())
+          {
+            constraint.factors[consumer_ranks[r]] = factor_it->second;
+          }
+        }
+        constraints.push_back(constraint);
+      }
+    }
+  }
+  return constraints;
+}
+
+// ----------------------------------------
+// Run the mapper on every layer, in order.
+// ----------------------------------------
+NetworkMapper::Result NetworkMapper::Run()
+{
+  Result result;
+  std::vector<layout::Layouts> best_layouts(layer_files_.size());
+  std::uint64_t total_cycles = 0;
+  double total_energy = 0;
+  std::stringstream summary;
+
+  for (unsigned l = 0; l < layer_files_.size() && !gTerminate; l++)
+  {
+    std::cout << "Network layer " << l+1 << "/" << layer_files_.size()
+              << ": " << layer_files_[l] << std::endl;
+
+    LayerResult layer;
+    layer.name = "layer" + std::to_string(l+1);
+    layer.problem_file = layer_files_[l];
+
+    Mapper mapper(config_, layer_configs_[l]->getRoot().lookup("problem"), &arch_specs_,
+                  output_dir_, semi_qualified_prefix_ + "." + layer.name);
+    mapper.SetResume(resume_);
+
+    std::vector<layoutspace::IntralineConstraint> constraints;
+    for (auto producer : producers_[l])
+    {
+      auto coupled = CoupleToProducer(best_layouts[producer], mapper.GetLayouts());
+      constraints.insert(constraints.end(), coupled.begin(), coupled.end());
+    }
+    mapper.SetIntralineConstraints(constraints);
+
+    layer.result = mapper.Run();
+
+    auto best = mapper.GetGlobalBest();
+    layer.valid = best.valid;
+    if (best.valid)
+    {
+      layer.cycles = best.stats.cycles;
+      layer.energy = best.stats.energy;
+      best_layouts[l] = best.layout;
+      total_cycles += layer.cycles;
+      total_energy += layer.energy;
+    }
+    else
+    {
+      std::cerr << "WARNING: no valid mapping found for network " << layer.name
+                << ", its consumers are left unconstrained." << std::endl;
+    }
+
+    summary << layer.name << " " << layer.problem_file << " "
+            << (layer.valid ? "" : "INVALID ")
+            << "Cycles: " << layer.cycles << " Energy: " << layer.energy << " pJ" << std::endl;
+    result.layers.push_back(std::move(layer));
+  }
+
+  summary << "Total Cycles: " << total_cycles << " Energy: " << total_energy << " pJ" << std::endl;
+  result.summary_string = summary.str();
+  std::cout << result.summary_string;
+
+  return result;
+}
+
+} // namespace application
@@ -0,0 +1,186 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#include "applications/mapper/result-cache.hpp"
+
+namespace
+{
+
+void EmitCanonical(const YAML::Node& node, std::ostream& out,
+                   const std::set<std::string>& skip_keys)
+{
+  switch (node.Type())
+  {
+    case YAML::NodeType::Scalar:
+    {
+      out << '"';
+      for (char c : node.Scalar())
+      {
+        if (c == '"' || c == '\\')
+          out << '\\';
+        out << c;
+      }
+      out << '"';
+      break;
+    }
+    case YAML::NodeType::Sequence:
+    {
+      out << '[';
+      for (auto it = node.begin(); it != node.end(); it++)
+      {
+        EmitCanonical(*it, out, {});
+        out << ',';
+      }
+      out << ']';
+      break;
+    }
+    case YAML::NodeType::Map:
+    {
+      std::vector<std::pair<std::string, std::string>> entries;
+      for (auto it = node.begin(); it != node.end(); it++)
+      {
+        std::ostringstream key, value;
+        EmitCanonical(it->first, key, {});
+        if (it->first.IsScalar() && skip_keys.count(it->first.Scalar()))
+          continue;
+        EmitCanonical(it->second, value, {});
+        entries.emplace_back(key.str(), value.str());
+      }
+      std::sort(entries.begin(), entries.end());
+      out << '{';
+      for (auto& [key, value] : entries)
+      {
+        out << key << ':' << value << ',';
+      }
+      out << '}';
+      break;
+    }
+    default:
+      out << '~';
+      break;
+  }
+}
+
+} // namespace
+
+ResultCache::ResultCache(std::string directory) :
+    directory_(directory)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  if (ec)
+  {
+    std::cerr << "ERROR: cannot create result cache directory " << directory_
+              << ": " << ec.message() << std::endl;
+    exit(1);
+  }
+}
+
+std::string ResultCache::EntryPath(const std::string& key) const
+{
+  std::ostringstream path;
+  path << directory_ << "/" << std::hex << std::setw(16) << std::setfill('0')
+       << Hash(key) << ".entry";
+  return path.str();
+}
+
+bool ResultCache::Lookup(const std::string& key, std::string& value) const
+{
+  std::ifstream file(EntryPath(key), std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  // Entry layout: <key length>\n<key><value>
+  std::size_t key_length = 0;
+  file >> key_length;
+  if (!file || file.get() != '\n' || key_length != key.size())
+  {
+    return false;
+  }
+  std::string stored_key(key_length, '\0');
+  file.read(&stored_key[0], key_length);
+  if (!file || stored_key != key)
+  {
+    return false;
+  }
+
+  std::ostringstream stored_value;
+  stored_value << file.rdbuf();
+  value = stored_value.str();
+  return true;
+}
+
+void ResultCache::Store(const std::string& key, const std::string& value) const
+{
+  std::string path = EntryPath(key);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "." << std::hex << Hash(value);
+
+  std::ofstream file(tmp_path.str(), std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cerr << "WARNING: cannot write result cache entry " << path << std::endl;
+    return;
+  }
+  file << key.size() << '\n' << key << value;
+  file.close();
+
+  if (!file || std::rename(tmp_path.str().c_str(), path.c_str()) != 0)
+  {
+    std::cerr << "WARNING: cannot write result cache entry " << path << std::endl;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+std::uint64_t ResultCache::Hash(const std::string& text)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : text)
+  {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string ResultCache::CanonicalText(const YAML::Node& node,
+                                       const std::set<std::string>& skip_keys)
+{
+  std::ostringstream out;
+  EmitCanonical(node, out, skip_keys);
+  return out.str();
+}
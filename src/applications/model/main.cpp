@@ -68,7 +68,8 @@ int main(int argc, char* argv[])
 
   std::vector<std::string> input_files;
   std::string output_dir = ".";
-  bool success = ParseArgs(argc, argv, input_files, output_dir);
+  std::set<std::string> options;
+  bool success = ParseArgs(argc, argv, input_files, output_dir, { "--serve" }, options);
   if (!success)
   {
     std::cerr << "ERROR: error parsing command line." << std::endl;
@@ -77,6 +78,21 @@ int main(int argc, char* argv[])
 
   auto config = new config::CompoundConfig(input_files);
 
+  // Server mode: parse the architecture once and answer evaluation requests
+  // read from stdin. Responses are the only thing written to stdout; the
+  // model's progress messages are sent to stderr instead.
+  if (options.count("--serve") > 0)
+  {
+    std::ostream responses(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    application::Model server(config, output_dir, "timeloop-model", true);
+    server.Serve(std::cin, responses);
+
+    std::cout.rdbuf(responses.rdbuf());
+    return 0;
+  }
+
   application::Model application(config, output_dir);
   
   const auto stats = application.Run();
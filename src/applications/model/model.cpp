@@ -26,6 +26,9 @@
  */
 
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 
 #include "util/accelergy_interface.hpp"
 #include "util/banner.hpp"
@@ -52,8 +55,10 @@ void Model::serialize(Archive& ar, const unsigned int version)
 
 Model::Model(config::CompoundConfig* config,
              std::string output_dir,
-             std::string name) :
-    name_(name)
+             std::string name,
+             bool serve) :
+    name_(name),
+    serve_(serve)
 {    
   auto rootNode = config->getRoot();
 
@@ -92,6 +97,7 @@ Model::Model(config::CompoundConfig* config,
   // Problem configuration.
   auto problem = rootNode.lookup("problem");
   problem::ParseWorkload(problem, workload_);
+  shape_signature_ = ShapeSignature();
   if (verbose_)
     std::cout << "Problem configuration complete." << std::endl;
 
@@ -168,8 +174,8 @@ Model::Model(config::CompoundConfig* config,
     arch = rootNode.lookup("architecture");
   }
   
-  bool is_sparse_topology = rootNode.exists("sparse_optimizations");
-  arch_specs_ = model::Engine::ParseSpecs(arch, is_sparse_topology);
+  is_sparse_topology_ = rootNode.exists("sparse_optimizations");
+  arch_specs_ = model::Engine::ParseSpecs(arch, is_sparse_topology_);
 
   if (rootNode.exists("ERT"))
   {
@@ -208,52 +214,107 @@ Model::Model(config::CompoundConfig* config,
 #endif
   }
 
+  // Sparse optimizations are parsed with each evaluation, but default to
+  // the ones given alongside the architecture.
+  if (is_sparse_topology_)
+    sparse_optimizations_config_ = rootNode.lookup("sparse_optimizations");
+
+  arch_props_ = new ArchProperties(arch_specs_);
+  // Architecture constraints.
+  if (arch.exists("constraints"))
+    arch_constraints_ = arch.lookup("constraints");
+  else if (rootNode.exists("arch_constraints"))
+    arch_constraints_ = rootNode.lookup("arch_constraints");
+  else if (rootNode.exists("architecture_constraints"))
+    arch_constraints_ = rootNode.lookup("architecture_constraints");
+
+  if (verbose_)
+    std::cout << "Architecture configuration complete." << std::endl;
+
+  if (!serve_)
+  {
+    auto error = ParseEvaluation(rootNode, false);
+    if (!error.empty())
+    {
+      std::cerr << "ERROR: " << error << std::endl;
+      exit(1);
+    }
+  }
+}
+
+std::vector<std::string> Model::ShapeSignature() const
+{
+  std::vector<std::string> signature;
+  auto shape = workload_.GetShape();
+  for (unsigned i = 0; i < shape->NumFactorizedDimensions; i++)
+    signature.push_back(shape->FactorizedDimensionIDToName.at(i));
+  for (unsigned pv = 0; pv < shape->NumDataSpaces; pv++)
+    signature.push_back(shape->DataSpaceIDToName.at(pv));
+  return signature;
+}
+
+std::string Model::ParseEvaluation(config::CompoundConfigNode rootNode, bool parse_problem)
+{
+  // Problem configuration.
+  if (parse_problem && rootNode.exists("problem"))
+  {
+    workload_.Reset();
+    problem::ParseWorkload(rootNode.lookup("problem"), workload_);
+    if (ShapeSignature() != shape_signature_)
+      return "problem shape differs from the one the architecture was parsed with.";
+    if (verbose_)
+      std::cout << "Problem configuration complete." << std::endl;
+  }
+
   // Sparse optimizations
-  config::CompoundConfigNode sparse_optimizations;
-  if (is_sparse_topology)
+  config::CompoundConfigNode sparse_optimizations = sparse_optimizations_config_;
+  if (rootNode.exists("sparse_optimizations"))
+  {
+    if (!is_sparse_topology_)
+      return "sparse_optimizations must be given with the architecture.";
     sparse_optimizations = rootNode.lookup("sparse_optimizations");
-      sparse_optimizations_ = new sparse::SparseOptimizationInfo(sparse::ParseAndConstruct(sparse_optimizations, arch_specs_));
+  }
+  if (sparse_optimizations_)
+    delete sparse_optimizations_;
+  sparse_optimizations_ = new sparse::SparseOptimizationInfo(sparse::ParseAndConstruct(sparse_optimizations, arch_specs_));
   // characterize workload on whether it has metadata
   workload_.SetDefaultDenseTensorFlag(sparse_optimizations_->compression_info.all_ranks_default_dense);
   
   if (verbose_)
     std::cout << "Sparse optimization configuration complete." << std::endl;
 
-  arch_props_ = new ArchProperties(arch_specs_);
-  // Architecture constraints.
-  config::CompoundConfigNode arch_constraints;
-
-  if (arch.exists("constraints"))
-    arch_constraints = arch.lookup("constraints");
-  else if (rootNode.exists("arch_constraints"))
+  // Architecture constraints (served evaluations may override them).
+  config::CompoundConfigNode arch_constraints = arch_constraints_;
+  if (serve_ && rootNode.exists("arch_constraints"))
     arch_constraints = rootNode.lookup("arch_constraints");
-  else if (rootNode.exists("architecture_constraints"))
+  else if (serve_ && rootNode.exists("architecture_constraints"))
     arch_constraints = rootNode.lookup("architecture_constraints");
 
+  if (constraints_)
+    delete constraints_;
   constraints_ = new mapping::Constraints(*arch_props_, workload_);
   constraints_->Parse(arch_constraints);
 
-  if (verbose_)
-    std::cout << "Architecture configuration complete." << std::endl;
-
   // Mapping configuration: expressed as a mapspace or mapping.
+  if (!rootNode.exists("mapping"))
+    return "no mapping specified.";
   auto mapping = rootNode.lookup("mapping");
+  if (mapping_)
+    delete mapping_;
   mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
   if (verbose_)
     std::cout << "Mapping construction complete." << std::endl;
 
   // Validate mapping against the architecture constraints.
   if (!constraints_->SatisfiedBy(mapping_))
-  {
-    std::cerr << "ERROR: mapping violates architecture constraints." << std::endl;
-    exit(1);
-  }
+    return "mapping violates architecture constraints.";
 
   // crypto modeling
   std::cout << "Start Parsering Crypto" << std::endl;
   config::CompoundConfigNode compound_config_node_crypto;
   bool existing_crypto = rootNode.lookup("crypto", compound_config_node_crypto);
-  crypto_ = new crypto::CryptoConfig();
+  if (crypto_)
+    delete crypto_;
 
   if (existing_crypto){
     crypto_ = crypto::ParseAndConstruct(compound_config_node_crypto);
@@ -261,6 +322,7 @@ Model::Model(config::CompoundConfig* config,
     crypto_->crypto_initialized_ = true;
   }
   else{
+    crypto_ = new crypto::CryptoConfig();
     crypto_->crypto_initialized_ = false;
     std::cout << "No Crypto specified" << std::endl;
   }
@@ -287,7 +349,8 @@ Model::Model(config::CompoundConfig* config,
     layout_initialized_ = false;
     std::cout << "No Layout specified, so using bandwidth based modeling" << std::endl;
   }
-  
+
+  return "";
 }
 
 Model::~Model()
@@ -303,11 +366,16 @@ Model::~Model()
 
   if (sparse_optimizations_)
     delete sparse_optimizations_;
+
+  if (crypto_)
+    delete crypto_;
 }
 
 // Run the evaluation.
-Model::Stats Model::Run()
+Model::Stats Model::Run(bool detailed_output)
 {
+  Stats stats;
+
   model::Engine engine;
   engine.Spec(arch_specs_);
 
@@ -340,31 +408,34 @@ Model::Stats Model::Run()
       }
   }
   
-  if (layout_initialized_){ 
-    auto eval_status = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, crypto_);
-    for (unsigned level = 0; level < eval_status.size(); level++)
+  std::vector<model::EvalStatus> eval_status;
+  if (layout_initialized_)
+    eval_status = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, crypto_);
+  else
+    eval_status = engine.Evaluate(mapping, workload_, sparse_optimizations_, crypto_);
+
+  for (unsigned level = 0; level < eval_status.size(); level++)
+  {
+    if (!eval_status[level].success)
     {
-      if (!eval_status[level].success)
-      {
-        std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
-                  << eval_status[level].fail_reason << std::endl;
-        exit(1);
-      }
+      if (!stats.fail_reason.empty())
+        stats.fail_reason += "; ";
+      stats.fail_reason += "couldn't map level " + level_names.at(level) + ": " +
+        eval_status[level].fail_reason;
     }
-  }else{
-    auto eval_status = engine.Evaluate(mapping, workload_, sparse_optimizations_, crypto_);    
-    for (unsigned level = 0; level < eval_status.size(); level++)
+  }
+
+  if (!stats.fail_reason.empty())
+  {
+    if (!serve_)
     {
-      if (!eval_status[level].success)
-      {
-        std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
-                  << eval_status[level].fail_reason << std::endl;
-        exit(1);
-      }
+      std::cerr << "ERROR: " << stats.fail_reason << std::endl;
+      exit(1);
     }
+    stats.success = false;
+    return stats;
   }
 
-  
   // if (!std::accumulate(success.begin(), success.end(), true, std::logical_and<>{}))
   // {
   //   std::cout << "Illegal mapping, evaluation failed." << std::endl;
@@ -399,8 +470,17 @@ Model::Stats Model::Run()
                         engine.GetTopology().TileSizes());
 
     stats_txt << engine << std::endl;
+
+    stats.utilization = engine.Utilization();
+    stats.area = engine.Area();
   }
 
+  stats.cycles = engine.Cycles();
+  stats.energy = engine.Energy();
+
+  if (!detailed_output)
+    return stats;
+
   // Print the engine stats and mapping to an XML file
   std::stringstream xml_str;
   boost::archive::xml_oarchive ar(xml_str);
@@ -413,15 +493,97 @@ Model::Stats Model::Run()
   std::stringstream tenssella_out;
   mapping.PrintTenssella(tenssella_out);
 
-  Stats stats;
   stats.map_string = map_txt.str();
   stats.stats_string = stats_txt.str();
   stats.xml_map_and_stats_string = xml_str.str();
   stats.tensella_string = tenssella_out.str();
 
-  stats.cycles = engine.Cycles();
-  stats.energy = engine.Energy();
   return stats;
 }
 
+//--------------------------------------------//
+//                 Server Mode                //
+//--------------------------------------------//
+
+namespace
+{
+
+std::string JsonEscape(const std::string& str)
+{
+  std::ostringstream out;
+  for (char c : str)
+  {
+    switch (c)
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+        else
+          out << c;
+    }
+  }
+  return out.str();
+}
+
+} // namespace
+
+void Model::Serve(std::istream& in, std::ostream& out)
+{
+  out << "{\"status\":\"ready\"}" << std::endl;
+
+  std::string line;
+  std::uint64_t id = 0;
+  while (std::getline(in, line))
+  {
+    std::istringstream line_stream(line);
+    std::vector<std::string> input_files;
+    std::string file;
+    while (line_stream >> file)
+      input_files.push_back(file);
+
+    if (input_files.empty())
+      continue;
+    if (input_files.size() == 1 && input_files.front() == "quit")
+      break;
+
+    std::string error;
+    Stats stats;
+    try
+    {
+      config::CompoundConfig request(input_files);
+      error = ParseEvaluation(request.getRoot(), true);
+      if (error.empty())
+      {
+        stats = Run(false);
+        if (!stats.success)
+          error = stats.fail_reason;
+      }
+    }
+    catch (const std::exception& e)
+    {
+      error = e.what();
+    }
+
+    out << "{\"id\":" << id++;
+    if (error.empty())
+    {
+      out << ",\"status\":\"ok\""
+          << std::setprecision(std::numeric_limits<double>::max_digits10)
+          << ",\"energy\":" << stats.energy
+          << ",\"cycles\":" << stats.cycles
+          << ",\"utilization\":" << stats.utilization
+          << ",\"area\":" << stats.area;
+    }
+    else
+    {
+      out << ",\"status\":\"error\",\"reason\":\"" << JsonEscape(error) << "\"";
+    }
+    out << "}" << std::endl;
+  }
+}
+
 } // namespace application
@@ -1,13 +1,44 @@
 #include "isl-wrapper/ctx-manager.hpp"
 
-#include <optional>
+#include <cstdlib>
+#include <cstring>
 
 /******************************************************************************
  * Local declarations
  *****************************************************************************/
 
-thread_local std::optional<isl::ctx> gCtx;
-std::mutex gIslMutex;
+namespace
+{
+
+// Owns the calling thread's context. Contexts still referenced by live ISL
+// objects at thread exit are left allocated by isl_ctx_free.
+struct ThreadIslCtx
+{
+  isl::ctx ctx;
+
+  ThreadIslCtx() : ctx(isl_ctx_alloc()) {}
+  ~ThreadIslCtx() { isl_ctx_free(ctx.get()); }
+};
+
+thread_local ThreadIslCtx gCtx;
+
+bool gParallelBarvinok =
+  (getenv("TIMELOOP_PARALLEL_BARVINOK") != NULL) &&
+  (strcmp(getenv("TIMELOOP_PARALLEL_BARVINOK"), "0") != 0);
+
+std::mutex gBarvinokMutex;
+
+// Parse a printed ISL object (freeing the string) into the calling thread's
+// context.
+template <typename T>
+T Reparse(char* p_str)
+{
+  T result(gCtx.ctx, std::string(p_str));
+  free(p_str);
+  return result;
+}
+
+} // namespace
 
 /******************************************************************************
  * Global function implementations
@@ -15,14 +46,29 @@ std::mutex gIslMutex;
 
 isl::ctx& GetIslCtx()
 {
-  if (!gCtx)
-  {
-    gCtx = isl::ctx(isl_ctx_alloc());
-  }
-  return *gCtx;
+  return gCtx.ctx;
 }
 
-std::mutex& GetIslMutex()
+isl::set TransferToIslCtx(const isl::set& set)
 {
-  return gIslMutex;
-}
\ No newline at end of file
+  return Reparse<isl::set>(isl_set_to_str(set.get()));
+}
+
+isl::map TransferToIslCtx(const isl::map& map)
+{
+  return Reparse<isl::map>(isl_map_to_str(map.get()));
+}
+
+isl::multi_aff TransferToIslCtx(const isl::multi_aff& maff)
+{
+  return Reparse<isl::multi_aff>(isl_multi_aff_to_str(maff.get()));
+}
+
+std::unique_lock<std::mutex> LockBarvinok()
+{
+  if (gParallelBarvinok)
+  {
+    return std::unique_lock<std::mutex>();
+  }
+  return std::unique_lock<std::mutex>(gBarvinokMutex);
+}
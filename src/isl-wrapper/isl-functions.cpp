@@ -300,13 +300,31 @@ isl::map insert_dummy_dim_ins(isl::map map, size_t pos, size_t n)
 isl_pw_qpolynomial* sum_map_range_card(isl::map map)
 {
   auto p_domain = map.domain().release();
-  auto p_count = isl_map_card(map.release());
+  auto p_count = map_card(map.release());
   return isl_set_apply_pw_qpolynomial(p_domain, p_count);
 }
 
 isl_pw_qpolynomial* set_card(isl::set set)
 {
-  return isl_set_card(set.release());
+  return set_card(set.release());
+}
+
+__isl_give isl_pw_qpolynomial* set_card(__isl_take isl_set* p_set)
+{
+  auto lock = LockBarvinok();
+  return isl_set_card(p_set);
+}
+
+__isl_give isl_pw_qpolynomial* map_card(__isl_take isl_map* p_map)
+{
+  auto lock = LockBarvinok();
+  return isl_map_card(p_map);
+}
+
+__isl_give isl_pw_qpolynomial* pw_qpolynomial_sum(__isl_take isl_pw_qpolynomial* p_pwqp)
+{
+  auto lock = LockBarvinok();
+  return isl_pw_qpolynomial_sum(p_pwqp);
 }
 
 double val_to_double(isl_val* val)
@@ -27,6 +27,138 @@ namespace layout
     return orderMapping;
   }
 
+  //------------------------------------------------------------------------------
+  // RankTable
+  //------------------------------------------------------------------------------
+  std::vector<unsigned>
+  RankTable::IDs(const std::vector<std::string> &ranks) const
+  {
+    std::vector<unsigned> rank_ids;
+    rank_ids.reserve(ranks.size());
+    for (const auto &r : ranks)
+    {
+      rank_ids.push_back(ids.at(r));
+    }
+    return rank_ids;
+  }
+
+  void
+  RankTable::Factors(const LayoutNest &nest, std::vector<std::uint32_t> &factors) const
+  {
+    factors.assign(names.size(), 1);
+    for (const auto &[r, factor] : nest.factors)
+    {
+      auto it = ids.find(r);
+      if (it != ids.end())
+      {
+        factors[it->second] = factor;
+      }
+    }
+  }
+
+  bool
+  RankTable::operator==(const RankTable &other) const
+  {
+    // The groups are derived from the dims, so they need no comparison.
+    return names == other.names && dims == other.dims &&
+      coefficients == other.coefficients && zero_padding == other.zero_padding;
+  }
+
+  static unsigned
+  FindGroupRepresentative(std::vector<unsigned> &rep, unsigned idx)
+  {
+    if (rep[idx] != idx)
+    {
+      rep[idx] = FindGroupRepresentative(rep, rep[idx]);
+    }
+    return rep[idx];
+  }
+
+  //------------------------------------------------------------------------------
+  // BuildRankTable()
+  // Interns ranks in rankToFactorizedDimensionID order (i.e. sorted by name) and
+  // groups ranks that share factorized dimensions with a union-find over the
+  // dimension IDs.
+  std::shared_ptr<const RankTable>
+  BuildRankTable(const Layout &layout)
+  {
+    auto table = std::make_shared<RankTable>();
+    for (const auto &[r, dimsID] : layout.rankToFactorizedDimensionID)
+    {
+      if (dimsID.empty())
+      {
+        std::cerr << "Rank " << r << " does not project to any problem dimension."
+                  << std::endl;
+        exit(1);
+      }
+      table->ids[r] = table->names.size();
+      table->names.push_back(r);
+      table->dims.push_back(dimsID);
+
+      auto coef_it = layout.rankToCoefficientValue.find(r);
+      table->coefficients.push_back(coef_it != layout.rankToCoefficientValue.end()
+                                    ? coef_it->second : std::vector<std::uint32_t>());
+      auto zp_it = layout.rankToZeroPadding.find(r);
+      table->zero_padding.push_back(zp_it != layout.rankToZeroPadding.end() ? zp_it->second : 0);
+    }
+
+    std::map<std::uint32_t, unsigned> dim_to_node;
+    std::vector<unsigned> rep;
+    for (const auto &dimsID : table->dims)
+    {
+      for (auto d : dimsID)
+      {
+        if (dim_to_node.count(d) == 0)
+        {
+          dim_to_node[d] = rep.size();
+          rep.push_back(rep.size());
+        }
+        rep[FindGroupRepresentative(rep, dim_to_node[d])] = FindGroupRepresentative(rep, dim_to_node[dimsID[0]]);
+      }
+    }
+    std::vector<unsigned> rep_to_group(rep.size(), 0);
+    for (unsigned i = 0; i < rep.size(); i++)
+    {
+      if (rep[i] == i)
+      {
+        rep_to_group[i] = table->rank_groups.size();
+        table->rank_groups.push_back({});
+      }
+    }
+    for (unsigned rid = 0; rid < table->dims.size(); rid++)
+    {
+      auto g = FindGroupRepresentative(rep, dim_to_node[table->dims[rid][0]]);
+      table->rank_groups[rep_to_group[g]].push_back(rid);
+    }
+    table->dim_groups.resize(table->rank_groups.size());
+    for (const auto &[d, node] : dim_to_node)
+    {
+      table->dim_groups[rep_to_group[FindGroupRepresentative(rep, node)]].push_back(d);
+    }
+    return table;
+  }
+
+  std::shared_ptr<const RankTable>
+  GetRankTable(const Layout &layout)
+  {
+    return layout.rank_table ? layout.rank_table : BuildRankTable(layout);
+  }
+
+  // Rank information is workload-wide, so every target shares one table.
+  static void
+  AttachRankTable(Layouts &layouts)
+  {
+    if (layouts.empty())
+    {
+      return;
+    }
+    auto rank_table = BuildRankTable(layouts.front());
+    for (auto &layout : layouts)
+    {
+      layout.rank_table = rank_table;
+    }
+  }
+
   //------------------------------------------------------------------------------
   // ParseAndConstruct()
   // This function uses the compound-config library to read a configuration that
@@ -340,6 +472,8 @@ namespace layout
       layouts.push_back(layout);
     }
 
+    AttachRankTable(layouts);
+
     return layouts;
   }
 
@@ -541,6 +675,8 @@ namespace layout
       layouts.push_back(layout);
     }
 
+    AttachRankTable(layouts);
+
     return layouts;
   }
 
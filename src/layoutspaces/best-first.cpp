@@ -0,0 +1,293 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "layoutspaces/best-first.hpp"
+
+namespace layoutspace
+{
+
+BestFirstLayoutSearch::BestFirstLayoutSearch(const SamplingConfig& sampling,
+                                                       std::uint32_t victory_condition) :
+    sampling_(sampling),
+    victory_condition_(victory_condition),
+    generator_(std::random_device()()),
+    layoutspace_(nullptr),
+    search_auth_(false),
+    stage_(Stage::Done),
+    outstanding_(0),
+    next_splitting_id_(0),
+    stop_sampling_(false),
+    visited_candidate_counter_(0),
+    less_improvement_counter_(0),
+    current_node_(0),
+    has_estimate_(false),
+    estimate_cycles_(UINT64_MAX),
+    estimate_energy_per_compute_(std::numeric_limits<double>::max()),
+    estimate_splitting_id_(0),
+    has_best_(false),
+    best_cycles_(UINT64_MAX),
+    best_energy_per_compute_(std::numeric_limits<double>::max())
+{
+}
+
+void BestFirstLayoutSearch::Init(const Legal& layoutspace, bool search_auth)
+{
+  layoutspace_ = &layoutspace;
+  search_auth_ = search_auth;
+  outstanding_ = 0;
+  nodes_.clear();
+  current_node_ = 0;
+  has_estimate_ = false;
+  estimate_cycles_ = UINT64_MAX;
+  estimate_energy_per_compute_ = std::numeric_limits<double>::max();
+  estimate_splitting_id_ = 0;
+  has_best_ = false;
+  best_cycles_ = UINT64_MAX;
+  best_energy_per_compute_ = std::numeric_limits<double>::max();
+  StartStage(Stage::Splitting);
+}
+
+void BestFirstLayoutSearch::StartStage(Stage stage)
+{
+  stage_ = stage;
+  sampler_.reset();
+  stop_sampling_ = false;
+  visited_candidate_counter_ = 0;
+  less_improvement_counter_ = 0;
+
+  switch (stage)
+  {
+    case Stage::Splitting:
+      next_splitting_id_ = 0;
+      break;
+
+    case Stage::Packing:
+      // Packing 0 at the best splitting was estimated by the splitting stage.
+      if (layoutspace_->packing_candidates > 1)
+        sampler_.emplace(layoutspace_->packing_candidates - 1,
+                         sampling_.packing_budget, sampling_.exhaustive_threshold, generator_);
+      else
+        StartStage(Stage::Auth);
+      break;
+
+    case Stage::Joint:
+      // Only the pairs no earlier stage estimated: packing > 0 at the other
+      // splittings, so that no draw of the budget is spent on a known pair.
+      if (layoutspace_->splitting_candidates > 1 && layoutspace_->packing_candidates > 1)
+        sampler_.emplace((layoutspace_->splitting_candidates - 1) * (layoutspace_->packing_candidates - 1),
+                         sampling_.packing_budget, sampling_.exhaustive_threshold, generator_);
+      else
+        StartStage(Stage::Auth);
+      break;
+
+    case Stage::Auth:
+      // Without an AuthSpace the best estimate is already the best layout.
+      if (search_auth_ && layoutspace_->authblock_candidates > 1)
+      {
+        std::sort(nodes_.begin(), nodes_.end(), [](const Node& a, const Node& b)
+                  { return IsBetterLayout(a.cycles, a.energy_per_compute, b.cycles, b.energy_per_compute); });
+        current_node_ = 0;
+        if (!ExpandNextNode())
+          stage_ = Stage::Done;
+      }
+      else
+      {
+        stage_ = Stage::Done;
+      }
+      break;
+
+    case Stage::Done:
+      break;
+  }
+}
+
+// Starts sampling the AuthSpace of nodes_[current_node_], unless its estimate
+// (and therefore that of every later node) does not beat the best layout.
+// With a cutoff set, nodes whose estimate loses to the global incumbent are
+// skipped too. Estimates are not bounds, so both are heuristic.
+bool BestFirstLayoutSearch::ExpandNextNode()
+{
+  for (; current_node_ < nodes_.size(); current_node_++)
+  {
+    auto& node = nodes_[current_node_];
+    if (has_best_ && !IsBetterLayout(node.cycles, node.energy_per_compute, best_cycles_, best_energy_per_compute_))
+      return false;
+    if (!cutoff_ || !cutoff_(node.cycles, node.energy_per_compute))
+      break;
+  }
+  if (current_node_ >= nodes_.size())
+    return false;
+
+  sampler_.emplace(layoutspace_->AuthSampler(sampling_, generator_));
+  stop_sampling_ = false;
+  visited_candidate_counter_ = 0;
+  less_improvement_counter_ = 0;
+  return true;
+}
+
+bool BestFirstLayoutSearch::Next(LayoutID& layout_id)
+{
+  std::uint64_t id;
+  while (true)
+  {
+    switch (stage_)
+    {
+      case Stage::Splitting:
+        if (next_splitting_id_ < layoutspace_->splitting_candidates)
+        {
+          layout_id = { next_splitting_id_++, 0, 0, true };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Stage::Packing:
+        if (!stop_sampling_ && sampler_->Next(id))
+        {
+          layout_id = { estimate_splitting_id_, id + 1, 0, true };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Stage::Joint:
+        if (!stop_sampling_ && sampler_->Next(id))
+        {
+          std::uint64_t splitting = id / (layoutspace_->packing_candidates - 1);
+          std::uint64_t packing = 1 + id % (layoutspace_->packing_candidates - 1);
+          if (splitting >= estimate_splitting_id_)
+            splitting++;
+          layout_id = { splitting, packing, 0, true };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Stage::Auth:
+        if (!stop_sampling_ && sampler_->Next(id))
+        {
+          auto& node = nodes_[current_node_];
+          layout_id = { node.splitting, node.packing, id, false };
+          outstanding_++;
+          return true;
+        }
+        // The pruning decision for the next node needs the best layout of
+        // this one.
+        if (outstanding_ > 0)
+          return false;
+        current_node_++;
+        if (ExpandNextNode())
+          continue;
+        stage_ = Stage::Done;
+        return false;
+
+      case Stage::Done:
+        return false;
+    }
+
+    // Every estimate must be known before the expansion order is decided.
+    if (outstanding_ > 0)
+      return false;
+    StartStage(Stage(unsigned(stage_) + 1));
+  }
+}
+
+bool BestFirstLayoutSearch::Report(const LayoutID& layout_id, bool valid,
+                                        std::uint64_t cycles, double energy_per_compute)
+{
+  outstanding_--;
+  if (!valid)
+    return false;
+
+  bool is_better = false;
+  switch (stage_)
+  {
+    case Stage::Splitting:
+    case Stage::Packing:
+    case Stage::Joint:
+      // Every evaluated pair is kept as a node, even past the early stop.
+      nodes_.push_back({ layout_id.splitting, layout_id.packing, cycles, energy_per_compute });
+      is_better = !has_estimate_ || IsBetterLayout(cycles, energy_per_compute, estimate_cycles_, estimate_energy_per_compute_);
+      if (is_better)
+      {
+        has_estimate_ = true;
+        estimate_cycles_ = cycles;
+        estimate_energy_per_compute_ = energy_per_compute;
+        visited_candidate_counter_ = 0;
+        if (stage_ == Stage::Splitting)
+          estimate_splitting_id_ = layout_id.splitting;
+      }
+      if (stage_ != Stage::Splitting && !stop_sampling_)
+      {
+        if (!sampler_->Exhaustive() &&
+            visited_candidate_counter_ > std::min(std::max(victory_condition_, (std::uint32_t)1), kPackingPatienceCap))
+          stop_sampling_ = true;
+        else
+          visited_candidate_counter_++;
+      }
+      break;
+
+    case Stage::Auth:
+      if (!has_best_ || cycles < best_cycles_)
+      {
+        is_better = true;
+        less_improvement_counter_ = 0;
+      }
+      else if (cycles == best_cycles_ && energy_per_compute < best_energy_per_compute_)
+      {
+        is_better = true;
+        if ((best_energy_per_compute_ - energy_per_compute) < 0.1)
+          less_improvement_counter_++;
+      }
+      if (is_better)
+      {
+        has_best_ = true;
+        best_cycles_ = cycles;
+        best_energy_per_compute_ = energy_per_compute;
+        visited_candidate_counter_ = 0;
+      }
+      if (!stop_sampling_)
+      {
+        if (!sampler_->Exhaustive() &&
+            (less_improvement_counter_ > kLessImprovementThreshold ||
+             visited_candidate_counter_ > std::min(std::max(victory_condition_, (std::uint32_t)1), kAuthPatienceCap)))
+          stop_sampling_ = true;
+        else
+          visited_candidate_counter_++;
+      }
+      break;
+
+    case Stage::Done:
+      break;
+  }
+  return is_better;
+}
+
+} // namespace layoutspace
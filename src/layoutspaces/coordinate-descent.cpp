@@ -0,0 +1,219 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <limits>
+
+#include "layoutspaces/coordinate-descent.hpp"
+
+namespace layoutspace
+{
+
+CoordinateDescentLayoutSearch::CoordinateDescentLayoutSearch(const SamplingConfig& sampling,
+                                                             std::uint32_t victory_condition) :
+    sampling_(sampling),
+    victory_condition_(victory_condition),
+    generator_(std::random_device()()),
+    layoutspace_(nullptr),
+    search_auth_(false),
+    phase_(Phase::Done),
+    outstanding_(0),
+    next_splitting_id_(0),
+    stop_phase_(false),
+    visited_candidate_counter_(0),
+    less_improvement_counter_(0),
+    has_best_(false),
+    best_cycles_(UINT64_MAX),
+    best_energy_per_compute_(std::numeric_limits<double>::max()),
+    best_splitting_id_(0),
+    best_packing_id_(0)
+{
+}
+
+void CoordinateDescentLayoutSearch::Init(const Legal& layoutspace, bool search_auth)
+{
+  layoutspace_ = &layoutspace;
+  search_auth_ = search_auth;
+  outstanding_ = 0;
+  has_best_ = false;
+  best_cycles_ = UINT64_MAX;
+  best_energy_per_compute_ = std::numeric_limits<double>::max();
+  best_splitting_id_ = 0;
+  best_packing_id_ = 0;
+  StartPhase(Phase::Splitting);
+}
+
+void CoordinateDescentLayoutSearch::StartPhase(Phase phase)
+{
+  phase_ = phase;
+  sampler_.reset();
+  stop_phase_ = false;
+  visited_candidate_counter_ = 0;
+  less_improvement_counter_ = 0;
+
+  switch (phase)
+  {
+    case Phase::Splitting:
+      next_splitting_id_ = 0;
+      break;
+
+    case Phase::Packing:
+      if (layoutspace_->packing_candidates > 1)
+        sampler_.emplace(layoutspace_->PackingSampler(sampling_, generator_));
+      else
+        StartPhase(Phase::Auth);
+      break;
+
+    case Phase::Auth:
+      if (search_auth_ && layoutspace_->authblock_candidates > 1)
+      {
+        sampler_.emplace(layoutspace_->AuthSampler(sampling_, generator_));
+        // Layouts evaluated without auth are not comparable with full ones.
+        best_cycles_ = UINT64_MAX;
+        best_energy_per_compute_ = std::numeric_limits<double>::max();
+      }
+      else
+      {
+        phase_ = Phase::Done;
+      }
+      break;
+
+    case Phase::Done:
+      break;
+  }
+}
+
+bool CoordinateDescentLayoutSearch::Next(LayoutID& layout_id)
+{
+  std::uint64_t id;
+  while (true)
+  {
+    switch (phase_)
+    {
+      case Phase::Splitting:
+        if (next_splitting_id_ < layoutspace_->splitting_candidates)
+        {
+          layout_id = { next_splitting_id_++, 0, 0, true };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Phase::Packing:
+        if (!stop_phase_ && sampler_->Next(id))
+        {
+          layout_id = { best_splitting_id_, id, 0, true };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Phase::Auth:
+        if (!stop_phase_ && sampler_->Next(id))
+        {
+          layout_id = { best_splitting_id_, best_packing_id_, id, false };
+          outstanding_++;
+          return true;
+        }
+        break;
+
+      case Phase::Done:
+        return false;
+    }
+
+    // The next phase depends on the best of this one.
+    if (outstanding_ > 0)
+      return false;
+    StartPhase(Phase(unsigned(phase_) + 1));
+  }
+}
+
+bool CoordinateDescentLayoutSearch::Report(const LayoutID& layout_id, bool valid,
+                                           std::uint64_t cycles, double energy_per_compute)
+{
+  outstanding_--;
+  if (!valid || stop_phase_)
+    return false;
+
+  bool is_better = false;
+  switch (phase_)
+  {
+    case Phase::Splitting:
+      is_better = !has_best_ || IsBetterLayout(cycles, energy_per_compute, best_cycles_, best_energy_per_compute_);
+      if (is_better)
+        best_splitting_id_ = layout_id.splitting;
+      break;
+
+    case Phase::Packing:
+      is_better = IsBetterLayout(cycles, energy_per_compute, best_cycles_, best_energy_per_compute_);
+      if (is_better)
+      {
+        visited_candidate_counter_ = 0;
+        best_packing_id_ = layout_id.packing;
+      }
+      if (!sampler_->Exhaustive() &&
+          visited_candidate_counter_ > std::min(std::max(victory_condition_, (std::uint32_t)1), kPackingPatienceCap))
+        stop_phase_ = true;
+      else
+        visited_candidate_counter_++;
+      break;
+
+    case Phase::Auth:
+      if (cycles < best_cycles_)
+      {
+        is_better = true;
+        less_improvement_counter_ = 0;
+      }
+      else if (cycles == best_cycles_ && energy_per_compute < best_energy_per_compute_)
+      {
+        is_better = true;
+        if ((best_energy_per_compute_ - energy_per_compute) < 0.1)
+          less_improvement_counter_++;
+      }
+      if (is_better)
+        visited_candidate_counter_ = 0;
+      if (!sampler_->Exhaustive() &&
+          (less_improvement_counter_ > kLessImprovementThreshold ||
+           visited_candidate_counter_ > std::min(std::max(victory_condition_, (std::uint32_t)1), kAuthPatienceCap)))
+        stop_phase_ = true;
+      else
+        visited_candidate_counter_++;
+      break;
+
+    case Phase::Done:
+      break;
+  }
+
+  if (is_better)
+  {
+    has_best_ = true;
+    best_cycles_ = cycles;
+    best_energy_per_compute_ = energy_per_compute;
+  }
+  return is_better;
+}
+
+} // namespace layoutspace
@@ -0,0 +1,74 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "layoutspaces/coordinate-descent.hpp"
+#include "layoutspaces/best-first.hpp"
+
+#include "layoutspaces/layout-search.hpp"
+
+namespace layoutspace
+{
+
+//--------------------------------------------//
+//             Parser and Factory             //
+//--------------------------------------------//
+
+LayoutSearchAlgorithm* ParseAndConstructSearch(config::CompoundConfigNode config,
+                                               std::uint32_t victory_condition)
+{
+  LayoutSearchAlgorithm* search = nullptr;
+
+  // PackingSpace/AuthSpace sizes up to which every candidate is evaluated,
+  // and per-phase caps on the number of candidates drawn.
+  SamplingConfig sampling;
+  config.lookupValue("layout_exhaustive_threshold", sampling.exhaustive_threshold);
+  config.lookupValue("layout_packing_budget", sampling.packing_budget);
+  config.lookupValue("layout_authblock_budget", sampling.authblock_budget);
+
+  // Coordinate descent is the default. Best-first is an optional heuristic
+  // over the joint space that may miss layouts coordinate descent finds.
+  std::string search_alg = "coordinate_descent";
+  config.lookupValue("layout_search_algorithm", search_alg);
+
+  if (search_alg == "coordinate_descent")
+  {
+    search = new CoordinateDescentLayoutSearch(sampling, victory_condition);
+  }
+  else if (search_alg == "best_first")
+  {
+    search = new BestFirstLayoutSearch(sampling, victory_condition);
+  }
+  else
+  {
+    std::cerr << "ERROR: unsupported layout search algorithm: " << search_alg << std::endl;
+    exit(-1);
+  }
+
+  return search;
+}
+
+} // namespace layoutspace
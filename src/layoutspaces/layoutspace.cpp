@@ -51,7 +51,11 @@
     bool skip_authblock)
   {
     arch_specs_ = arch_specs;
-    layout_ = layout::Layouts(layout);
+    mapping_ = &mapping;
+    if (&layout_ != &layout)
+    {
+      layout_ = layout;
+    }
 
     num_storage_levels = mapping.loop_nest.storage_tiling_boundaries.size();
     num_data_spaces = layout_.at(0).intraline.size();
@@ -59,6 +63,9 @@
 
     // Step 1: Create concordant layout from mapping
     CreateConcordantLayout(mapping);
+    concordant_layout_ = layout_;
+    dirty_nests_.clear();
+    bound_ = true;
 
     // Step 2: Create design spaces for layout optimization
     CreateIntralineFactorSpace(arch_specs, mapping);
@@ -304,7 +311,7 @@
   //
   void Legal::ParseArchSpecs(model::Engine::Specs arch_specs, const Mapping& mapping)
   {
-    storage_level_keep_factor.resize(num_storage_levels, std::vector<bool>(num_data_spaces, false));
+    storage_level_keep_factor.assign(num_storage_levels, std::vector<bool>(num_data_spaces, false));
 
     for (unsigned storage_level = 0; storage_level < num_storage_levels; storage_level++){
       for (unsigned ds_idx = 0; ds_idx < num_data_spaces; ds_idx++){
@@ -312,9 +319,16 @@
       }
     }
 
+    // Capacities do not depend on the mapping, so a reused Legal keeps them.
+    if (arch_parsed_ && storage_level_line_capacity.size() == num_storage_levels)
+    {
+      return;
+    }
+    arch_parsed_ = true;
+
     // Initialize the storage level capacity vectors
-    storage_level_total_capacity.resize(num_storage_levels, 0);
-    storage_level_line_capacity.resize(num_storage_levels, 0);
+    storage_level_total_capacity.assign(num_storage_levels, 0);
+    storage_level_line_capacity.assign(num_storage_levels, 0);
 
     // Iterate through each storage level to extract capacity information and bypass information.
     for (unsigned storage_level = 0; storage_level < num_storage_levels; storage_level++)
@@ -367,7 +381,7 @@
   //
   // ConstructLayout() - Three-parameter version with separate layout_splitting_id, layout_auth_id, and layout_packing_id
   //
-  std::vector<Status> Legal::ConstructLayout(uint64_t layout_splitting_id, uint64_t layout_packing_id, uint64_t layout_auth_id, layout::Layouts* layouts, Mapping mapping, bool skip_authblock, bool break_on_failure)
+  std::vector<Status> Legal::ConstructLayout(uint64_t layout_splitting_id, uint64_t layout_packing_id, uint64_t layout_auth_id, layout::Layouts* layouts, const Mapping& mapping, bool skip_authblock, bool break_on_failure)
   {
     (void)break_on_failure; // Suppress unused parameter warning
 
@@ -376,8 +390,21 @@
     // - layout_packing_id: for PackingSpace (interline-to-intraline packing)
     // - layout_auth_id: for AuthSpace (authblock factor variations)
 
-    // Create a deep copy of the layout to ensure modifications don't affect the original
-    CreateConcordantLayout(mapping);
+    // Start from the concordant layout. For the mapping bound by Init() it is
+    // cached, so only the nests modified by the previous construction are restored.
+    // Boundness is tracked explicitly: a different mapping may well live at
+    // the address of the bound one.
+    if (bound_)
+    {
+      assert(&mapping == mapping_);
+      RestoreConcordantLayout();
+    }
+    else
+    {
+      CreateConcordantLayout(mapping);
+      concordant_layout_ = layout_;
+      dirty_nests_.clear();
+    }
 
     #ifdef DEBUG_CONSTRUCTION_LAYOUT
       std::cout << "\n=== LAYOUT CONSTRUCTION START ===" << std::endl;
@@ -526,6 +553,7 @@
           continue;
         }
         const auto& multi_rank_option = multi_rank_splitting_options_per_level_per_ds_[lvl][ds_idx][choice];
+        dirty_nests_.emplace_back(lvl, ds_idx);
 
         for (const auto& unique_rank : multi_rank_option.ranks)
         {
@@ -610,6 +638,7 @@
           continue;
         }
         const auto& multi_rank_option = multi_rank_packing_options_per_level_per_ds_[lvl][ds_idx][choice];
+        dirty_nests_.emplace_back(lvl, ds_idx);
 
         for (const auto& unique_rank : multi_rank_option.ranks)
         {
@@ -679,6 +708,16 @@
       }
     }
 
+    // Pin the constrained intraline factors (e.g. to the producer layer's layout)
+    if (!intraline_constraints_.empty())
+    {
+      auto constraint_status = ApplyIntralineConstraints();
+      if (!constraint_status.success)
+      {
+        return {constraint_status};
+      }
+    }
+
     // Apply AuthSpace factor choices (using layout_auth_id)
     if (!skip_authblock) 
     {
@@ -705,6 +744,7 @@
         }
 
         // Set the chosen factor value
+        dirty_nests_.emplace_back(lvl, ds_idx);
         authblock_nest.factors[rank] = std::min(chosen_factor, interline_nest.factors[rank]);
 
         #ifdef DEBUG_CONSTRUCTION_LAYOUT
@@ -720,7 +760,7 @@
     }
 
     // Copy the modified layout to the output parameter
-    if (layouts != nullptr)
+    if (layouts != nullptr && layouts != &layout_)
     {
       *layouts = layout_;
     }
@@ -741,11 +781,11 @@
         if (is_kept)
         {
           uint64_t intraline_per_ds = 1;
-          auto intra_nest = layout_.at(lvl).intraline.at(ds_idx);
+          const auto& intra_nest = layout_.at(lvl).intraline.at(ds_idx);
           for (const auto &r : intra_nest.ranks) // Analyze slowdown per rank
           {
-          int factor = (intra_nest.factors.find(r) != intra_nest.factors.end() ? intra_nest.factors.at(r) : 1);
-            intraline_per_ds *= factor;
+            auto factor_it = intra_nest.factors.find(r);
+            intraline_per_ds *= (factor_it != intra_nest.factors.end() ? factor_it->second : 1);
           }
           if (intraline_per_ds > storage_level_line_capacity[lvl]){
             std::cout << "layout not satisfies the internal constraints" << std::endl;
@@ -964,16 +1004,17 @@
         Step 3: Assign collapsed nested loop to the layout.
     */
     for(unsigned lvl=0; lvl < cumulatively_intraline_dimval.size(); lvl++){
+      auto rank_table = layout::GetRankTable(layout_.at(lvl));
       for (unsigned i = 0; i < num_data_spaces; i++){ // iterate over all data spaces
         for(auto & rank: layout_.at(lvl).intraline.at(i).ranks){ // iterate over all ranks of the data space
-          const auto& dim_ids = layout_.at(lvl).rankToFactorizedDimensionID.at(rank);
+          unsigned rank_id = rank_table->ID(rank);
+          const auto& dim_ids = rank_table->dims[rank_id];
           uint32_t total_intraline = 0;
           uint32_t total_rank_size = 0;
-          const auto& coefficient = layout_.at(lvl).rankToCoefficientValue[rank];
+          const auto& coefficient = rank_table->coefficients[rank_id];
           uint32_t zero_padding = 0;
-          if (lvl == cumulatively_intraline_dimval.size()-1 && 
-              layout_.at(lvl).rankToZeroPadding.find(rank) != layout_.at(lvl).rankToZeroPadding.end()) {
-            zero_padding = layout_.at(lvl).rankToZeroPadding.at(rank);
+          if (lvl == cumulatively_intraline_dimval.size()-1) {
+            zero_padding = rank_table->zero_padding[rank_id];
           }
           for (unsigned idx=0; idx < dim_ids.size(); idx++){
             auto dim_intraline_value = cumulatively_intraline_dimval[lvl][dim_ids[idx]];
@@ -1050,11 +1091,25 @@
       std::cout << "Step 2: Creating SplittingSpace and PackingSpace candidates from intraline factors..." << std::endl;
     #endif
 
-    // Clear previous design spaces
-    multi_rank_splitting_options_per_level_per_ds_.clear();
-    multi_rank_splitting_options_per_level_per_ds_.resize(num_storage_levels, std::vector<std::vector<MultiRankSplittingOption>>(num_data_spaces, std::vector<MultiRankSplittingOption>()));
-    multi_rank_packing_options_per_level_per_ds_.clear();
-    multi_rank_packing_options_per_level_per_ds_.resize(num_storage_levels, std::vector<std::vector<MultiRankPackingOption>>(num_data_spaces, std::vector<MultiRankPackingOption>()));
+    // Clear previous design spaces, keeping the option tables' storage for the next mapping
+    multi_rank_splitting_options_per_level_per_ds_.resize(num_storage_levels);
+    for (auto& options_per_ds : multi_rank_splitting_options_per_level_per_ds_)
+    {
+      options_per_ds.resize(num_data_spaces);
+      for (auto& options : options_per_ds)
+      {
+        options.clear();
+      }
+    }
+    multi_rank_packing_options_per_level_per_ds_.resize(num_storage_levels);
+    for (auto& options_per_ds : multi_rank_packing_options_per_level_per_ds_)
+    {
+      options_per_ds.resize(num_data_spaces);
+      for (auto& options : options_per_ds)
+      {
+        options.clear();
+      }
+    }
     uint64_t max_intraline_to_interline_factor = 0;
 
     // Phase 1: Get Memory Line size for all storage levels (What Layout Provide Per Cycle)
@@ -1070,11 +1125,11 @@
         if (is_kept)
         {
           uint64_t intraline_per_ds = 1;
-          auto intra_nest = layout_.at(lvl).intraline.at(ds_idx);
+          const auto& intra_nest = layout_.at(lvl).intraline.at(ds_idx);
           for (const auto &r : intra_nest.ranks) // Analyze slowdown per rank
           {
-          int factor = (intra_nest.factors.find(r) != intra_nest.factors.end() ? intra_nest.factors.at(r) : 1);
-            intraline_per_ds *= factor;
+            auto factor_it = intra_nest.factors.find(r);
+            intraline_per_ds *= (factor_it != intra_nest.factors.end() ? factor_it->second : 1);
           }
           intraline_size_per_ds[lvl][ds_idx] = intraline_per_ds;
         }
@@ -1083,7 +1138,7 @@
 
     // Phase 2: Check if the line capacity is sufficient for the intraline size
     // First, determine which levels require splitting (intraline_size > line_capacity)
-    level_ds_requires_splitting_.resize(num_storage_levels, std::vector<bool>(num_data_spaces, false));
+    level_ds_requires_splitting_.assign(num_storage_levels, std::vector<bool>(num_data_spaces, false));
     #ifdef DEBUG_CREATE_INTRALINE_FACTOR_SPACE
       std::cout << "Phase 2.1: quick glance at the intraline size and line capacity" << std::endl;
       for (unsigned lvl = 0; lvl < num_storage_levels; lvl++){
@@ -1381,7 +1436,6 @@
     #ifdef DEBUG_CREATE_AUTH_SPACE
       std::cout << "Step 3: Creating layout candidate space from authblock_lines factors..." << std::endl;
     #endif
-    CreateConcordantLayout(mapping_);
     num_storage_levels = layout_.size();
     num_data_spaces = layout_.at(0).intraline.size();
 
@@ -1506,9 +1560,9 @@
 
     // Calculate total number of combinations from authblock factors
     authblock_candidates = 1;
+    authblock_factor_ranges_.clear();
     if (!variable_authblock_factors_.empty())
     {
-      authblock_factor_ranges_.clear();
       for (const auto& var_factor : variable_authblock_factors_)
       {
         uint32_t max_factor = std::get<3>(var_factor);
@@ -1540,6 +1594,86 @@
     #endif
   }
 
+  //
+  // RestoreConcordantLayout() - Undo the factor changes of the previous ConstructLayout()
+  //
+  void Legal::RestoreConcordantLayout()
+  {
+    for (auto& [lvl, ds_idx] : dirty_nests_)
+    {
+      auto& level_layout = layout_[lvl];
+      const auto& concordant_level_layout = concordant_layout_[lvl];
+      level_layout.intraline[ds_idx].factors = concordant_level_layout.intraline[ds_idx].factors;
+      level_layout.interline[ds_idx].factors = concordant_level_layout.interline[ds_idx].factors;
+      if (ds_idx < level_layout.authblock_lines.size() && ds_idx < concordant_level_layout.authblock_lines.size())
+      {
+        level_layout.authblock_lines[ds_idx].factors = concordant_level_layout.authblock_lines[ds_idx].factors;
+      }
+    }
+    dirty_nests_.clear();
+  }
+
+  //
+  // ApplyIntralineConstraints() - Overwrite constrained intraline factors, keeping each rank covered
+  //
+  Status Legal::ApplyIntralineConstraints()
+  {
+    Status status;
+    status.success = true;
+    for (const auto& constraint : intraline_constraints_)
+    {
+      for (unsigned lvl = 0; lvl < num_storage_levels; lvl++)
+      {
+        if (layout_[lvl].target != constraint.target)
+        {
+          continue;
+        }
+        for (unsigned ds_idx = 0; ds_idx < num_data_spaces; ds_idx++)
+        {
+          auto& intraline_nest = layout_[lvl].intraline[ds_idx];
+          auto& interline_nest = layout_[lvl].interline[ds_idx];
+          if (intraline_nest.data_space != constraint.data_space)
+          {
+            continue;
+          }
+          dirty_nests_.emplace_back(lvl, ds_idx);
+          for (const auto& [rank, factor] : constraint.factors)
+          {
+            auto intra_it = intraline_nest.factors.find(rank);
+            auto inter_it = interline_nest.factors.find(rank);
+            if (intra_it == intraline_nest.factors.end() || inter_it == interline_nest.factors.end() || factor == 0)
+            {
+              continue;
+            }
+            // The rank must stay fully covered by intraline x interline.
+            std::uint64_t rank_size = (std::uint64_t)intra_it->second * inter_it->second;
+            intra_it->second = factor;
+            inter_it->second = std::max<std::uint64_t>((rank_size + factor - 1) / factor, 1);
+          }
+
+          if (!storage_level_keep_factor[lvl][ds_idx])
+          {
+            continue;
+          }
+          std::uint64_t intraline_per_ds = 1;
+          for (const auto& r : intraline_nest.ranks)
+          {
+            auto factor_it = intraline_nest.factors.find(r);
+            intraline_per_ds *= (factor_it != intraline_nest.factors.end() ? factor_it->second : 1);
+          }
+          if (intraline_per_ds > storage_level_line_capacity[lvl])
+          {
+            status.success = false;
+            status.fail_reason = "Constrained intraline size " + std::to_string(intraline_per_ds) + " of dataspace " + constraint.data_space +
+                                 " exceeds line capacity " + std::to_string(storage_level_line_capacity[lvl]) + " at level " + std::to_string(lvl);
+            return status;
+          }
+        }
+      }
+    }
+    return status;
+  }
+
   void Legal::SequentialFactorizeLayout(layout::Layouts& layout){
     for (unsigned lvl = 0; lvl < num_storage_levels; lvl++)
     {
@@ -1598,4 +1732,55 @@
     }
   };
 
+  Sampler Legal::PackingSampler(const SamplingConfig& config, std::mt19937_64& generator) const
+  {
+    return Sampler(packing_candidates, config.packing_budget, config.exhaustive_threshold, generator);
+  }
+
+  Sampler Legal::AuthSampler(const SamplingConfig& config, std::mt19937_64& generator) const
+  {
+    return Sampler(authblock_candidates, config.authblock_budget, config.exhaustive_threshold, generator);
+  }
+
+ //------------------------------------------//
+ //                Sampler                   //
+ //------------------------------------------//
+
+  Sampler::Sampler(std::uint64_t size, std::uint64_t budget, std::uint64_t exhaustive_threshold, std::mt19937_64& generator) :
+    size_(size),
+    budget_((budget == 0 || budget > size) ? size : budget),
+    drawn_(0),
+    exhaustive_(size <= exhaustive_threshold && budget_ == size),
+    generator_(generator())
+  {
+  }
+
+  std::uint64_t Sampler::At(std::uint64_t position) const
+  {
+    auto it = swapped_.find(position);
+    return (it == swapped_.end()) ? position : it->second;
+  }
+
+  bool Sampler::Next(std::uint64_t& id)
+  {
+    if (drawn_ >= budget_)
+    {
+      return false;
+    }
+    if (exhaustive_)
+    {
+      id = drawn_++;
+      return true;
+    }
+    // Swap a uniformly chosen position of the unshuffled suffix to the front
+    // of it. Positions before drawn_ are never looked up again.
+    std::uniform_int_distribution<std::uint64_t> dist(drawn_, size_ - 1);
+    std::uint64_t position = dist(generator_);
+    id = At(position);
+    swapped_[position] = At(drawn_);
+    swapped_.erase(drawn_);
+    drawn_++;
+    return true;
+  }
+
 } // namespace layoutspace
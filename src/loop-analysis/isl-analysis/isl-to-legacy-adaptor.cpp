@@ -158,8 +158,6 @@ CompoundDataMovementNest GenerateCompoundDataMovementNest(
     auto is_master_spatial = master_spatial_level[cur.level];
     auto is_boundary = storage_boundary_level[cur.level];
 
-    auto lock = std::lock_guard(GetIslMutex());
-
     for (unsigned dspace_id = 0;
         dspace_id < workload.GetShape()->NumDataSpaces;
         ++dspace_id)
@@ -211,7 +209,7 @@ CompoundDataMovementNest GenerateCompoundDataMovementNest(
         auto p_occ_map = occ.map.copy();
         auto p_occ_count = isl::get_val_from_singular(
           isl_pw_qpolynomial_bound(
-            isl_map_card(
+            isl::map_card(
               isl_map_project_out(
                 p_occ_map,
                 isl_dim_in,
@@ -232,7 +230,7 @@ CompoundDataMovementNest GenerateCompoundDataMovementNest(
         );
         auto p_occ_map = parent_stats.effective_occupancy.map.copy();
         auto p_occ_count = isl::get_val_from_singular(
-          isl_pw_qpolynomial_bound(isl_map_card(p_occ_map),
+          isl_pw_qpolynomial_bound(isl::map_card(p_occ_map),
                                    isl_fold_max,
                                    nullptr)
         );
@@ -25,11 +25,115 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
 #include "loop-analysis/loop-state.hpp"
 
 namespace analysis
 {
 
+// ---------------------------------------------------------------
+//                        Spatial deltas
+// ---------------------------------------------------------------
+
+void SpatialDeltas::Reset(const problem::Workload* workload, bool dense, std::uint64_t num_spatial_elems)
+{
+  Clear();
+  if (workload != workload_)
+  {
+    deltas_.clear();
+    workload_ = workload;
+  }
+
+  dense_ = dense;
+  if (dense_ && dense_entries_.size() < num_spatial_elems)
+    dense_entries_.resize(num_spatial_elems, -1);
+}
+
+void SpatialDeltas::Clear()
+{
+  if (dense_)
+  {
+    for (std::size_t entry = 0; entry < size_; entry++)
+      dense_entries_[indices_[entry]] = -1;
+  }
+  else
+  {
+    sparse_entries_.clear();
+  }
+  indices_.clear();
+  size_ = 0;
+}
+
+void SpatialDeltas::CopyFrom(const SpatialDeltas& other)
+{
+  Reset(other.workload_, other.dense_, other.dense_entries_.size());
+  for (std::size_t entry = 0; entry < other.size_; entry++)
+  {
+    auto& delta = Insert(other.indices_[entry]);
+    delta = other.deltas_[entry];
+  }
+}
+
+const problem::OperationSpace* SpatialDeltas::Find(std::uint64_t index) const
+{
+  if (dense_)
+  {
+    if (index >= dense_entries_.size() || dense_entries_[index] < 0)
+      return nullptr;
+    return &deltas_[dense_entries_[index]];
+  }
+  else
+  {
+    auto it = sparse_entries_.find(index);
+    if (it == sparse_entries_.end())
+      return nullptr;
+    return &deltas_[it->second];
+  }
+}
+
+const problem::OperationSpace& SpatialDeltas::at(std::uint64_t index) const
+{
+  auto delta = Find(index);
+  if (delta == nullptr)
+    throw std::out_of_range("SpatialDeltas: no delta at spatial index " + std::to_string(index));
+  return *delta;
+}
+
+problem::OperationSpace& SpatialDeltas::at(std::uint64_t index)
+{
+  return const_cast<problem::OperationSpace&>(static_cast<const SpatialDeltas&>(*this).at(index));
+}
+
+problem::OperationSpace& SpatialDeltas::Insert(std::uint64_t index)
+{
+  // If the following assertions fail, it means there's a collision in the
+  // skew function.
+  if (dense_)
+  {
+    if (index >= dense_entries_.size())
+      dense_entries_.resize(index + 1, -1);
+    assert(dense_entries_[index] < 0);
+    dense_entries_[index] = size_;
+  }
+  else
+  {
+    bool inserted = sparse_entries_.emplace(index, size_).second;
+    assert(inserted);
+    (void) inserted;
+  }
+
+  indices_.push_back(index);
+  if (size_ < deltas_.size())
+    deltas_[size_].Reset();
+  else
+    deltas_.emplace_back(workload_);
+
+  return deltas_[size_++];
+}
+
 // ---------------------------------------------------------------
 // Live state for a single spatial element in a single loop level.
 // ---------------------------------------------------------------
@@ -56,7 +160,7 @@ void ElementState::Reset()
     it.clear();
   }
   link_transfers.fill(0);
-  prev_spatial_deltas.clear();
+  prev_spatial_deltas.Clear();
 }
 
 // -----------------------------------------------------------------
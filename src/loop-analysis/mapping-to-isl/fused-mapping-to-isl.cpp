@@ -58,7 +58,7 @@ OccupanciesFromMapping(mapping::FusedMapping& mapping,
     {
       std::cout << "[Tiling]Node(" << node_id << "): " << tiling << std::endl;
       std::cout << "[Ops]Node(" << node_id << "): "
-        << isl_pw_qpolynomial_to_str(isl_pw_qpolynomial_sum(isl_map_card(tiling.copy())))
+        << isl_pw_qpolynomial_to_str(isl::pw_qpolynomial_sum(isl::map_card(tiling.copy())))
         << std::endl;
     }
   }
@@ -85,6 +85,9 @@ bool gUseIslAnalysis =
 bool gPrintNestAnalysisResult =
   (getenv("TIMELOOP_PRINT_NEST_ANALYSIS_RESULT") != NULL) &&
   (strcmp(getenv("TIMELOOP_PRINT_NEST_ANALYSIS_RESULT"), "0") != 0);
+bool gHashMulticastDeltas =
+  (getenv("TIMELOOP_DISABLE_HASHED_MULTICAST") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_HASHED_MULTICAST"), "0") == 0);
 
 
 // Flattening => Multi-AAHRs
@@ -105,7 +108,7 @@ NestAnalysis::NestAnalysis()
 }
 
 
-void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, layout::Layouts layout,
+void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts& layout,
                         std::map<unsigned, std::uint64_t> fanoutX_map,
                         std::map<unsigned, std::uint64_t> fanoutY_map)
 {
@@ -127,7 +130,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, layout::L
 #endif
 
   workload_ = wc;
-  layout_ = layout;
+  layout_ = &layout;
   layout_initialized_ = true;
 
   if (working_sets_computed_ && cached_nest == *nest)
@@ -187,6 +190,8 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest,
   ASSERT(fanoutY_map.size() == nest->storage_tiling_boundaries.size());
 
   workload_ = wc;
+  layout_ = nullptr;
+  layout_initialized_ = false;
 
   if (working_sets_computed_ && cached_nest == *nest)
   {
@@ -357,8 +362,9 @@ problem::Workload* NestAnalysis::GetWorkload(){
   return workload_;
 }
 
-layout::Layouts NestAnalysis::GetLayout(){
-  return layout_;
+const layout::Layouts& NestAnalysis::GetLayout() const {
+  ASSERT(layout_ != nullptr);
+  return *layout_;
 }
 
 bool NestAnalysis::IsLayoutInitialized(){
@@ -414,6 +420,11 @@ void NestAnalysis::ComputeWorkingSets()
 
   if (gPrintNestAnalysisResult)
   {
+    if (!gUseIslAnalysis)
+    {
+      std::cout << "temporal slow-path loops: " << temporal_slow_path_loops_
+                << " (" << temporal_slow_path_iterations_ << " iterations)" << std::endl;
+    }
     for (size_t pv = 0; pv < workload_->GetShape()->NumDataSpaces; ++pv)
     {
       std::cout << "DataSpace: " << pv << std::endl;
@@ -471,6 +482,29 @@ void NestAnalysis::InitializeLiveState()
 {
   indices_.resize(nest_state_.size());
   spatial_id_ = 0;
+
+  // Keep the spatial scratch space from earlier evaluations unless the
+  // number of data spaces changed. This must happen before the recursion
+  // starts since levels hold references into it.
+  unsigned num_data_spaces = workload_->GetShape()->NumDataSpaces;
+  if (!spatial_scratch_.empty() && spatial_scratch_.front().unaccounted_delta.size() != num_data_spaces)
+    spatial_scratch_.clear();
+  while (spatial_scratch_.size() < nest_state_.size())
+    spatial_scratch_.emplace_back(num_data_spaces);
+
+  // Temporal loops that cannot be extrapolated (because extrapolation is
+  // disabled, or a skew makes the loop non-uniform) run every iteration.
+  temporal_slow_path_loops_ = 0;
+  temporal_slow_path_iterations_ = 0;
+  for (auto& loop : nest_state_)
+  {
+    if (loop.level > 0 && !loop::IsSpatial(loop.descriptor.spacetime_dimension) &&
+        (!gExtrapolateUniformTemporal || disable_temporal_extrapolation_.at(loop.level)) &&
+        loop.descriptor.end - loop.descriptor.start > loop.descriptor.stride)
+    {
+      temporal_slow_path_loops_++;
+    }
+  }
   
   // compute_info_.Reset();
   compute_info_.clear();
@@ -1071,6 +1105,8 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
 
       auto saved_transform = cur_transform_[dim];
 
+      temporal_slow_path_iterations_ += num_iterations;
+
       for (indices_[level] = cur->descriptor.start;
            indices_[level] < end;
            indices_[level] += cur->descriptor.stride)
@@ -1154,10 +1190,13 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
 
   // Deltas needed by each of the spatial elements.
   // This array will be filled by recursive calls.
-  // This used to be a dense array but is now a map
-  // because spatial skews may end up filling it in a discontiguous manner.
-  std::unordered_map<std::uint64_t, problem::OperationSpace> spatial_deltas;
-  std::unordered_map<std::uint64_t, std::uint64_t> skew_table;
+  // Spatial skews may end up filling it in a discontiguous manner, so it is
+  // only indexed densely when there is no skew.
+  auto& scratch = spatial_scratch_.at(level);
+  auto& spatial_deltas = scratch.spatial_deltas;
+  auto& skew_table = scratch.skew_table;
+  spatial_deltas.Reset(workload_, cur_skew_descriptor_ == nullptr, num_spatial_elems);
+  skew_table.clear();
 
   FillSpatialDeltas(cur, spatial_deltas, skew_table,
                     0,   // base_index,
@@ -1188,12 +1227,9 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   // transfers completely obliterates access to a producer level,
   // use those link transfers only.
 
-  problem::PerDataSpace<std::unordered_set<std::uint64_t>> unaccounted_delta(workload_->GetShape()->NumDataSpaces);
-  for (auto& delta: spatial_deltas)
-  {
-    for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
-      unaccounted_delta[pv].insert(delta.first);
-  }
+  auto& unaccounted_delta = scratch.unaccounted_delta;
+  for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
+    unaccounted_delta[pv].assign(spatial_deltas.size(), true);
 
   // std::vector<problem::PerDataSpace<bool>> unaccounted_delta;
   // unaccounted_delta.resize(num_spatial_elems);
@@ -1243,11 +1279,8 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   if (gEnableLinkTransfers && linked_spatial_level_[level])
   {
     // Reset unaccounted delta, and now count with link transfers.
-    for (auto& delta: spatial_deltas)
-    {
-      for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
-        unaccounted_delta[pv].insert(delta.first);
-    }
+    for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
+      unaccounted_delta[pv].assign(spatial_deltas.size(), true);
     // for (uint64_t i = 0; i < num_spatial_elems; i++)
     // {
     //   unaccounted_delta[i].fill(true);
@@ -1285,7 +1318,8 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
 
   for (unsigned pvi = 0; pvi < workload_->GetShape()->NumDataSpaces; pvi++)
   {
-    ASSERT(unaccounted_delta[pvi].empty());
+    ASSERT(std::none_of(unaccounted_delta[pvi].begin(), unaccounted_delta[pvi].end(),
+                        [](bool unaccounted) { return unaccounted; }));
   }
   // ASSERT(unaccounted_delta.empty());
   // for (uint64_t i = 0; i < num_spatial_elems; i++)
@@ -1358,7 +1392,7 @@ std::uint64_t NestAnalysis::ApplySkew(std::uint64_t unskewed_index)
 // Computes deltas needed by the spatial elements in the next level.
 // Will update a subset of the elements of spatial_deltas
 void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_iterator cur,
-                                     std::unordered_map<std::uint64_t, problem::OperationSpace>& spatial_deltas,
+                                     analysis::SpatialDeltas& spatial_deltas,
                                      std::unordered_map<std::uint64_t, std::uint64_t>& skew_table,
                                      std::uint64_t base_index,
                                      int depth,
@@ -1374,6 +1408,13 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
   unsigned num_iterations = 1 + ((end - 1 - cur->descriptor.start) /
                                  cur->descriptor.stride);
 
+  // Without a skew every spatial index maps to itself, so the skew table is
+  // neither filled nor consulted.
+  auto SkewedIndex = [&](std::uint64_t spatial_delta_index)
+    {
+      return cur_skew_descriptor_ == nullptr ? spatial_delta_index : skew_table.at(spatial_delta_index);
+    };
+
   // First, update loop gist. FIXME: handle base!=0, stride!=1.
   ASSERT(cur->descriptor.start == 0);
   ASSERT(cur->descriptor.stride == 1);
@@ -1416,12 +1457,9 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
 
       // If the following assertion fails, it means there's a collision in the
       // skew function.
-      ASSERT(spatial_deltas.find(skewed_delta_index) == spatial_deltas.end());
+      ASSERT(spatial_deltas.Find(skewed_delta_index) == nullptr);
 
-      spatial_deltas.emplace(skewed_delta_index,
-                             problem::OperationSpace(workload_));
-      spatial_deltas.emplace(skewed_delta_index, problem::OperationSpace(workload_));
-      spatial_deltas.at(skewed_delta_index) += IndexToOperationPoint_(indices_);
+      spatial_deltas.Insert(skewed_delta_index) += IndexToOperationPoint_(indices_);
 
       space_stamp_.back() = skewed_delta_index;
       compute_info_[space_stamp_].accesses += num_epochs_;
@@ -1507,11 +1545,12 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
 
           std::uint64_t spatial_delta_index = base_index + indices_[level];
           std::uint64_t skewed_delta_index = ApplySkew(spatial_delta_index);
-          skew_table[spatial_delta_index] = skewed_delta_index;
+          if (cur_skew_descriptor_ != nullptr)
+            skew_table[spatial_delta_index] = skewed_delta_index;
 
           // If the following assertion fails, it means there's a collision in the
           // skew function.
-          ASSERT(spatial_deltas.find(skewed_delta_index) == spatial_deltas.end());
+          ASSERT(spatial_deltas.Find(skewed_delta_index) == nullptr);
 
           // std::cout << indent + "  " << iterations_run << " sdi " << spatial_delta_index
           //           << " calling temporal " << std::endl;
@@ -1525,7 +1564,7 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
           //           << " unskewed = " << spatial_delta_index << " skewed = "
           //           << skewed_delta_index << std::endl;
 
-          spatial_deltas.emplace(skewed_delta_index, ComputeDeltas(cur));
+          spatial_deltas.Insert(skewed_delta_index) = ComputeDeltas(cur);
 
           --cur;
           cur_transform_[dim] += scale;
@@ -1560,8 +1599,8 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
         }
         else
         {
-          auto last_skewed_index = skew_table.at(base_index + indices_[level] - extrapolation_stride);
-          auto secondlast_skewed_index = skew_table.at(base_index + indices_[level] - 2*extrapolation_stride);
+          auto last_skewed_index = SkewedIndex(base_index + indices_[level] - extrapolation_stride);
+          auto secondlast_skewed_index = SkewedIndex(base_index + indices_[level] - 2*extrapolation_stride);
 
           auto& opspace_lastrun = spatial_deltas.at(last_skewed_index);
           auto& opspace_secondlastrun = spatial_deltas.at(secondlast_skewed_index);
@@ -1582,20 +1621,19 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
         loop_gists_spatial_.at(dim).index = indices_[level];
 
         std::uint64_t dst_delta_index = ApplySkew(base_index + indices_[level]);
-        std::uint64_t src_delta_index = skew_table.at(base_index + indices_[level] - extrapolation_stride);
-        skew_table[base_index + indices_[level]] = dst_delta_index;
+        std::uint64_t src_delta_index = SkewedIndex(base_index + indices_[level] - extrapolation_stride);
+        if (cur_skew_descriptor_ != nullptr)
+          skew_table[base_index + indices_[level]] = dst_delta_index;
 
         // If the following assertions fail, it means there's a collision in the
         // skew function.
-        ASSERT(spatial_deltas.find(dst_delta_index) == spatial_deltas.end());
-        ASSERT(spatial_deltas.find(src_delta_index) != spatial_deltas.end());
+        ASSERT(spatial_deltas.Find(dst_delta_index) == nullptr);
+        ASSERT(spatial_deltas.Find(src_delta_index) != nullptr);
 
         spatial_id_ = orig_spatial_id + base_index + indices_[level]; // note: unskewed.
 
-        auto dst_temporal_delta_it =
-            spatial_deltas.emplace(dst_delta_index,
-                                   problem::OperationSpace(workload_)).first;
-        auto& dst_temporal_delta = dst_temporal_delta_it->second;
+        // Insert() may grow the pool, so look up the source afterwards.
+        auto& dst_temporal_delta = spatial_deltas.Insert(dst_delta_index);
         auto& src_temporal_delta = spatial_deltas.at(src_delta_index);
         for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
         {
@@ -1613,16 +1651,20 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
   } // level > 0  
 }
 
-// Exhaustively compare all pairs of deltas and infer multicast opportunities.
+// Group identical deltas and infer multicast opportunities. Deltas are
+// bucketed by the hash of their per-data-space projection, so each group is
+// found in one pass instead of by comparing all pairs of deltas (set
+// TIMELOOP_DISABLE_HASHED_MULTICAST to compare all pairs). The groups, and
+// the order in which they are visited, are the same either way.
 void NestAnalysis::ComputeAccurateMulticastedAccesses(
     std::vector<analysis::LoopState>::reverse_iterator cur,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& spatial_deltas,
-    problem::PerDataSpace<std::unordered_set<std::uint64_t>>& unaccounted_delta,
+    const analysis::SpatialDeltas& spatial_deltas,
+    problem::PerDataSpace<std::vector<bool>>& unaccounted_delta,
     //std::set<std::pair<std::uint64_t, problem::Shape::DataSpaceID>>& unaccounted_delta,
     //std::vector<problem::PerDataSpace<bool>>& unaccounted_delta,
     problem::PerDataSpace<AccessStatMatrix>& access_stats)
 {
-  //std::uint64_t num_deltas = spatial_deltas.size();
+  std::uint64_t num_deltas = spatial_deltas.size();
 
   // For each data type, records the number of unaccounted deltas
   // that the current delta matches with. This will be used
@@ -1658,11 +1700,42 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
   auto h_size = std::max(physical_fanoutX_.at(arch_storage_level_.at(cur->level)), logical_fanoutX_[cur->level]);
   auto v_size = std::max(physical_fanoutY_.at(arch_storage_level_.at(cur->level)), logical_fanoutY_[cur->level]);
 
-  for (auto delta_it = spatial_deltas.begin(); delta_it != spatial_deltas.end(); delta_it++)
-    //for (std::uint64_t i = 0; i < num_deltas; i++)
+  // Unaccounted deltas of each data space grouped by equality, in entry
+  // order. The first member of a group is the one that claims the others.
+  struct DeltaGroup
+  {
+    const problem::OperationSpace* delta;
+    std::vector<std::uint64_t> members; // delta entries.
+  };
+  problem::PerDataSpace<std::unordered_map<std::size_t, std::vector<DeltaGroup>>> delta_groups(workload_->GetShape()->NumDataSpaces);
+  if (gHashMulticastDeltas)
   {
-    auto& skewed_spatial_index = delta_it->first;
-    auto& delta = delta_it->second;
+    for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
+    {
+      if (no_multicast[pv])
+        continue;
+
+      for (std::uint64_t i = 0; i < num_deltas; i++)
+      {
+        if (!unaccounted_delta[pv][i])
+          continue;
+
+        auto& delta = spatial_deltas.Delta(i);
+        auto& bucket = delta_groups[pv][delta.Hash(pv)];
+        auto group = std::find_if(bucket.begin(), bucket.end(), [&](const DeltaGroup& g)
+                                  { return g.delta->CheckEquality(delta, pv); });
+        if (group == bucket.end())
+          bucket.push_back({ &delta, { i } });
+        else
+          group->members.push_back(i);
+      }
+    }
+  }
+
+  for (std::uint64_t i = 0; i < num_deltas; i++)
+  {
+    auto skewed_spatial_index = spatial_deltas.Index(i);
+    auto& delta = spatial_deltas.Delta(i);
 
     num_matches.fill(0);
     
@@ -1670,40 +1743,46 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
 
     for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
     {
-      auto unaccounted_it = unaccounted_delta[pv].find(skewed_spatial_index);
-      if (unaccounted_it == unaccounted_delta[pv].end())
-        //if (!unaccounted_delta[i][pv])
+      if (!unaccounted_delta[pv][i])
       {
         // this delta was already accounted for,
         // skip the comparisons.
         continue;
       }
 
-      unaccounted_delta[pv].erase(unaccounted_it);
-      //unaccounted_delta[i][pv] = false;
+      unaccounted_delta[pv][i] = false;
       num_matches[pv] = 1;  // we match with ourselves.
       match_set[pv].push_back(skewed_spatial_index);
 
-      if(!no_multicast[pv]) // If multicasting enabled, look for multicast opportunities
+      if (!no_multicast[pv] && gHashMulticastDeltas)
       {
-        for (auto delta_other_it = std::next(delta_it); delta_other_it != spatial_deltas.end(); delta_other_it++)
-          //for (std::uint64_t j = i + 1; j < num_deltas; j++)
+        // Claim the rest of this delta's group.
+        auto& bucket = delta_groups[pv].at(delta.Hash(pv));
+        auto group = std::find_if(bucket.begin(), bucket.end(), [&](const DeltaGroup& g)
+                                  { return g.delta == &delta; });
+        ASSERT(group != bucket.end());
+        for (auto member = std::next(group->members.begin()); member != group->members.end(); member++)
         {
-          auto& skewed_other_spatial_index = delta_other_it->first;
-          auto& delta_other = delta_other_it->second;
-
-          auto unaccounted_other_it = unaccounted_delta[pv].find(skewed_other_spatial_index);
-          if (unaccounted_other_it != unaccounted_delta[pv].end())
-            //if (unaccounted_delta[j][pv])
+          if (unaccounted_delta[pv][*member])
+          {
+            unaccounted_delta[pv][*member] = false;
+            num_matches[pv]++;
+            match_set[pv].push_back(spatial_deltas.Index(*member));
+          }
+        }
+      }
+      else if(!no_multicast[pv]) // If multicasting enabled, look for multicast opportunities
+      {
+        for (std::uint64_t j = i + 1; j < num_deltas; j++)
+        {
+          if (unaccounted_delta[pv][j])
           {
-            if (delta.CheckEquality(delta_other, pv))
-              //if (spatial_deltas[i].CheckEquality(spatial_deltas[j], pv))
+            if (delta.CheckEquality(spatial_deltas.Delta(j), pv))
             {
               // We have a match, record it
-              unaccounted_delta[pv].erase(unaccounted_other_it);
-              //unaccounted_delta[j][pv] = false;
+              unaccounted_delta[pv][j] = false;
               num_matches[pv]++;
-              match_set[pv].push_back(skewed_other_spatial_index);
+              match_set[pv].push_back(spatial_deltas.Index(j));
             }
           }
         }
@@ -1811,8 +1890,8 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
 // because senders and receivers are at the same storage level, and we only
 // track aggregate stats per level. 
 void NestAnalysis::CompareSpatioTemporalDeltas(
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& prev_spatial_deltas,
+    const analysis::SpatialDeltas& cur_spatial_deltas,
+    const analysis::SpatialDeltas& prev_spatial_deltas,
     //const std::vector<problem::OperationSpace>& cur_spatial_deltas,
     //const std::vector<problem::OperationSpace>& prev_spatial_deltas,
     const std::uint64_t cur_spatial_index,
@@ -1823,16 +1902,16 @@ void NestAnalysis::CompareSpatioTemporalDeltas(
   //PrintSpaceTimeStamp();
   //std::cout << "comparing " << cur_spatial_index << " vs " << prev_spatial_index << std::endl;
   
-  auto cur_delta_it = cur_spatial_deltas.find(cur_spatial_index);
-  if (cur_delta_it == cur_spatial_deltas.end())
+  auto cur_delta_ptr = cur_spatial_deltas.Find(cur_spatial_index);
+  if (cur_delta_ptr == nullptr)
     return;
 
-  auto prev_delta_it = prev_spatial_deltas.find(prev_spatial_index);
-  if (prev_delta_it == prev_spatial_deltas.end())
+  auto prev_delta_ptr = prev_spatial_deltas.Find(prev_spatial_index);
+  if (prev_delta_ptr == nullptr)
     return;
 
-  auto& cur_delta = cur_delta_it->second;
-  auto& prev_delta = prev_delta_it->second;
+  auto& cur_delta = *cur_delta_ptr;
+  auto& prev_delta = *prev_delta_ptr;
 
   //std::cout << "  cur : " << cur_delta << std::endl;
   //std::cout << "  prev: " << prev_delta << std::endl;
@@ -1853,8 +1932,8 @@ void NestAnalysis::CompareSpatioTemporalDeltas(
 
 void NestAnalysis::ComputeNetworkLinkTransfers(
     std::vector<analysis::LoopState>::reverse_iterator cur,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-    problem::PerDataSpace<std::unordered_set<std::uint64_t>>& unaccounted_delta,
+    const analysis::SpatialDeltas& cur_spatial_deltas,
+    problem::PerDataSpace<std::vector<bool>>& unaccounted_delta,
     //std::set<std::pair<std::uint64_t, problem::Shape::DataSpaceID>>& unaccounted_delta,
     //std::vector<problem::PerDataSpace<bool>>& unaccounted_delta,
     problem::PerDataSpace<std::uint64_t>& link_transfers)
@@ -2001,24 +2080,22 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
 
   // Compute the total number of accesses that can be bypassed
   // by using link transfers
-  for (auto& delta: cur_spatial_deltas)
-//  for (int i = 0; i < num_spatial_elems; i++)
+  for (std::uint64_t i = 0; i < cur_spatial_deltas.size(); i++)
   {
-    auto& cur_skewed_spatial_index = delta.first;
+    auto cur_skewed_spatial_index = cur_spatial_deltas.Index(i);
     for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
     {
       if (inter_elem_reuse.at(cur_skewed_spatial_index)[pv])
       {
-        link_transfers[pv] += (delta.second.GetSize(pv) * num_epochs_);
-        auto unaccounted_it = unaccounted_delta[pv].find(cur_skewed_spatial_index);
-        ASSERT(unaccounted_it != unaccounted_delta[pv].end());
-        unaccounted_delta[pv].erase(unaccounted_it);
+        link_transfers[pv] += (cur_spatial_deltas.Delta(i).GetSize(pv) * num_epochs_);
+        ASSERT(unaccounted_delta[pv][i]);
+        unaccounted_delta[pv][i] = false;
       }
     }
   }
 
   // Time-shift the data in prev_spatial_deltas array
-  cur_state.prev_spatial_deltas = cur_spatial_deltas;
+  cur_state.prev_spatial_deltas.CopyFrom(cur_spatial_deltas);
 
   // for (std::uint64_t i = 1; i < analysis::ElementState::MAX_TIME_LAPSE; i++)
   // {
@@ -2414,4 +2491,14 @@ std::uint64_t NestAnalysis::GetLoopOuterSize(const loop::Descriptor &loop) const
   return outer_size;
 }
 
+std::uint64_t NestAnalysis::GetTemporalSlowPathLoops() const
+{
+  return temporal_slow_path_loops_;
+}
+
+std::uint64_t NestAnalysis::GetTemporalSlowPathIterations() const
+{
+  return temporal_slow_path_iterations_;
+}
+
 } // namespace analysis
@@ -26,6 +26,7 @@
  */
 
 #include <iostream>
+#include <functional>
 
 #include "loop-analysis/point-set.hpp"
 
@@ -135,10 +136,29 @@ AxisAlignedHyperRectangle::AxisAlignedHyperRectangle(const AxisAlignedHyperRecta
 {
 }
 
-// Copy-and-swap idiom.
-AxisAlignedHyperRectangle& AxisAlignedHyperRectangle::operator = (AxisAlignedHyperRectangle other)
+AxisAlignedHyperRectangle::AxisAlignedHyperRectangle(AxisAlignedHyperRectangle&& a) noexcept :
+    order_(a.order_),
+    min_(std::move(a.min_)),
+    max_(std::move(a.max_)),
+    gradient_(a.gradient_)
+{
+}
+
+AxisAlignedHyperRectangle& AxisAlignedHyperRectangle::operator = (const AxisAlignedHyperRectangle& other)
 {
-  swap(*this, other);
+  order_ = other.order_;
+  min_ = other.min_;
+  max_ = other.max_;
+  gradient_ = other.gradient_;
+  return *this;
+}
+
+AxisAlignedHyperRectangle& AxisAlignedHyperRectangle::operator = (AxisAlignedHyperRectangle&& other) noexcept
+{
+  order_ = other.order_;
+  min_ = std::move(other.min_);
+  max_ = std::move(other.max_);
+  gradient_ = other.gradient_;
   return *this;
 }
 
@@ -472,18 +492,19 @@ AxisAlignedHyperRectangle AxisAlignedHyperRectangle::operator - (const AxisAlign
   return delta;
 }
 
-std::vector<AxisAlignedHyperRectangle> AxisAlignedHyperRectangle::MultiSubtract(const AxisAlignedHyperRectangle& b)
+void AxisAlignedHyperRectangle::MultiSubtract(const AxisAlignedHyperRectangle& b, AAHRList& retval) const
 {
   // Quick check: if there's no overlap in even a single rank, return a.
   for (unsigned rank = 0; rank < order_; rank++)
   {
     if (max_[rank] <= b.min_[rank] || b.max_[rank] <= min_[rank])
-      return { *this };
+    {
+      retval.push_back(*this);
+      return;
+    }
   }
 
   // There's an intersection.
-  std::vector<AxisAlignedHyperRectangle> retval;
-
   AxisAlignedHyperRectangle middle(*this);
 
   for (unsigned rank = 0; rank < order_; rank++)
@@ -556,8 +577,6 @@ std::vector<AxisAlignedHyperRectangle> AxisAlignedHyperRectangle::MultiSubtract(
   //     }
   //   }
   // }
-
-  return retval;    
 }
 
 bool AxisAlignedHyperRectangle::Contains(const Point& p) const
@@ -651,6 +670,17 @@ bool AxisAlignedHyperRectangle::operator == (const AxisAlignedHyperRectangle& s)
   return true;
 }
 
+std::size_t AxisAlignedHyperRectangle::Hash() const
+{
+  std::size_t seed = order_;
+  for (unsigned dim = 0; dim < order_; dim++)
+  {
+    seed ^= std::hash<Coordinate>()(min_[dim]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<Coordinate>()(max_[dim]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
 std::vector<double> AxisAlignedHyperRectangle::Centroid() const
 {
   std::vector<double> centroid(order_);
@@ -29,6 +29,7 @@
 #include <isl/val.h>
 
 #include "loop-analysis/point-set-isl.hpp"
+#include "isl-wrapper/isl-functions.hpp"
 
 std::mutex ISLPointSet::mutex;
 std::unordered_map<pthread_t, isl_ctx*> ISLPointSet::contexts;
@@ -141,12 +142,10 @@ std::size_t ISLPointSet::size() const
   isl_set* copy = isl_set_copy(set_);
 
   // Unfortunately, barvinok does not appear to be thread-safe. Even though
-  // we have per-thread context management, we need to wrap this call
-  // with a mutex, which is unfortunate because this call is the most
-  // expensive step in the entire execution.
-  mutex.lock();    
-  isl_pw_qpolynomial* cardinality = isl_set_card(copy);
-  mutex.unlock();
+  // we have per-thread context management, this call is serialized with
+  // every other barvinok count, which is unfortunate because this call is
+  // the most expensive step in the entire execution.
+  isl_pw_qpolynomial* cardinality = isl::set_card(copy);
 
   isl_size num_pieces = isl_pw_qpolynomial_n_piece(cardinality);
 
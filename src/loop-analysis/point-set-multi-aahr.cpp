@@ -76,10 +76,23 @@ MultiAAHR::MultiAAHR(const MultiAAHR& a) :
 {
 }
 
-// Copy-and-swap idiom.
-MultiAAHR& MultiAAHR::operator = (MultiAAHR other)
+MultiAAHR::MultiAAHR(MultiAAHR&& a) noexcept :
+    order_(a.order_),
+    aahrs_(std::move(a.aahrs_))
+{
+}
+
+MultiAAHR& MultiAAHR::operator = (const MultiAAHR& other)
+{
+  order_ = other.order_;
+  aahrs_ = other.aahrs_;
+  return *this;
+}
+
+MultiAAHR& MultiAAHR::operator = (MultiAAHR&& other) noexcept
 {
-  swap(*this, other);
+  order_ = other.order_;
+  aahrs_ = std::move(other.aahrs_);
   return *this;
 }
 
@@ -170,15 +183,14 @@ void MultiAAHR::Subtract(const MultiAAHR& other)
   // For each AAHR in other, subtract that AAHR from each one of our AAHRs
   // and place all the splinters in a new vector. Swap that vector with our
   // AAHR vector and continue until we run out of other's AAHRs.
-  std::vector<AxisAlignedHyperRectangle> deltas;
+  AAHRList deltas;
   for (auto& b: other.aahrs_)
   {
     for (auto& a: aahrs_)
     {
-      auto diff = a.MultiSubtract(b);
-      deltas.insert(deltas.end(), diff.begin(), diff.end());
+      a.MultiSubtract(b, deltas);
     }
-    std::swap(deltas, aahrs_);
+    aahrs_.swap(deltas);
     deltas.clear();
   }
 }
@@ -235,6 +247,17 @@ bool MultiAAHR::operator == (const MultiAAHR& s) const
   return true;
 }
 
+std::size_t MultiAAHR::Hash() const
+{
+  // Commutative combination, since operator == ignores AAHR order.
+  std::size_t seed = aahrs_.size();
+  for (auto& a: aahrs_)
+  {
+    seed += a.Hash() * 0x9e3779b97f4a7c15ull;
+  }
+  return seed;
+}
+
 Point MultiAAHR::GetTranslation(const MultiAAHR& s) const
 {
   // We're computing translation from (this) -> (s).
@@ -312,7 +335,7 @@ void MultiAAHR::Translate(const Point& p)
 std::vector<AxisAlignedHyperRectangle> MultiAAHR::GetAAHRs() const
 {
   assert(aahrs_.size() != 0);
-  return aahrs_;
+  return std::vector<AxisAlignedHyperRectangle>(aahrs_.begin(), aahrs_.end());
 }
 
 std::ostream& operator << (std::ostream& out, const MultiAAHR& m)
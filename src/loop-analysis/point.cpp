@@ -40,24 +40,36 @@ Point::Point(const Point& p) :
 {
 }
 
+Point::Point(Point&& p) noexcept :
+    order_(p.order_),
+    coordinates_(std::move(p.coordinates_))
+{
+}
+
 Point::Point(std::uint32_t order) :
-    order_(order)
+    order_(order),
+    coordinates_(order, 0)
 {
-  coordinates_.resize(order_);
-  Reset();
 }
 
 
 Point::Point(std::vector<Coordinate> coordinates) : 
   order_(coordinates.size()),
-  coordinates_(coordinates)
+  coordinates_(coordinates.begin(), coordinates.end())
 {
 }
   
-// Copy-and-swap idiom.
-Point& Point::operator = (Point other)
+Point& Point::operator = (const Point& other)
+{
+  order_ = other.order_;
+  coordinates_ = other.coordinates_;
+  return *this;
+}
+
+Point& Point::operator = (Point&& other) noexcept
 {
-  swap(*this, other);
+  order_ = other.order_;
+  coordinates_ = std::move(other.coordinates_);
   return *this;
 }
 
@@ -108,7 +120,7 @@ std::uint32_t Point::Order() const
 
 std::vector<Coordinate> Point::GetCoordinates() const
 {
-  return coordinates_;
+  return std::vector<Coordinate>(coordinates_.begin(), coordinates_.end());
 }
 
 Coordinate& Point::operator[] (std::uint32_t i)
@@ -205,7 +205,7 @@ isl_stat ComputeMulticastScatterHops(isl_set* p_domain,
   ));
 
   auto p_time_to_data = isl_set_unwrap(p_domain);
-  auto p_accesses_pw_qp = isl_pw_qpolynomial_sum(isl_map_card(p_time_to_data));
+  auto p_accesses_pw_qp = isl::pw_qpolynomial_sum(isl::map_card(p_time_to_data));
   if (isl_pw_qpolynomial_isa_qpolynomial(p_accesses_pw_qp) == isl_bool_false)
   {
     throw std::runtime_error("accesses is not a single qpolynomial");
@@ -255,7 +255,7 @@ SimpleMulticastModel::Apply(
   ));
   auto wrapped_fill = isl::manage(p_wrapped_fill);
 
-  auto p_multicast_factor = isl_map_card(wrapped_fill.copy());
+  auto p_multicast_factor = isl::map_card(wrapped_fill.copy());
 
   isl_pw_qpolynomial* p_hops = nullptr;
   if (count_hops_)
@@ -341,20 +341,20 @@ SimpleMulticastModel::Apply(
 
   auto total_accesses = isl::val_to_double(isl_qpolynomial_get_constant_val(
     isl_pw_qpolynomial_as_qpolynomial(
-      isl_set_card(isl_pw_qpolynomial_domain(
+      isl::set_card(isl_pw_qpolynomial_domain(
         isl_pw_qpolynomial_copy(p_multicast_factor)
       ))
     )
   ));
 
-  auto p_total_hops = isl_pw_qpolynomial_sum(isl_pw_qpolynomial_sum(
+  auto p_total_hops = isl::pw_qpolynomial_sum(isl::pw_qpolynomial_sum(
     isl_pw_qpolynomial_copy(p_hops)
   ));
   auto total_hops = isl::val_to_double(isl_qpolynomial_get_constant_val(
     isl_pw_qpolynomial_as_qpolynomial(p_total_hops)
   ));
 
-  auto p_total_multicast = isl_pw_qpolynomial_sum(isl_pw_qpolynomial_sum(
+  auto p_total_multicast = isl::pw_qpolynomial_sum(isl::pw_qpolynomial_sum(
     p_multicast_factor
   ));
   auto total_multicast = isl::val_to_double(isl_qpolynomial_get_constant_val(
@@ -505,6 +505,29 @@ std::vector<MapSpace*> Ruby::Split(std::uint64_t num_splits)
   return retval;
 }
 
+//
+// Replicate the mapspace (used for dynamic parallelization).
+//
+std::vector<MapSpace*> Ruby::Replicate(std::uint64_t num_replicas)
+{
+  assert(size_[int(mapspace::Dimension::IndexFactorization)] > 0);
+  assert(num_replicas > 0);
+
+  std::vector<Ruby*> splits;
+  std::vector<MapSpace*> retval;
+  for (unsigned i = 0; i < num_replicas; i++)
+  {
+    Ruby* mapspace = new Ruby(*this);
+    mapspace->InitSplit(0, size_[int(mapspace::Dimension::IndexFactorization)], 1);
+
+    splits.push_back(mapspace);
+    retval.push_back(static_cast<MapSpace*>(mapspace));
+  }
+
+  splits_ = splits;
+  return retval;
+}
+
 void Ruby::InitSplit(std::uint64_t split_id, uint128_t split_if_size, std::uint64_t num_parent_splits)
 {
   split_id_ = split_id;
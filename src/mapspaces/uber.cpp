@@ -492,6 +492,29 @@ std::vector<MapSpace*> Uber::Split(std::uint64_t num_splits)
   return retval;
 }
 
+//
+// Replicate the mapspace (used for dynamic parallelization).
+//
+std::vector<MapSpace*> Uber::Replicate(std::uint64_t num_replicas)
+{
+  assert(size_[int(mapspace::Dimension::IndexFactorization)] > 0);
+  assert(num_replicas > 0);
+
+  std::vector<Uber*> splits;
+  std::vector<MapSpace*> retval;
+  for (unsigned i = 0; i < num_replicas; i++)
+  {
+    Uber* mapspace = new Uber(*this);
+    mapspace->InitSplit(0, size_[int(mapspace::Dimension::IndexFactorization)], 1);
+
+    splits.push_back(mapspace);
+    retval.push_back(static_cast<MapSpace*>(mapspace));
+  }
+
+  splits_ = splits;
+  return retval;
+}
+
 void Uber::InitSplit(std::uint64_t split_id, uint128_t split_if_size, std::uint64_t num_parent_splits)
 {
   split_id_ = split_id;
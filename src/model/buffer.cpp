@@ -25,8 +25,10 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <numeric>
 #include <string>
 
@@ -44,6 +46,32 @@ BOOST_CLASS_EXPORT(model::BufferLevel)
 
 // #define DEBUG
 
+bool gEnableSlowdownCache =
+  (getenv("TIMELOOP_DISABLE_SLOWDOWN_CACHE") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_SLOWDOWN_CACHE"), "0") == 0);
+
+// Upper bound on memoized slowdown results per buffer level; the cache is
+// flushed when it is reached.
+static const std::size_t kMaxSlowdownCacheEntries = 1 << 16;
+
+// Imperfect-factorization cases whose weight falls below this tolerance are
+// left out of the slowdown expectation. The default of 0 keeps every case.
+double gSlowdownWeightTolerance =
+  (getenv("TIMELOOP_SLOWDOWN_WEIGHT_TOLERANCE") == NULL) ? 0.0 :
+  atof(getenv("TIMELOOP_SLOWDOWN_WEIGHT_TOLERANCE"));
+
+// Count the tile types of each rank group once per sub-bitmask of its own
+// imperfect ranks instead of once per imperfect-factorization case.
+bool gFactoredTileTypeCounting =
+  (getenv("TIMELOOP_DISABLE_FACTORED_TILE_COUNTING") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_FACTORED_TILE_COUNTING"), "0") == 0);
+
+// Count tile types over one period of the interior tiles of each dimension
+// instead of walking every tile.
+bool gPeriodicTileTypeCounting =
+  (getenv("TIMELOOP_DISABLE_PERIODIC_TILE_COUNTING") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_PERIODIC_TILE_COUNTING"), "0") == 0);
+
 namespace model
 {
 
@@ -834,6 +862,55 @@ namespace model
   {
     (void)break_on_failure;
 
+    return PreEvaluationCheck(RequiredCapacities(working_set_sizes, workload, per_level_compression_info,
+                                                 confidence_threshold),
+                              mask, workload);
+  }
+
+  problem::PerDataSpace<std::size_t>
+  BufferLevel::RequiredCapacities(
+      const problem::PerDataSpace<std::size_t>& working_set_sizes,
+      const problem::Workload *workload,
+      const sparse::PerStorageLevelCompressionInfo& per_level_compression_info,
+      const double confidence_threshold)
+  {
+    problem::PerDataSpace<std::size_t> required_capacities;
+    required_capacities.fill(0);
+
+    // Only sized buffers are checked.
+    if (!specs_.size.IsSpecified())
+    {
+      return required_capacities;
+    }
+
+    double confidence_constraint = !specs_.allow_overbooking.Get() ? 1.0 : confidence_threshold;
+    for (unsigned pvi = 0;
+         pvi < unsigned(workload->GetShape()->NumDataSpaces); pvi++)
+    {
+      auto dense_working_set_size = working_set_sizes.at(problem::Shape::DataSpaceID(pvi));
+      auto working_set_size = dense_working_set_size;
+
+      if (per_level_compression_info.find(pvi) != per_level_compression_info.end() && per_level_compression_info.at(pvi).tensor_compressed)
+      {
+        working_set_size = workload->GetDensity(pvi)
+                               ->GetMaxTileOccupancyByConfidence_LTW(
+                                   dense_working_set_size, confidence_constraint);
+      }
+      else
+      {
+        working_set_size = ceil(dense_working_set_size * confidence_constraint);
+      }
+      required_capacities[pvi] = working_set_size;
+    }
+
+    return required_capacities;
+  }
+
+  EvalStatus
+  BufferLevel::PreEvaluationCheck(
+      const problem::PerDataSpace<std::size_t>& required_capacities,
+      const tiling::CompoundMask& mask, const problem::Workload *workload)
+  {
     bool success = true;
     std::ostringstream fail_reason;
 
@@ -852,28 +929,12 @@ namespace model
 
       // Find the total capacity required by all un-masked data types.
       std::size_t required_capacity = 0;
-      double confidence_constraint = !specs_.allow_overbooking.Get() ? 1.0 : confidence_threshold;
       for (unsigned pvi = 0;
            pvi < unsigned(workload->GetShape()->NumDataSpaces); pvi++)
       {
         if (mask[pvi])
         {
-          auto dense_working_set_size = working_set_sizes.at(problem::Shape::DataSpaceID(pvi));
-          auto working_set_size = dense_working_set_size;
-
-          std::string data_space_name = workload->GetShape()->DataSpaceIDToName.at(pvi);
-
-          if (per_level_compression_info.find(pvi) != per_level_compression_info.end() && per_level_compression_info.at(pvi).tensor_compressed)
-          {
-            working_set_size = workload->GetDensity(pvi)
-                                   ->GetMaxTileOccupancyByConfidence_LTW(
-                                       dense_working_set_size, confidence_constraint);
-          }
-          else
-          {
-            working_set_size = ceil(dense_working_set_size * confidence_constraint);
-          }
-          required_capacity += working_set_size;
+          required_capacity += required_capacities.at(problem::Shape::DataSpaceID(pvi));
         }
       }
 
@@ -900,161 +961,220 @@ namespace model
     return eval_status;
   }
 
-
-  unsigned
-  BufferLevel::FindRankGroupRepresentative(std::vector<unsigned>& rep, unsigned idx)
-  {
-    if (rep[idx] != idx)
-    {
-      rep[idx] = FindRankGroupRepresentative(rep, rep[idx]);
-    }
-    return rep[idx];
-  }
-
-  std::pair<std::vector<std::vector<std::string>>,
-  std::vector<std::vector<problem::Shape::FlattenedDimensionID>>>
-  BufferLevel::GroupRelatedRanks(const layout::Layout layout)
+  //
+  // A group is coupled to the other groups through the critical path of every
+  // combined tile type as soon as its own tile types change with its bits.
+  //
+  std::uint32_t
+  BufferLevel::CoupledImperfectBits(
+    const std::vector<std::unordered_map<std::uint32_t, TileTypeHistogram>>& group_tile_types,
+    const std::vector<std::uint32_t>& group_imperfect_bits)
   {
-    std::vector<std::vector<std::string>> rank_groups;
-    std::vector<std::vector<problem::Shape::FlattenedDimensionID>> dim_groups;
-    std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned> dim_to_rank_group;
-    std::vector<unsigned> rep;
-    std::vector<unsigned> rep_to_group_id;
-    for (auto [r, dimsID] : layout.rankToFactorizedDimensionID)
+    std::uint32_t coupled_bits = 0;
+    for (unsigned gid = 0; gid < group_imperfect_bits.size(); gid++)
     {
-      auto g = dimsID[0];
-      if (dim_to_rank_group.count(g) == 0)
-      {
-        dim_to_rank_group[g] = rep.size();
-        rep.push_back(rep.size());
-      }
-
-      for (auto d : dimsID)
+      auto& memo = group_tile_types[gid];
+      auto base = memo.find(0);
+      for (auto& [group_bitmask, histogram] : memo)
       {
-        if (dim_to_rank_group.count(d) == 0)
+        if (base == memo.end() || histogram != base->second)
         {
-          dim_to_rank_group[d] = rep.size();
-          rep.push_back(rep.size());
+          coupled_bits |= group_imperfect_bits[gid];
+          break;
         }
-        rep[FindRankGroupRepresentative(rep, dim_to_rank_group[d])] = FindRankGroupRepresentative(rep, dim_to_rank_group[g]);
-      }
-    }
-    rep_to_group_id.resize(rep.size());
-    for (unsigned i = 0; i < rep.size(); i++)
-    {
-      if(rep[i] == i)
-      {
-        rep_to_group_id[i] = rank_groups.size();
-        rank_groups.push_back({});
       }
     }
-    for (auto [r, dimsID] : layout.rankToFactorizedDimensionID)
-    {
-      auto g = FindRankGroupRepresentative(rep, dim_to_rank_group[dimsID[0]]);
-      rank_groups[rep_to_group_id[g]].push_back(r);
-    }
-    dim_groups.resize(rank_groups.size());
-    for (auto [d, g_rep] : dim_to_rank_group)
-    {
-      g_rep = FindRankGroupRepresentative(rep, g_rep);
-      dim_groups[rep_to_group_id[g_rep]].push_back(d);
-    }
-    return {rank_groups, dim_groups};
+    return coupled_bits;
   }
 
-
-  std::map<BufferLevel::TileTypeDescriptor, int>
+  //
+  // Tile types only depend on a dimension's iteration index through whether it
+  // is the first iteration, whether the rank positions it feeds are clamped by
+  // zero padding or by the end of the rank, and the rank positions modulo each
+  // rank's binding parallelism (the line factor). Away from both edges the
+  // types therefore repeat with period lcm(B / gcd(jump, B)) over the ranks
+  // using the dimension, so only the edge iterations and one period of the
+  // interior are walked, each weighted by the number of iterations it stands for.
+  //
+  BufferLevel::TileTypeHistogram
   BufferLevel::CountPerGroupTileTypes(const layout::Layout& layout,
-                                      std::vector<std::string>& ranks,
-                                      std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                                      std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                                      std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                                      std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                                      const layout::RankTable& rank_table,
+                                      const std::vector<unsigned>& ranks,
+                                      const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                                      const std::vector<int>& rank_id_to_mapping_parallelism,
+                                      const std::vector<int>& rank_id_to_binding_parallelism,
+                                      const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                                       std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                                       std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace)
   {
-    std::map<TileTypeDescriptor, int> cnt_tile_types;
+    std::unordered_map<TileTypeDescriptor, int, TileTypeDescriptorHash> cnt_tile_types;
     std::vector<unsigned> dims_it(dims.size(), 0);
     std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned> dim_it_idx;
     for (unsigned i = 0; i < dims.size(); i++)
     {
       dim_it_idx[dims[i]] = i;
     }
-    CountPerGroupTileTypesRecursive(layout, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
+
+    // (iteration, number of iterations it stands for) per dimension.
+    std::vector<std::vector<std::pair<unsigned, int>>> dim_iterations(dims.size());
+    for (unsigned i = 0; i < dims.size(); i++)
+    {
+      int num_tiles = std::max(dim_id_to_number_of_tiles[dims[i]], 1);
+      // Iterations below head and the last tail ones are walked one by one.
+      int head = 1;
+      int tail = 0;
+      std::int64_t period = 1;
+      bool periodic = gPeriodicTileTypeCounting;
+      for (unsigned r = 0; r < ranks.size() && periodic; r++)
+      {
+        unsigned rid = ranks[r];
+        auto& dimsID = rank_table.dims[rid];
+        auto& dim_jumps = rank_id_to_dim_jumps[rid];
+        auto dim_pos = std::find(dimsID.begin(), dimsID.end(), dims[i]);
+        if (dim_pos == dimsID.end())
+        {
+          continue;
+        }
+        int jump = dim_jumps[dim_pos - dimsID.begin()];
+        int max_jump = *std::max_element(dim_jumps.begin(), dim_jumps.end());
+        if (jump < 0 || *std::min_element(dim_jumps.begin(), dim_jumps.end()) < 0)
+        {
+          periodic = false;
+          break;
+        }
+        if (jump == 0)
+        {
+          continue;
+        }
+        int binding_parallelism = std::max(rank_id_to_binding_parallelism[rid], 1);
+        int zero_padding = 0;
+        if (layout.assume_zero_padding && specs_.technology.Get() == Technology::DRAM)
+        {
+          zero_padding = rank_table.zero_padding[rid];
+        }
+        // Past the head the rank position is at least max_jump beyond the
+        // padding, and before the tail it cannot reach the end of the rank.
+        head = std::max(head, (zero_padding + max_jump + jump - 1) / jump);
+        tail = std::max(tail, (zero_padding + jump - 1) / jump);
+        period = std::lcm(period, (std::int64_t)(binding_parallelism / std::gcd(jump, binding_parallelism)));
+        if (period >= num_tiles)
+        {
+          periodic = false;
+        }
+      }
+
+      auto& iterations = dim_iterations[i];
+      int interior = num_tiles - head - tail;
+      if (!periodic || interior <= period)
+      {
+        for (int it = 0; it < num_tiles; it++)
+        {
+          iterations.emplace_back(it, 1);
+        }
+        continue;
+      }
+      for (int it = 0; it < head; it++)
+      {
+        iterations.emplace_back(it, 1);
+      }
+      for (int it = 0; it < period; it++)
+      {
+        iterations.emplace_back(head + it, interior / period + (it < interior % period ? 1 : 0));
+      }
+      for (int it = num_tiles - tail; it < num_tiles; it++)
+      {
+        iterations.emplace_back(it, 1);
+      }
+    }
+
+    CountPerGroupTileTypesRecursive(layout, rank_table, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
                                     rank_id_to_dim_jumps, dim_id_to_number_of_tiles, per_dataspace,
-                                    dim_it_idx, dims_it, 0, cnt_tile_types);
-    return cnt_tile_types;
+                                    dim_it_idx, dim_iterations, dims_it, 0, 1, cnt_tile_types);
+
+    TileTypeHistogram histogram(cnt_tile_types.begin(), cnt_tile_types.end());
+    std::sort(histogram.begin(), histogram.end(),
+              [](const std::pair<TileTypeDescriptor, int>& a, const std::pair<TileTypeDescriptor, int>& b)
+              { return a.first < b.first; });
+    return histogram;
   }
 
   void
   BufferLevel::CountPerGroupTileTypesRecursive(const layout::Layout& layout,
-                                               std::vector<std::string>& ranks,
-                                               std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                                               std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                                               std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                                               std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                                               const layout::RankTable& rank_table,
+                                               const std::vector<unsigned>& ranks,
+                                               const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                                               const std::vector<int>& rank_id_to_mapping_parallelism,
+                                               const std::vector<int>& rank_id_to_binding_parallelism,
+                                               const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                                                std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                                                std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                                std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned>& dim_it_idx,
+                                               const std::vector<std::vector<std::pair<unsigned, int>>>& dim_iterations,
                                                std::vector<unsigned>& dims_it,
                                                unsigned dim_idx,
-                                               std::map<TileTypeDescriptor, int>& cnt_tile_types)
+                                               int cnt,
+                                               std::unordered_map<TileTypeDescriptor, int, TileTypeDescriptorHash>& cnt_tile_types)
   {
-    for (dims_it[dim_idx] = 0; dims_it[dim_idx] < (unsigned)std::max(dim_id_to_number_of_tiles[dims[dim_idx]], 1); dims_it[dim_idx]++)
+    for (auto& [it, it_cnt] : dim_iterations[dim_idx])
     {
+      dims_it[dim_idx] = it;
       if (dim_idx+1 < dims.size())
       {
-        CountPerGroupTileTypesRecursive(layout, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
+        CountPerGroupTileTypesRecursive(layout, rank_table, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
                                         rank_id_to_dim_jumps, dim_id_to_number_of_tiles, per_dataspace,
-                                        dim_it_idx, dims_it, dim_idx+1, cnt_tile_types);
+                                        dim_it_idx, dim_iterations, dims_it, dim_idx+1, cnt*it_cnt, cnt_tile_types);
       }
       else
       {
-        CountPerGroupTileTypesBase(layout, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
+        CountPerGroupTileTypesBase(layout, rank_table, ranks, dims, rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
                                    rank_id_to_dim_jumps, dim_id_to_number_of_tiles, per_dataspace,
-                                   dim_it_idx, dims_it, cnt_tile_types);
+                                   dim_it_idx, dims_it, cnt*it_cnt, cnt_tile_types);
       }
     }
   }
 
   void
   BufferLevel::CountPerGroupTileTypesBase(const layout::Layout& layout,
-                                          std::vector<std::string>& ranks,
-                                          std::vector<problem::Shape::FlattenedDimensionID>& dims,
-                                          std::unordered_map<std::string, int>& rank_id_to_mapping_parallelism,
-                                          std::unordered_map<std::string, int>& rank_id_to_binding_parallelism,
-                                          std::unordered_map<std::string, std::vector<int>>& rank_id_to_dim_jumps,
+                                          const layout::RankTable& rank_table,
+                                          const std::vector<unsigned>& ranks,
+                                          const std::vector<problem::Shape::FlattenedDimensionID>& dims,
+                                          const std::vector<int>& rank_id_to_mapping_parallelism,
+                                          const std::vector<int>& rank_id_to_binding_parallelism,
+                                          const std::vector<std::vector<int>>& rank_id_to_dim_jumps,
                                           std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
                                           std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                           std::unordered_map<problem::Shape::FlattenedDimensionID, unsigned>& dim_it_idx,
                                           std::vector<unsigned>& dims_it,
-                                          std::map<TileTypeDescriptor, int>& cnt_tile_types)
+                                          int cnt,
+                                          std::unordered_map<TileTypeDescriptor, int, TileTypeDescriptorHash>& cnt_tile_types)
   {
     TileTypeDescriptor tile_type_desc;
     tile_type_desc.dataspace_mask = std::vector<bool>(per_dataspace.size(), true);
     tile_type_desc.dataspace_rb = std::vector<bool>(per_dataspace.size(), false);
     tile_type_desc.first_tile = true;
+    tile_type_desc.num_lines.reserve(ranks.size());
     for (unsigned r = 0; r < ranks.size(); r++)
     {
-      int binding_parallelism = std::max(rank_id_to_binding_parallelism[ranks[r]], 1);
-      int mapping_parallelism = std::max(rank_id_to_mapping_parallelism[ranks[r]], 1);
+      unsigned rid = ranks[r];
+      int binding_parallelism = std::max(rank_id_to_binding_parallelism[rid], 1);
+      int mapping_parallelism = std::max(rank_id_to_mapping_parallelism[rid], 1);
 
       int zero_padding = 0;
-      if (layout.assume_zero_padding && specs_.technology.Get() == Technology::DRAM && 
-          layout.rankToZeroPadding.find(ranks[r]) != layout.rankToZeroPadding.end())
-      { // rank has zero padding
-        zero_padding = layout.rankToZeroPadding.at(ranks[r]);
+      if (layout.assume_zero_padding && specs_.technology.Get() == Technology::DRAM)
+      { // zero for ranks without padding
+        zero_padding = rank_table.zero_padding[rid];
       }
 
-      auto& dimsID = layout.rankToFactorizedDimensionID.at(ranks[r]);
+      auto& dimsID = rank_table.dims[rid];
+      auto& dim_jumps = rank_id_to_dim_jumps[rid];
       int rank_pos = 0;
       int total_size = mapping_parallelism;
       for (unsigned d = 0; d < dimsID.size(); d++)
       {
         if (dims_it[dim_it_idx[dimsID[d]]] != 0)
           tile_type_desc.first_tile = false;
-        rank_pos += rank_id_to_dim_jumps[ranks[r]][d] * dims_it[dim_it_idx[dimsID[d]]];
-        total_size += rank_id_to_dim_jumps[ranks[r]][d] * (std::max(dim_id_to_number_of_tiles[dimsID[d]], 1) - 1);
+        rank_pos += dim_jumps[d] * dims_it[dim_it_idx[dimsID[d]]];
+        total_size += dim_jumps[d] * (std::max(dim_id_to_number_of_tiles[dimsID[d]], 1) - 1);
       }
       tile_type_desc.num_lines.push_back((std::min(rank_pos + mapping_parallelism, total_size - zero_padding) - zero_padding + binding_parallelism-1) / binding_parallelism
                           - std::max(rank_pos - zero_padding, 0) / binding_parallelism);
@@ -1067,7 +1187,7 @@ namespace model
           {
             if (dimsID[d] == ds.reused_dim_id &&
                 dims_it[dim_it_idx[ds.reused_dim_id]] > 0 &&
-                std::max(rank_pos - zero_padding, 0) / binding_parallelism < (rank_pos - rank_id_to_dim_jumps[ranks[r]][d] + mapping_parallelism - zero_padding + binding_parallelism-1) / binding_parallelism)
+                std::max(rank_pos - zero_padding, 0) / binding_parallelism < (rank_pos - dim_jumps[d] + mapping_parallelism - zero_padding + binding_parallelism-1) / binding_parallelism)
             {
               tile_type_desc.dataspace_rb[data_space_id] = true;
             }
@@ -1086,20 +1206,42 @@ namespace model
         }
       }
     }
-    cnt_tile_types[tile_type_desc]++;
+    cnt_tile_types[tile_type_desc] += cnt;
+  }
+
+  std::size_t
+  BufferLevel::TileTypeDescriptorHash::operator()(const TileTypeDescriptor& desc) const
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](std::uint64_t value)
+    {
+      hash ^= value;
+      hash *= 1099511628211ULL;
+    };
+    mix(desc.first_tile);
+    for (auto num_lines : desc.num_lines)
+    {
+      mix(static_cast<std::uint64_t>(num_lines));
+    }
+    for (unsigned i = 0; i < desc.dataspace_mask.size(); i++)
+    {
+      mix(desc.dataspace_mask[i] | (i < desc.dataspace_rb.size() && desc.dataspace_rb[i] ? 2 : 0));
+    }
+    return hash;
   }
 
 
   BufferLevel::LatencyStats
   BufferLevel::CheckTileTypes(const layout::Layout& layout,
+                              const layout::RankTable& rank_table,
                               const crypto::CryptoConfig *crypto_config,
                               const tiling::CompoundMask &mask,
-                              std::vector<std::vector<std::string>>& rank_groups,
-                              std::vector<std::map<TileTypeDescriptor, int>>& cnt_tile_types,
+                              const std::vector<std::vector<unsigned>>& rank_groups,
+                              const std::vector<const TileTypeHistogram*>& cnt_tile_types,
                               std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                               uint64_t compute_cycles)
   {
-    std::unordered_map<std::string, int> rank_id_to_lines;
+    std::vector<int> rank_id_to_lines(rank_table.NumRanks(), 0);
     std::vector<bool> dataspace_rb(per_dataspace.size(), false);
     bool first_tile_possible = (specs_.technology.Get() == Technology::DRAM && layout.assume_warmup);
     auto latency_stats = CheckTileTypesRecursive(layout, crypto_config, mask, rank_groups, cnt_tile_types, per_dataspace, compute_cycles,
@@ -1115,11 +1257,11 @@ namespace model
   BufferLevel::CheckTileTypesRecursive(const layout::Layout& layout,
                                        const crypto::CryptoConfig *crypto_config,
                                        const tiling::CompoundMask &mask,
-                                       std::vector<std::vector<std::string>>& rank_groups,
-                                       std::vector<std::map<TileTypeDescriptor, int>>& cnt_tile_types,
+                                       const std::vector<std::vector<unsigned>>& rank_groups,
+                                       const std::vector<const TileTypeHistogram*>& cnt_tile_types,
                                        std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                        uint64_t compute_cycles,
-                                       std::unordered_map<std::string, int>& rank_id_to_lines,
+                                       std::vector<int>& rank_id_to_lines,
                                        std::vector<bool> dataspace_rb,
                                        uint64_t cur_cnt,
                                        bool first_tile_possible,
@@ -1127,7 +1269,7 @@ namespace model
   {
     LatencyStats latency_stats = {0, 0, 0};
     std::vector<bool> dataspace_rb_new = dataspace_rb;
-    auto& cur_group_tile_types = cnt_tile_types[group_it_idx];
+    auto& cur_group_tile_types = *cnt_tile_types[group_it_idx];
     auto& cur_ranks = rank_groups[group_it_idx];
     for (auto &[tile_type_desc, cnt] : cur_group_tile_types)
     {
@@ -1166,7 +1308,7 @@ namespace model
                                   const tiling::CompoundMask &mask,
                                   std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace,
                                   uint64_t compute_cycles,
-                                  std::unordered_map<std::string, int>& rank_id_to_lines,
+                                  const std::vector<int>& rank_id_to_lines,
                                   std::vector<bool> dataspace_rb,
                                   uint64_t cur_cnt,
                                   bool first_tile)
@@ -1188,9 +1330,9 @@ namespace model
         continue;
       }
       double lines = 1;
-      for (auto &r : layout.intraline[data_space_id].ranks)
+      for (auto rid : ds.intraline_rank_ids)
       {
-        lines *= rank_id_to_lines[r];
+        lines *= rank_id_to_lines[rid];
       }
       if (dataspace_rb[data_space_id])
       {
@@ -1279,35 +1421,161 @@ namespace model
   }
 
 
+  std::size_t
+  BufferLevel::SlowdownSignatureHash::operator()(const std::vector<std::int64_t>& signature) const
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto value : signature)
+    {
+      hash ^= static_cast<std::uint64_t>(value);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // Canonical encoding of every input that ComputeBankConflictSlowdownPerDataSpace()
+  // reads. Unordered containers are emitted in sorted key order, and every
+  // variable-length section is prefixed by its length.
+  std::vector<std::int64_t>
+  BufferLevel::SlowdownSignature(const layout::Layout& layout,
+                                 const layout::RankTable& rank_table,
+                                 const tiling::CompoundMask &mask,
+                                 const crypto::CryptoConfig *crypto_config,
+                                 uint64_t compute_cycles,
+                                 const std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>>& dim_id_to_mapping_parallelism,
+                                 const std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
+                                 const std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t>& dim_id_to_outer_size,
+                                 const std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace_base) const
+  {
+    std::vector<std::int64_t> signature;
+    signature.reserve(128);
+
+    signature.push_back(compute_cycles);
+    signature.push_back(layout.assume_zero_padding);
+    signature.push_back(layout.assume_row_buffer);
+    signature.push_back(layout.assume_warmup);
+    signature.push_back(layout.num_read_ports);
+
+    signature.push_back(crypto_config != nullptr);
+    if (crypto_config != nullptr)
+    {
+      signature.insert(signature.end(), {
+          crypto_config->crypto_initialized_, crypto_config->shared, crypto_config->number_engines,
+          crypto_config->datapath, crypto_config->auth_cycle_per_datapath, crypto_config->enc_cycle_per_datapath,
+          crypto_config->auth_additional_cycle_per_block, crypto_config->hash_size });
+    }
+
+    std::map<problem::Shape::FlattenedDimensionID, std::pair<int, int>> sorted_parallelism(
+      dim_id_to_mapping_parallelism.begin(), dim_id_to_mapping_parallelism.end());
+    signature.push_back(sorted_parallelism.size());
+    for (auto& [d, parallelism] : sorted_parallelism)
+    {
+      signature.insert(signature.end(), { d, parallelism.first, parallelism.second });
+    }
+    std::map<problem::Shape::FlattenedDimensionID, int> sorted_tiles(
+      dim_id_to_number_of_tiles.begin(), dim_id_to_number_of_tiles.end());
+    signature.push_back(sorted_tiles.size());
+    for (auto& [d, tiles] : sorted_tiles)
+    {
+      signature.insert(signature.end(), { d, tiles });
+    }
+    std::map<problem::Shape::FlattenedDimensionID, std::uint64_t> sorted_outer_size(
+      dim_id_to_outer_size.begin(), dim_id_to_outer_size.end());
+    signature.push_back(sorted_outer_size.size());
+    for (auto& [d, outer_size] : sorted_outer_size)
+    {
+      signature.insert(signature.end(), { d, static_cast<std::int64_t>(outer_size) });
+    }
+
+    std::map<unsigned, const SlowdownIntermediateData*> sorted_dataspaces;
+    for (auto& [data_space_id, ds] : per_dataspace_base)
+    {
+      sorted_dataspaces[data_space_id] = &ds;
+    }
+    signature.push_back(sorted_dataspaces.size());
+    for (auto& [data_space_id, ds] : sorted_dataspaces)
+    {
+      bool has_authblock = data_space_id < layout.authblock_lines.size() &&
+                           !layout.authblock_lines[data_space_id].factors.empty();
+      signature.insert(signature.end(), {
+          data_space_id, mask[data_space_id], static_cast<std::int64_t>(ds->access_frequency), has_authblock,
+          workload_->GetShape()->IsReadWriteDataSpace.at(data_space_id) });
+
+      auto& intra_nest = layout.intraline[data_space_id];
+      signature.push_back(intra_nest.ranks.size());
+      for (auto& r : intra_nest.ranks)
+      {
+        auto intra_it = intra_nest.factors.find(r);
+        std::int64_t auth_factor = 1;
+        if (has_authblock)
+        {
+          auto& auth_factors = layout.authblock_lines[data_space_id].factors;
+          auto auth_it = auth_factors.find(r);
+          auth_factor = auth_it != auth_factors.end() ? auth_it->second : 1;
+        }
+        signature.insert(signature.end(), {
+            rank_table.ID(r), intra_it != intra_nest.factors.end() ? intra_it->second : 1, auth_factor });
+      }
+
+      std::map<problem::Shape::FlattenedDimensionID, int> sorted_loop_order(
+        ds->dim_id_to_outer_loop_order.begin(), ds->dim_id_to_outer_loop_order.end());
+      signature.push_back(sorted_loop_order.size());
+      for (auto& [d, order] : sorted_loop_order)
+      {
+        signature.insert(signature.end(), { d, order });
+      }
+      signature.push_back(ds->ineffective_dims.size());
+      signature.insert(signature.end(), ds->ineffective_dims.begin(), ds->ineffective_dims.end());
+    }
+
+    return signature;
+  }
+
   std::pair<double, double>
-  BufferLevel::ComputeBankConflictSlowdownPerDataSpace(const layout::Layout layout,
+  BufferLevel::ComputeBankConflictSlowdownPerDataSpace(const layout::Layout& layout,
+                                                       const layout::RankTable& rank_table,
                                                        const tiling::CompoundMask &mask,
                                                        const crypto::CryptoConfig *crypto_config,
                                                        uint64_t compute_cycles,
-                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>> dim_id_to_mapping_parallelism,
-                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, int> dim_id_to_number_of_tiles,
-                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t> dim_id_to_outer_size,
-                                                       std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace_base)
+                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, std::pair<int, int>>& dim_id_to_mapping_parallelism,
+                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, int>& dim_id_to_number_of_tiles,
+                                                       std::unordered_map<problem::Shape::FlattenedDimensionID, std::uint64_t>& dim_id_to_outer_size,
+                                                       std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace_base)
   {
+    std::vector<std::int64_t> signature;
+    if (gEnableSlowdownCache)
+    {
+      signature = SlowdownSignature(layout, rank_table, mask, crypto_config, compute_cycles,
+                                    dim_id_to_mapping_parallelism, dim_id_to_number_of_tiles,
+                                    dim_id_to_outer_size, per_dataspace_base);
+      auto cached = slowdown_cache_.find(signature);
+      if (cached != slowdown_cache_.end())
+      {
+        return cached->second;
+      }
+    }
+
+    const unsigned num_ranks = rank_table.NumRanks();
+
     // ****************************************************************
     // Step 0: Find All Ranks With Imperfect Factorization
     // ****************************************************************
 #ifdef DEBUG
     std::cout << " *** step 0 *** " << std::endl;
 #endif
-    std::vector<std::string> imperfect_ranks;
+    std::vector<unsigned> imperfect_ranks;
     for (auto &[data_space_id, ds] : per_dataspace_base)
     {
-      auto nest = layout.intraline[data_space_id];
-      for (const auto &r : nest.ranks)
+      ds.intraline_rank_ids = rank_table.IDs(layout.intraline[data_space_id].ranks);
+      for (auto rid : ds.intraline_rank_ids)
       {
-        auto dimsID = layout.rankToFactorizedDimensionID.at(r);
+        auto& dimsID = rank_table.dims[rid];
         for (unsigned index = 0; index < dimsID.size(); index++)
         {
           if (dim_id_to_mapping_parallelism[dimsID[index]].first !=
               dim_id_to_mapping_parallelism[dimsID[index]].second)
           {
-            imperfect_ranks.push_back(r);
+            imperfect_ranks.push_back(rid);
             break;
           }
         }
@@ -1320,26 +1588,31 @@ namespace model
     std::cout << "found " << imperfect_ranks.size()
               << " ranks with imperfect factorization" << std::endl;
 #endif
-    std::unordered_map<std::string, std::uint64_t> rank_id_to_outer_size;
-    for (const auto &r : imperfect_ranks) {
-      auto dimsID = layout.rankToFactorizedDimensionID.at(r);
+    // Position of each rank in imperfect_ranks, -1 for perfectly factorized ranks.
+    std::vector<int> rank_id_to_imperfect_idx(num_ranks, -1);
+    std::vector<std::uint64_t> rank_id_to_outer_size(num_ranks, 0);
+    for (unsigned i = 0; i < imperfect_ranks.size(); i++) {
+      unsigned rid = imperfect_ranks[i];
+      rank_id_to_imperfect_idx[rid] = i;
+      auto& dimsID = rank_table.dims[rid];
       bool found = false;
       for (unsigned index = 0; index < dimsID.size(); index++) {
         if (dim_id_to_outer_size.find(dimsID[index]) != dim_id_to_outer_size.end()) {
-          rank_id_to_outer_size.insert({r, dim_id_to_outer_size[dimsID[index]]});
+          rank_id_to_outer_size[rid] = dim_id_to_outer_size[dimsID[index]];
           found = true;
           break;
         }
       }
       if (!found) {
-        std::cout << "Failed to find imperfect rank " << r << std::endl;
+        std::cout << "Failed to find imperfect rank " << rank_table.names[rid] << std::endl;
       }
     }
 
     // ****************************************************************
     // Step 1: Get Binding Parallelism (What Layout Provide Per Cycle)
     // ****************************************************************
-    std::unordered_map<std::string, int> rank_id_to_binding_parallelism;
+    std::vector<int> rank_id_to_binding_parallelism(num_ranks, 0);
+    std::vector<bool> binding_parallelism_set(num_ranks, false);
 #ifdef DEBUG
      std::cout << " *** step 1 *** " << std::endl;
 #endif
@@ -1350,32 +1623,30 @@ namespace model
 #endif
       ds.auth_block_size = 1;
       ds.memory_line = 1;
-      auto intra_nest = layout.intraline[data_space_id];
+      rank_table.Factors(layout.intraline[data_space_id], intra_factors_);
+      const auto& intra_factors = intra_factors_;
 
-      // Check if authblock_lines has enough elements to safely access data_space_id
-      layout::LayoutNest auth_nest;
+      // authblock_lines may be missing for this data space; all factors are 1 then.
       if (data_space_id < layout.authblock_lines.size() &&
           !layout.authblock_lines[data_space_id].factors.empty()) {
-        auth_nest = layout.authblock_lines[data_space_id];
+        rank_table.Factors(layout.authblock_lines[data_space_id], auth_factors_);
       } else {
-        // Create a default auth_nest with empty factors if authblock_lines is not available
-        auth_nest.data_space = intra_nest.data_space;
-        auth_nest.type = "authblock_lines";
-        auth_nest.ranks = intra_nest.ranks;
-        // auth_nest.factors is left empty, so the .find() calls below will return .end()
+        auth_factors_.assign(num_ranks, 1);
       }
+      const auto& auth_factors = auth_factors_;
 
-      for (const auto &r : intra_nest.ranks) // Analyze slowdown per rank
+      for (auto rid : ds.intraline_rank_ids) // Analyze slowdown per rank
       {
-        int factor = (intra_nest.factors.find(r) != intra_nest.factors.end() ? intra_nest.factors.at(r) : 1);
+        int factor = intra_factors[rid];
         ds.memory_line *= factor;
-        factor *= (auth_nest.factors.find(r) != auth_nest.factors.end() ? auth_nest.factors.at(r) : 1);
+        factor *= auth_factors[rid];
         ds.auth_block_size *= factor;
-        if (rank_id_to_binding_parallelism.count(r) == 0)
+        if (!binding_parallelism_set[rid])
         {
-          rank_id_to_binding_parallelism[r] = factor;
+          rank_id_to_binding_parallelism[rid] = factor;
+          binding_parallelism_set[rid] = true;
 #ifdef DEBUG
-          std::cout << "RANK " << r << " factor=" << factor << std::endl;
+          std::cout << "RANK " << rank_table.names[rid] << " factor=" << factor << std::endl;
 #endif
         }
       }
@@ -1394,176 +1665,122 @@ namespace model
     // ****************************************************************
     // Step 2: Get All Mapping Parallelisms (What Mapping Requested)
     // ****************************************************************
+    // Every rank requests either the full mapping parallelism (.first) or,
+    // for imperfectly factorized ranks, the residual one (.second). Both
+    // variants and the per-dataspace reuse information do not depend on
+    // which imperfect ranks take their residual, so they are computed once
+    // here and selected per bitmask below.
 #ifdef DEBUG
     std::cout << " *** step 2 *** " << std::endl;
 #endif
-    int num_imperfect_ranks = imperfect_ranks.size();
-    std::vector<double> imperfect_weights((uint32_t)1 << num_imperfect_ranks);
-    std::vector<double> all_slowdowns((uint32_t)1 << num_imperfect_ranks);
-    std::vector<double> all_correction_ratios((uint32_t)1 << num_imperfect_ranks);
-    for (uint32_t bitmask = 0; bitmask < ((uint32_t)1 << num_imperfect_ranks); bitmask++) {
-      // Compute weight for this particular subset of imperfect ranks
-      double weight = 1.0;
-      for (int i = 0; i < num_imperfect_ranks; i++) {
-        if (bitmask & ((uint32_t)1 << i)) {
-          weight *= (1.0 / rank_id_to_outer_size[imperfect_ranks[i]]);
-        } else {
-          weight *= (1.0 - 1.0 / rank_id_to_outer_size[imperfect_ranks[i]]);
-        }
-      }
-      imperfect_weights[bitmask] = weight;
-
-      double total_data_requested = 0;
-      std::vector<std::string> rank_list;
-      std::unordered_map<std::string, int> rank_id_to_rank_list_index;
-      std::unordered_map<std::string, int> rank_id_to_number_of_tiles;
-      std::unordered_map<std::string, int> rank_id_to_mapping_parallelism;
-      std::unordered_map<std::string, std::vector<int>> rank_id_to_dim_jumps;
-
-      // Per dataspace arrays for current imperfect factorization bitmask
-      std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace = per_dataspace_base;
-
-      for (auto &[data_space_id, ds] : per_dataspace)
-      {
-        uint64_t data_requested_ds = 1;
-        auto nest = layout.intraline[data_space_id];
+    std::vector<int> rank_id_to_mapping_parallelism_variant[2] = {
+      std::vector<int>(num_ranks, 0), std::vector<int>(num_ranks, 0)
+    };
+    std::vector<std::vector<int>> rank_id_to_dim_jumps_variant[2] = {
+      std::vector<std::vector<int>>(num_ranks), std::vector<std::vector<int>>(num_ranks)
+    };
+    // Ranks whose requested data is attributed to each data space.
+    std::unordered_map<unsigned, std::vector<unsigned>> per_dataspace_counted_ranks;
+    std::vector<bool> rank_counted(num_ranks, false);
+    for (auto &[data_space_id, ds] : per_dataspace_base)
+    {
 #ifdef DEBUG
-        std::cout << "data_space_id = " << data_space_id << std::endl;
-        std::cout << nest.ranks.size() << std::endl;
+      std::cout << "data_space_id = " << data_space_id << std::endl;
+      std::cout << ds.intraline_rank_ids.size() << std::endl;
 #endif
-        ds.reused_rank_id = "";
-        ds.reused_dim_id = -1;
-        ds.reuse_max_order = -1;
-        for (const auto &r : nest.ranks) // Analyze slowdown per rank
+      auto& counted_ranks = per_dataspace_counted_ranks[data_space_id];
+      ds.reused_rank_id = -1;
+      ds.reused_dim_id = -1;
+      ds.reuse_max_order = -1;
+      for (auto rid : ds.intraline_rank_ids) // Analyze slowdown per rank
+      {
+        if (rank_counted[rid])
+        { // Skip already counted ranks
+          continue;
+        }
+        auto& dimsID = rank_table.dims[rid];
+        for (int variant = 0; variant < 2; variant++)
         {
-          if (rank_id_to_rank_list_index.count(r) != 0)
-          { // Skip already counted ranks
-            continue;
-          }
-          auto dimsID = layout.rankToFactorizedDimensionID.at(r);
+          bool use_residual = variant == 1;
           if (dimsID.size() == 1)
           {
-            if (ds.dim_id_to_outer_loop_order[dimsID[0]] < ds.reuse_max_order)
-            {
-              ds.reused_rank_id = r;
-              ds.reused_dim_id = dimsID[0];
-              ds.reuse_max_order = ds.dim_id_to_outer_loop_order[dimsID[0]];
-            }
-            int mapping_parallelism = std::max(dim_id_to_mapping_parallelism[dimsID[0]].first, 1);
+            auto& parallelism = dim_id_to_mapping_parallelism[dimsID[0]];
             // adjust mapping parallelism for imperfect ranks
-            auto imperfect_rank_it = find(imperfect_ranks.begin(), imperfect_ranks.end(), r);
-            if (imperfect_rank_it != imperfect_ranks.end())
-            {
-              int imperfect_rank_idx = imperfect_rank_it - imperfect_ranks.begin();
-              if (bitmask & ((uint32_t)1 << imperfect_rank_idx))
-              {
-                mapping_parallelism = std::max(dim_id_to_mapping_parallelism[dimsID[0]].second, 1);
-              }
-            }
-#ifdef DEBUG
-            std::cout << r << ": " << mapping_parallelism << std::endl;
-#endif
-            rank_id_to_dim_jumps[r].push_back(mapping_parallelism);
-            rank_id_to_mapping_parallelism[r] = mapping_parallelism;
-            rank_id_to_number_of_tiles[r] = std::max(dim_id_to_number_of_tiles[dimsID[0]], 1);
-            data_requested_ds *= mapping_parallelism;
-            rank_id_to_rank_list_index[r] = rank_list.size();
-            rank_list.push_back(r);
+            int mapping_parallelism = std::max(use_residual ? parallelism.second : parallelism.first, 1);
+            rank_id_to_dim_jumps_variant[variant][rid].push_back(mapping_parallelism);
+            rank_id_to_mapping_parallelism_variant[variant][rid] = mapping_parallelism;
           }
           else
           {
-            std::vector<std::uint32_t> coefficientValue = layout.rankToCoefficientValue.at(r);
-#ifdef DEBUG
-            std::cout << "rank:" << r << "  dimension: ";
-#endif
+            auto& coefficientValue = rank_table.coefficients[rid];
             int mapping_parallelism = 1;
-            int number_of_tiles = 1;
             for (unsigned index = 0; index < dimsID.size(); index++)
             {
-              if (ds.dim_id_to_outer_loop_order[dimsID[index]] < ds.reuse_max_order)
-              {
-                ds.reused_rank_id = r;
-                ds.reused_dim_id = dimsID[index];
-                ds.reuse_max_order = ds.dim_id_to_outer_loop_order[dimsID[index]];
-              }
-              int cur_mapping_parallelism = (std::max(dim_id_to_mapping_parallelism[dimsID[index]].first, 1) - 1) * int(coefficientValue[index]);
+              auto& parallelism = dim_id_to_mapping_parallelism[dimsID[index]];
               // adjust mapping parallelism for imperfect ranks
-              auto imperfect_rank_it = find(imperfect_ranks.begin(), imperfect_ranks.end(), r);
-              if (imperfect_rank_it != imperfect_ranks.end())
-              {
-                int imperfect_rank_idx = imperfect_rank_it - imperfect_ranks.begin();
-                if (bitmask & ((uint32_t)1 << imperfect_rank_idx))
-                {
-                  cur_mapping_parallelism = (std::max(dim_id_to_mapping_parallelism[dimsID[index]].second, 1) - 1) * int(coefficientValue[index]);
-                }
-              }
+              int cur_mapping_parallelism = (std::max(use_residual ? parallelism.second : parallelism.first, 1) - 1) * int(coefficientValue[index]);
               mapping_parallelism += cur_mapping_parallelism;
-              rank_id_to_dim_jumps[r].push_back(cur_mapping_parallelism + int(coefficientValue[index]));
-              number_of_tiles *= std::max(dim_id_to_number_of_tiles[dimsID[index]], 1); 
-#ifdef DEBUG
-              std::cout << dimsID[index] << " ";
-#endif
+              rank_id_to_dim_jumps_variant[variant][rid].push_back(cur_mapping_parallelism + int(coefficientValue[index]));
             }
-#ifdef DEBUG
-            std::cout << std::endl;
-#endif
-            rank_id_to_mapping_parallelism[r] = mapping_parallelism;
-            rank_id_to_number_of_tiles[r] = number_of_tiles;
-            data_requested_ds *= mapping_parallelism;
-            rank_id_to_rank_list_index[r] = rank_list.size();
-            rank_list.push_back(r);
+            rank_id_to_mapping_parallelism_variant[variant][rid] = mapping_parallelism;
           }
         }
-        if (mask[data_space_id])
+        for (unsigned index = 0; index < dimsID.size(); index++)
         {
-          total_data_requested += (double)data_requested_ds / ds.access_frequency;
+          if (ds.dim_id_to_outer_loop_order[dimsID[index]] < ds.reuse_max_order)
+          {
+            ds.reused_rank_id = rid;
+            ds.reused_dim_id = dimsID[index];
+            ds.reuse_max_order = ds.dim_id_to_outer_loop_order[dimsID[index]];
+          }
         }
-      }
-
-      std::pair<double, double> result = ComputeBankConflictSlowdownIndividual(
-        layout, mask,
-        crypto_config, compute_cycles,
-        total_data_requested,
-        dim_id_to_number_of_tiles,
-        rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
-        rank_id_to_dim_jumps, per_dataspace);
-      all_slowdowns[bitmask] = result.first;
-      all_correction_ratios[bitmask] = result.second;
 #ifdef DEBUG
-      std::cout << "all_correction_ratios[" << bitmask << "] = " << result.second << std::endl;
+        std::cout << rank_table.names[rid] << ": " << rank_id_to_mapping_parallelism_variant[0][rid]
+                  << " (residual " << rank_id_to_mapping_parallelism_variant[1][rid] << ")" << std::endl;
 #endif
+        counted_ranks.push_back(rid);
+        rank_counted[rid] = true;
+      }
     }
 
-    double final_slowdown = 0.0, final_correction_ratio = 0.0;
-    for (uint32_t i = 0; i < (uint32_t)1 << num_imperfect_ranks; i++) {
-      final_slowdown += imperfect_weights[i] * all_slowdowns[i];
-      final_correction_ratio += imperfect_weights[i] * all_correction_ratios[i];
-    }
-
+    // ****************************************************************
+    // Step 2.5: Calculate latencies associated with the crypto engine
+    // ****************************************************************
+    for (auto &[data_space_id, ds] : per_dataspace_base)
+    {
+      double crypto_blocks_per_line = 0;
+      ds.crypto_latency_per_line = 0;
+      ds.crypto_hash_reads_per_line = 0;
+      // only consider crypto if config is provided AND only for offchip memory
+      // (DRAM) ToDo: can this be checked in a cleaner way?
+      bool has_authblock_factors = specs_.technology.Get() == Technology::DRAM || (data_space_id < layout.authblock_lines.size() &&
+                                    !layout.authblock_lines[data_space_id].factors.empty());
+      if (crypto_config != nullptr && crypto_config->crypto_initialized_ && has_authblock_factors) {
+        double word_size = specs_.word_bits.Get();
+        crypto_blocks_per_line = std::ceil((double)ds.auth_block_size * word_size /
+                                          (crypto_config->datapath));
+        ds.crypto_latency_per_line = crypto_blocks_per_line * (crypto_config->auth_cycle_per_datapath +
+                                  crypto_config->enc_cycle_per_datapath) +
+                                  (crypto_config->auth_additional_cycle_per_block);
+        // assume hashes are always consecutive and in lines of same size as
+        // specified by layout
+        ds.crypto_hash_reads_per_line =
+          crypto_blocks_per_line * (crypto_config->hash_size) / (specs_.block_size.Get() * word_size);
+      }
 #ifdef DEBUG
-    std::cout << "final slowdown current dataspace = " << final_slowdown
-              << std::endl;
-    std::cout << "final correction ratio = " << final_correction_ratio
-              << std::endl;
+      std::cout << "data_space_id:" << data_space_id
+                << std::endl;
+      std::cout << "memory_line:" << ds.memory_line
+                << std::endl;
+      std::cout << "auth_block_size:" << ds.auth_block_size
+                << std::endl;
+      std::cout << "crypto_latency_per_line:" << ds.crypto_latency_per_line
+                << std::endl;
+      std::cout << "crypto_hash_reads_per_line:" << ds.crypto_hash_reads_per_line
+                << std::endl;
 #endif
+    }
 
-    assert(layout.assume_row_buffer || final_correction_ratio <= 1);
-
-    return std::pair<double, double>{final_slowdown, final_correction_ratio};
-  }
-
-  std::pair<double, double> BufferLevel::ComputeBankConflictSlowdownIndividual(
-      const layout::Layout layout,
-      const tiling::CompoundMask &mask,
-      const crypto::CryptoConfig *crypto_config,
-      uint64_t compute_cycles,
-      double total_data_requested,
-      std::unordered_map<problem::Shape::FlattenedDimensionID, int> dim_id_to_number_of_tiles,
-      std::unordered_map<std::string, int> &rank_id_to_mapping_parallelism,
-      std::unordered_map<std::string, int> &rank_id_to_binding_parallelism,
-      std::unordered_map<std::string, std::vector<int>> &rank_id_to_dim_jumps,
-      std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace)
-  {
     // ****************************************************************
     // Step 3: Analyze "Average" Number of Lines Accessed Per Cycle
     // ****************************************************************
@@ -1576,96 +1793,255 @@ namespace model
     // zp_num_lines stores number of lines requested in the edge tiles (which
     // include zero padding) zp_mask is a bitmask with 1's for dimensions with
     // zero padding
-
+    //
+    // The tile types of a rank group only depend on which of the group's own
+    // imperfect ranks take their residual parallelism, so they are counted
+    // once per sub-bitmask of the group (sum of 2^k_g instead of 2^k times
+    // the number of groups) and shared across all bitmasks.
 #ifdef DEBUG
     std::cout << " *** step 3 *** " << std::endl;
 #endif
-
-    auto [rank_groups, dim_groups] = GroupRelatedRanks(layout);
-#ifdef DEBUG
+    auto& rank_groups = rank_table.rank_groups;
+    auto& dim_groups = rank_table.dim_groups;
+    int num_imperfect_ranks = imperfect_ranks.size();
+    std::vector<uint32_t> group_imperfect_bits(rank_groups.size(), 0);
     for (unsigned gid = 0; gid < rank_groups.size(); gid++)
     {
+      for (auto rid : rank_groups[gid])
+      {
+        if (rank_id_to_imperfect_idx[rid] >= 0)
+        {
+          group_imperfect_bits[gid] |= (uint32_t)1 << rank_id_to_imperfect_idx[rid];
+        }
+      }
+#ifdef DEBUG
       std::cout << "Group gid=" << gid << " ranks: ";
       for (auto r : rank_groups[gid])
       {
-        std::cout << r << " ";
+        std::cout << rank_table.names[r] << " ";
       }
       std::cout << " dims: ";
       for (auto r : dim_groups[gid])
       {
         std::cout << r << " ";
       }
-      std::cout << std::endl;
-    }
+      std::cout << " imperfect bits: " << group_imperfect_bits[gid] << std::endl;
 #endif
-    std::vector<std::map<TileTypeDescriptor, int>> cnt_tile_types;
-    for (unsigned gid = 0; gid < rank_groups.size(); gid++)
+    }
+    std::vector<std::unordered_map<uint32_t, TileTypeHistogram>> group_tile_types(rank_groups.size());
+    std::vector<int> rank_id_to_mapping_parallelism = rank_id_to_mapping_parallelism_variant[0];
+    std::vector<std::vector<int>> rank_id_to_dim_jumps = rank_id_to_dim_jumps_variant[0];
+    auto group_histogram = [&](unsigned gid, uint32_t group_bitmask) -> const TileTypeHistogram&
     {
-      cnt_tile_types.emplace_back(CountPerGroupTileTypes(layout, rank_groups[gid], dim_groups[gid],
-                                                         rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
-                                                         rank_id_to_dim_jumps, dim_id_to_number_of_tiles, per_dataspace));
-#ifdef DEBUG
-      std::cout << "Group gid=" << gid << std::endl;
-      for (auto &[vec_pair, cnt] : cnt_tile_types.back())
+      auto& memo = group_tile_types[gid];
+      auto it = memo.find(group_bitmask);
+      if (it == memo.end())
       {
-        std::cout << "[ ";
-        for (auto r : vec_pair.num_lines)
+        for (auto rid : rank_groups[gid])
         {
-          std::cout << r << ", ";
+          bool use_residual = rank_id_to_imperfect_idx[rid] >= 0 &&
+                              (group_bitmask & ((uint32_t)1 << rank_id_to_imperfect_idx[rid]));
+          rank_id_to_mapping_parallelism[rid] = rank_id_to_mapping_parallelism_variant[use_residual][rid];
+          rank_id_to_dim_jumps[rid] = rank_id_to_dim_jumps_variant[use_residual][rid];
         }
-        std::cout << "], [ ";
-        for (auto r : vec_pair.dataspace_mask)
+        it = memo.emplace(group_bitmask,
+                          CountPerGroupTileTypes(layout, rank_table, rank_groups[gid], dim_groups[gid],
+                                                 rank_id_to_mapping_parallelism, rank_id_to_binding_parallelism,
+                                                 rank_id_to_dim_jumps, dim_id_to_number_of_tiles, per_dataspace_base)).first;
+#ifdef DEBUG
+        std::cout << "Group gid=" << gid << " group_bitmask=" << group_bitmask << std::endl;
+        for (auto &[vec_pair, cnt] : it->second)
         {
-          std::cout << r << ", ";
+          std::cout << "[ ";
+          for (auto r : vec_pair.num_lines)
+          {
+            std::cout << r << ", ";
+          }
+          std::cout << "], [ ";
+          for (auto r : vec_pair.dataspace_mask)
+          {
+            std::cout << r << ", ";
+          }
+          std::cout << "], [ ";
+          for (auto r : vec_pair.dataspace_rb)
+          {
+            std::cout << r << ", ";
+          }
+          std::cout << "]: " << cnt << std::endl;
         }
-        std::cout << "], [ ";
-        for (auto r : vec_pair.dataspace_rb)
+#endif
+      }
+      return it->second;
+    };
+
+    // The slowdown only depends on the imperfect ranks through the tile
+    // types, and the correction ratio is linear in the data requested. The
+    // bits of groups whose tile types do not depend on them are therefore
+    // folded into an expected data request, and only the remaining (coupled)
+    // bits are enumerated jointly.
+    uint32_t all_imperfect_bits = ((uint32_t)1 << num_imperfect_ranks) - 1;
+    uint32_t coupled_bits = all_imperfect_bits;
+    if (gFactoredTileTypeCounting)
+    {
+      for (unsigned gid = 0; gid < rank_groups.size(); gid++)
+      {
+        uint32_t bits = group_imperfect_bits[gid];
+        for (uint32_t sub = bits; sub != 0; sub = (sub - 1) & bits)
         {
-          std::cout << r << ", ";
+          group_histogram(gid, sub);
         }
-        std::cout << "]: " << cnt << std::endl;
+        group_histogram(gid, 0);
       }
-#endif
+      coupled_bits = CoupledImperfectBits(group_tile_types, group_imperfect_bits);
     }
 
+    // Mapping parallelism of every rank for a given assignment of the
+    // coupled bits, in expectation over the uncoupled ones.
+    auto expected_parallelism = [&](unsigned rid, uint32_t bitmask)
+    {
+      int idx = rank_id_to_imperfect_idx[rid];
+      if (idx < 0)
+      {
+        return double(rank_id_to_mapping_parallelism_variant[0][rid]);
+      }
+      uint32_t bit = (uint32_t)1 << idx;
+      if (coupled_bits & bit)
+      {
+        return double(rank_id_to_mapping_parallelism_variant[(bitmask & bit) != 0][rid]);
+      }
+      double p = 1.0 / rank_id_to_outer_size[rid];
+      return (1.0 - p) * rank_id_to_mapping_parallelism_variant[0][rid] +
+        p * rank_id_to_mapping_parallelism_variant[1][rid];
+    };
+
     // ****************************************************************
-    // Step 3.5: Calculate latencies associated with the crypto engine
+    // Step 3.5: Weight Each Imperfect Factorization Case
     // ****************************************************************
-    for (auto &[data_space_id, ds] : per_dataspace)
-    {
-      double crypto_blocks_per_line = 0;
-      ds.crypto_latency_per_line = 0;
-      ds.crypto_hash_reads_per_line = 0;
-      // only consider crypto if config is provided AND only for offchip memory
-      // (DRAM) ToDo: can this be checked in a cleaner way?
-      bool has_authblock_factors = specs_.technology.Get() == Technology::DRAM || (data_space_id < layout.authblock_lines.size() &&
-                                    !layout.authblock_lines[data_space_id].factors.empty());
-      if (crypto_config != nullptr && crypto_config->crypto_initialized_ && has_authblock_factors) {
-        double word_size = specs_.word_bits.Get();
-        crypto_blocks_per_line = std::ceil((double)ds.auth_block_size * word_size /
-                                          (crypto_config->datapath));
-        ds.crypto_latency_per_line = crypto_blocks_per_line * (crypto_config->auth_cycle_per_datapath +
-                                  crypto_config->enc_cycle_per_datapath) +
-                                  (crypto_config->auth_additional_cycle_per_block);
-        // assume hashes are always consecutive and in lines of same size as
-        // specified by layout
-        ds.crypto_hash_reads_per_line =
-          crypto_blocks_per_line * (crypto_config->hash_size) / (specs_.block_size.Get() * word_size);
+    // Cases with a weight below gSlowdownWeightTolerance are skipped, except
+    // for the most likely case so that at least one is always evaluated. The
+    // remaining weights are renormalized. Only the coupled bits make a case.
+    std::vector<uint32_t> cases;
+    for (uint32_t sub = coupled_bits; ; sub = (sub - 1) & coupled_bits)
+    {
+      cases.push_back(sub);
+      if (sub == 0)
+      {
+        break;
+      }
+    }
+    std::reverse(cases.begin(), cases.end());
+    std::vector<double> imperfect_weights(cases.size());
+    unsigned max_weight_case = 0;
+    for (unsigned c = 0; c < cases.size(); c++) {
+      // Compute weight for this particular subset of imperfect ranks
+      double weight = 1.0;
+      for (int i = 0; i < num_imperfect_ranks; i++) {
+        if (!(coupled_bits & ((uint32_t)1 << i))) {
+          continue;
+        }
+        if (cases[c] & ((uint32_t)1 << i)) {
+          weight *= (1.0 / rank_id_to_outer_size[imperfect_ranks[i]]);
+        } else {
+          weight *= (1.0 - 1.0 / rank_id_to_outer_size[imperfect_ranks[i]]);
+        }
+      }
+      imperfect_weights[c] = weight;
+      if (weight > imperfect_weights[max_weight_case])
+      {
+        max_weight_case = c;
+      }
+    }
+
+    double final_slowdown = 0.0, final_correction_ratio = 0.0;
+    double kept_weight = 0.0;
+    bool pruned = false;
+    std::vector<const TileTypeHistogram*> cnt_tile_types(rank_groups.size(), nullptr);
+    for (unsigned c = 0; c < cases.size(); c++) {
+      uint32_t bitmask = cases[c];
+      double weight = imperfect_weights[c];
+      if (weight < gSlowdownWeightTolerance && c != max_weight_case)
+      {
+        pruned = true;
+        continue;
+      }
+
+      double total_data_requested = 0;
+      for (auto &[data_space_id, ds] : per_dataspace_base)
+      {
+        if (!mask[data_space_id])
+        {
+          continue;
+        }
+        double data_requested_ds = 1;
+        for (auto rid : per_dataspace_counted_ranks[data_space_id])
+        {
+          data_requested_ds *= expected_parallelism(rid, bitmask);
+        }
+        total_data_requested += data_requested_ds / ds.access_frequency;
+      }
+
+      for (unsigned gid = 0; gid < rank_groups.size(); gid++)
+      {
+        if (!gFactoredTileTypeCounting)
+        {
+          group_tile_types[gid].clear();
+        }
+        // Uncoupled groups have the same tile types for every sub-bitmask.
+        cnt_tile_types[gid] = &group_histogram(gid, bitmask & coupled_bits & group_imperfect_bits[gid]);
       }
+
+      std::pair<double, double> result = ComputeBankConflictSlowdownIndividual(
+        layout, rank_table, mask,
+        crypto_config, compute_cycles,
+        total_data_requested,
+        cnt_tile_types, per_dataspace_base);
+      final_slowdown += weight * result.first;
+      final_correction_ratio += weight * result.second;
+      kept_weight += weight;
 #ifdef DEBUG
-      std::cout << "data_space_id:" << data_space_id
-                << std::endl;
-      std::cout << "memory_line:" << ds.memory_line
-                << std::endl;
-      std::cout << "auth_block_size:" << ds.auth_block_size
-                << std::endl;
-      std::cout << "crypto_latency_per_line:" << ds.crypto_latency_per_line
-                << std::endl;
-      std::cout << "crypto_hash_reads_per_line:" << ds.crypto_hash_reads_per_line
-                << std::endl;
+      std::cout << "all_correction_ratios[" << bitmask << "] = " << result.second << std::endl;
 #endif
     }
 
+    if (pruned && kept_weight > 0)
+    {
+      final_slowdown /= kept_weight;
+      final_correction_ratio /= kept_weight;
+    }
+
+#ifdef DEBUG
+    std::cout << "final slowdown current dataspace = " << final_slowdown
+              << std::endl;
+    std::cout << "final correction ratio = " << final_correction_ratio
+              << std::endl;
+#endif
+
+    assert(layout.assume_row_buffer || final_correction_ratio <= 1);
+
+    if (gEnableSlowdownCache)
+    {
+      if (slowdown_cache_.size() >= kMaxSlowdownCacheEntries)
+      {
+        slowdown_cache_.clear();
+      }
+      slowdown_cache_.emplace(std::move(signature), std::make_pair(final_slowdown, final_correction_ratio));
+    }
+
+    return std::pair<double, double>{final_slowdown, final_correction_ratio};
+  }
+
+  std::pair<double, double> BufferLevel::ComputeBankConflictSlowdownIndividual(
+      const layout::Layout& layout,
+      const layout::RankTable& rank_table,
+      const tiling::CompoundMask &mask,
+      const crypto::CryptoConfig *crypto_config,
+      uint64_t compute_cycles,
+      double total_data_requested,
+      const std::vector<const TileTypeHistogram*>& cnt_tile_types,
+      std::unordered_map<unsigned, SlowdownIntermediateData>& per_dataspace)
+  {
+    auto& rank_groups = rank_table.rank_groups;
+
     // ****************************************************************
     // Step 4: Analyze the Memory Latency and Obtain the Total Latency
     // ****************************************************************
@@ -1680,7 +2056,7 @@ namespace model
     std::cout << " *** step 4 *** " << std::endl;
 #endif
 
-    LatencyStats latency_stats = CheckTileTypes(layout, crypto_config, mask, rank_groups, cnt_tile_types, per_dataspace, compute_cycles);
+    LatencyStats latency_stats = CheckTileTypes(layout, rank_table, crypto_config, mask, rank_groups, cnt_tile_types, per_dataspace, compute_cycles);
 
     // ****************************************************************
     // Step 5: Analyze -- Bandwidth Modeling vs Layout based Modeling
@@ -1724,7 +2100,7 @@ namespace model
   }
 
   tiling::CompoundTile BufferLevel::ComputeBankConflictSlowdown(
-    const tiling::CompoundTile &tile, layout::Layout layout,
+    const tiling::CompoundTile &tile, const layout::Layout& layout,
     const tiling::CompoundMask &mask, const analysis::NestAnalysis *analysis,
     std::vector<loop::Descriptor> &current_level_loopnest,
     std::vector<loop::Descriptor> &subtile_mapping_loopnest,
@@ -1833,6 +2209,15 @@ namespace model
 #endif
 
     std::unordered_map<unsigned, SlowdownIntermediateData> per_dataspace;
+    auto rank_table = layout::GetRankTable(layout);
+    // Layouts without an attached table get a fresh but identical one on
+    // every call, which must not empty the cache.
+    if (rank_table != slowdown_cache_rank_table_ &&
+        (!slowdown_cache_rank_table_ || *rank_table != *slowdown_cache_rank_table_))
+    {
+      slowdown_cache_.clear();
+      slowdown_cache_rank_table_ = rank_table;
+    }
 
     // Bank Conflict Check Start!
     // each data space (input, weights or output) is analysed independently
@@ -1926,7 +2311,7 @@ namespace model
 
     if (dim_id_to_mapping_parallelism.size() > 0) {
       spatial_bc_analysis_result = ComputeBankConflictSlowdownPerDataSpace(
-        layout, mask, crypto_config, 1.0,
+        layout, *rank_table, mask, crypto_config, 1.0,
         dim_id_to_mapping_parallelism, dim_id_to_number_of_tiles,
         dim_id_to_outer_size, per_dataspace);
 
@@ -1949,7 +2334,7 @@ namespace model
     std::pair<double, double> subtile_bc_analysis_result;
     if (dim_id_to_subtile_shape.size() > 0 && dim_id_to_mapping_parallelism.size() == 0) {
       subtile_bc_analysis_result = ComputeBankConflictSlowdownPerDataSpace(
-        layout, mask, crypto_config, compute_cycles,
+        layout, *rank_table, mask, crypto_config, compute_cycles,
         dim_id_to_subtile_shape, dim_id_to_number_of_tiles,
         dim_id_to_outer_size, per_dataspace);
 
@@ -2022,7 +2407,7 @@ namespace model
   //
   EvalStatus
   BufferLevel::Evaluate(const tiling::CompoundTile &tile,
-                        const tiling::CompoundMask &mask, layout::Layout layout,
+                        const tiling::CompoundMask &mask, const layout::Layout& layout,
                         const analysis::NestAnalysis *analysis,
                         std::vector<loop::Descriptor> &current_level_loopnest,
                         std::vector<loop::Descriptor> &subtile_mapping_loopnest,
@@ -3180,6 +3565,13 @@ namespace model
   STAT_ACCESSOR(double, BufferLevel, Energy,
                 StorageEnergy(pv) + TemporalReductionEnergy(pv) + AddrGenEnergy(pv) + LeakageEnergy(pv))
 
+  STAT_ACCESSOR(double, BufferLevel, PartialEnergy,
+                (stats_.utilized_instances.at(pv) > 0 ?
+                 stats_.cluster_access_energy.at(pv) /
+                 (double(stats_.utilized_x_expansion.at(pv) * stats_.utilized_y_expansion.at(pv)) / double(stats_.utilized_clusters.at(pv))) *
+                 stats_.utilized_instances.at(pv) : 0) +
+                TemporalReductionEnergy(pv) + AddrGenEnergy(pv))
+
   STAT_ACCESSOR(std::uint64_t, BufferLevel, Accesses,
                 stats_.utilized_instances.at(pv) * (stats_.reads.at(pv) + stats_.updates.at(pv) + stats_.fills.at(pv)))
   STAT_ACCESSOR(std::uint64_t, BufferLevel, UtilizedCapacity,
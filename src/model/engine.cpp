@@ -71,7 +71,24 @@ std::vector<EvalStatus> Engine::PreEvaluationCheck(const Mapping& mapping, probl
   return topology_.PreEvaluationCheck(mapping, &nest_analysis_, sparse_optimizations, break_on_failure);
 }
 
-std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, layout::Layouts layout, sparse::SparseOptimizationInfo* sparse_optimizations, crypto::CryptoConfig* crypto_config, bool break_on_failure)
+std::vector<std::vector<EvalStatus>> Engine::PreEvaluationCheck(const std::vector<const Mapping*>& siblings, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure)
+{
+  std::vector<std::vector<EvalStatus>> eval_status;
+  if (siblings.empty())
+  {
+    return eval_status;
+  }
+
+  nest_analysis_.Init(&workload, &siblings.front()->loop_nest, siblings.front()->fanoutX_map, siblings.front()->fanoutY_map);
+  for (auto mapping : siblings)
+  {
+    assert(mapping->loop_nest == siblings.front()->loop_nest);
+    eval_status.push_back(topology_.PreEvaluationCheck(*mapping, &nest_analysis_, sparse_optimizations, break_on_failure));
+  }
+  return eval_status;
+}
+
+std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, const layout::Layouts& layout, sparse::SparseOptimizationInfo* sparse_optimizations, crypto::CryptoConfig* crypto_config, bool break_on_failure)
 {
   nest_analysis_.Init(&workload, &mapping.loop_nest, layout, mapping.fanoutX_map, mapping.fanoutY_map);
   auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, sparse_optimizations, break_on_failure, crypto_config);
@@ -109,7 +126,27 @@ std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& wo
 
   return eval_status;
 }
-  
+
+std::vector<EvalStatus> Engine::EvaluateLayout(const layout::Layouts& layout, crypto::CryptoConfig* crypto_config, bool break_on_failure)
+{
+  auto eval_status = topology_.EvaluateLayout(layout, crypto_config, break_on_failure);
+
+  is_evaluated_ = std::accumulate(eval_status.begin(), eval_status.end(), true,
+                                  [](bool cur, const EvalStatus& status)
+                                  { return cur && status.success; });
+
+  return eval_status;
+}
+
+bool Engine::LayoutEvaluationReady() const
+{
+  return topology_.LayoutEvaluationReady();
+}
+
+void Engine::SetCutoff(Topology::Cutoff cutoff)
+{
+  topology_.SetCutoff(cutoff);
+}
   
 double Engine::Energy() const
 {
@@ -740,6 +740,8 @@
  void Topology::Spec(const Topology::Specs& specs)
  {
    specs_ = specs;
+   layout_eval_cache_.valid = false;
+   pre_eval_cache_.valid = false;
 
    for (auto& level : levels_)
    {
@@ -1228,6 +1230,8 @@
    }
 
    is_evaluated_ = false;
+   is_cut_off_ = false;
+   layout_eval_cache_.valid = false;
  }
 
  // PreEvaluationCheck(): allows for a very fast capacity-check
@@ -1258,31 +1262,50 @@
    }
 
    auto masks = tiling::TransposeMasks(mapping.datatype_bypass_nest, workload);
-   auto working_set_sizes = analysis->GetWorkingSetSizes_LTW();
-   sparse::CompressionInfo storage_compression_info = sparse_optimizations->compression_info;
+
+   // Tile shapes and capacity requirements are shared with the previous
+   // mapping if only the bypass masks changed.
+   auto& cache = pre_eval_cache_;
+   if (!cache.valid || cache.workload != workload || cache.sparse_optimizations != sparse_optimizations ||
+       cache.confidence_thresholds != mapping.confidence_thresholds || !(cache.nest == mapping.loop_nest))
+   {
+     cache.valid = false;
+     cache.required_capacities.clear();
+     auto working_set_sizes = analysis->GetWorkingSetSizes_LTW();
+     sparse::CompressionInfo storage_compression_info = sparse_optimizations->compression_info;
+     for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+     {
+       sparse::PerStorageLevelCompressionInfo per_level_compression_info = {};
+       storage_compression_info.GetStorageLevelCompressionInfo(storage_level_id, per_level_compression_info);
+       try
+       {
+         cache.required_capacities.push_back(GetStorageLevel(storage_level_id)->RequiredCapacities(
+           working_set_sizes.at(storage_level_id), workload, per_level_compression_info,
+           mapping.confidence_thresholds.at(storage_level_id)));
+       }
+       catch (problem::DensityModelIncapability& e)
+       {
+         std::fill(eval_status.begin(), eval_status.end(),
+                   EvalStatus({ .success = false, .fail_reason = "density model incapable of evaluating a specific request" }));
+         return eval_status;
+       }
+     }
+     cache.nest = mapping.loop_nest;
+     cache.confidence_thresholds = mapping.confidence_thresholds;
+     cache.workload = workload;
+     cache.sparse_optimizations = sparse_optimizations;
+     cache.valid = true;
+   }
 
    for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
    {
-     sparse::PerStorageLevelCompressionInfo per_level_compression_info = {};
-     storage_compression_info.GetStorageLevelCompressionInfo(storage_level_id, per_level_compression_info);
      auto level_id = specs_.StorageMap(storage_level_id);
-     try
-     {
-       auto s = GetStorageLevel(storage_level_id)->PreEvaluationCheck(
-         working_set_sizes.at(storage_level_id), masks.at(storage_level_id), workload,
-         per_level_compression_info, mapping.confidence_thresholds.at(storage_level_id),
-         break_on_failure);
-       eval_status.at(level_id) = s;
+     auto s = GetStorageLevel(storage_level_id)->PreEvaluationCheck(
+       cache.required_capacities.at(storage_level_id), masks.at(storage_level_id), workload);
+     eval_status.at(level_id) = s;
 
-       if (break_on_failure && !s.success)
-         break;
-     }
-     catch (problem::DensityModelIncapability& e)
-     {
-       std::fill(eval_status.begin(), eval_status.end(),
-                 EvalStatus({ .success = false, .fail_reason = "density model incapable of evaluating a specific request" }));
-       return eval_status;
-     }
+     if (break_on_failure && !s.success)
+       break;
    }
 
    return eval_status;
@@ -1318,7 +1341,7 @@
 
    problem::Workload* workload = analysis->GetWorkload();
    workload_ = workload;
-   layout::Layouts layout = analysis->GetLayout();
+   const layout::Layouts* layout = analysis->IsLayoutInitialized() ? &analysis->GetLayout() : nullptr;
 
    std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
    bool valid = tiling::CheckMaskValidity(mapping.datatype_bypass_nest, workload);
@@ -1407,14 +1430,19 @@
    }
 
    // Transpose the tiles into level->datatype/level->optype structure.
-   auto tiles = tiling::TransposeTiles(collapsed_tiles, workload);
-   assert(tiles.size() == NumStorageLevels());
+   auto& cache = layout_eval_cache_;
+   cache.tiles = tiling::TransposeTiles(collapsed_tiles, workload);
+   assert(cache.tiles.size() == NumStorageLevels());
+   cache.keep_masks = keep_masks;
+   cache.analysis = analysis;
+   cache.arithmetic_status = { .success = true, .fail_reason = "" };
    if (!break_on_failure || success_accum)
    {
      auto level_id = specs_.ArithmeticMap();
-     auto s = GetArithmeticLevel()->Evaluate(tiles[0], keep_masks[0], workload, 0,
+     auto s = GetArithmeticLevel()->Evaluate(cache.tiles[0], keep_masks[0], workload, 0,
                                              compute_cycles, break_on_failure);
      eval_status.at(level_id) = s;
+     cache.arithmetic_status = s;
      success_accum &= s.success;
 
      if (break_on_failure && !s.success)
@@ -1425,7 +1453,15 @@
    // will only get the correct number of cycles if the eval of compute level is successful
    if (success_accum)
      compute_cycles = GetArithmeticLevel()->Cycles();
-   uint64_t total_cycles = compute_cycles;
+   cache.compute_cycles = compute_cycles;
+
+   // Collect the per-level loop nests seen by each storage level. These only
+   // depend on the mapping, so they are computed once and shared by all
+   // layouts evaluated against this mapping.
+   cache.confidence_thresholds.clear();
+   cache.current_level_loopnests.clear();
+   cache.subtile_mapping_loopnests.clear();
+   cache.subtile_mapping_parallelisms.clear();
 
    int current_storage_boundary = 0;
    std::vector<loop::Descriptor> subtile_mapping_loopnest;
@@ -1433,19 +1469,13 @@
 
    for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
    {
-     auto storage_level = GetStorageLevel(storage_level_id);
-
-     // Evaluate Loop Nest on hardware structures: calculate
-     // primary statistics.
-     auto level_id = specs_.StorageMap(storage_level_id);
-
      // populate parent level name for each dataspace
      for (unsigned pv = 0; pv < unsigned(workload_->GetShape()->NumDataSpaces); pv++)
      {
-       unsigned parent_level_id = tiles[storage_level_id].data_movement_info.at(pv).parent_level;
+       unsigned parent_level_id = cache.tiles[storage_level_id].data_movement_info.at(pv).parent_level;
        if (parent_level_id != std::numeric_limits<unsigned>::max())
        {
-         tiles[storage_level_id].data_movement_info.at(pv).parent_level_name =
+         cache.tiles[storage_level_id].data_movement_info.at(pv).parent_level_name =
            GetStorageLevel(parent_level_id)->GetSpecs().name.Get();
        }
      }
@@ -1456,40 +1486,10 @@
       current_level_loopnest.push_back(mapping.loop_nest.loops[i]);
      }
 
-     // if analysis
-     if(analysis->IsLayoutInitialized()){
-#ifdef DEBUG
-       std::cout << "Evaluate Storage Level " << storage_level_id << " -- " << layout[storage_level_id].target << std::endl;
-#endif
-       assert(layout.size() > storage_level_id);
-       auto s = storage_level->Evaluate(tiles[storage_level_id], keep_masks[storage_level_id], layout[storage_level_id],
-                                      analysis,
-                                      current_level_loopnest,
-                                      subtile_mapping_loopnest,
-                                      subtile_mapping_parallelism,
-                                      workload,
-                                      mapping.confidence_thresholds.at(storage_level_id),
-                                      compute_cycles, break_on_failure,
-                                      crypto_config);
-       total_cycles = std::max(total_cycles, storage_level->Cycles());
-       eval_status.at(level_id) = s;
-       success_accum &= s.success;
-       if (break_on_failure && !s.success)
-         break;
-     }else{
-#ifdef DEBUG
-       std::cout << "Evaluate Storage Level " << storage_level_id  << std::endl;
-#endif
-       auto s = storage_level->Evaluate(tiles[storage_level_id], keep_masks[storage_level_id],
-                                  workload,
-                                   mapping.confidence_thresholds.at(storage_level_id),
-                                   compute_cycles, break_on_failure);
-       total_cycles = std::max(total_cycles, storage_level->Cycles());
-       eval_status.at(level_id) = s;
-       success_accum &= s.success;
-       if (break_on_failure && !s.success)
-         break;
-     }
+     cache.confidence_thresholds.push_back(mapping.confidence_thresholds.at(storage_level_id));
+     cache.current_level_loopnests.push_back(current_level_loopnest);
+     cache.subtile_mapping_loopnests.push_back(subtile_mapping_loopnest);
+     cache.subtile_mapping_parallelisms.push_back(subtile_mapping_parallelism);
 
      for(unsigned i = current_storage_boundary; i <= mapping.loop_nest.storage_tiling_boundaries[storage_level_id]; i++)
      {
@@ -1511,36 +1511,10 @@
      current_storage_boundary = mapping.loop_nest.storage_tiling_boundaries[storage_level_id] + 1;
    }
 
-   if (!break_on_failure || success_accum)
-   {
-     for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
-     {
-       auto storage_level = GetStorageLevel(storage_level_id);
-       auto child_level_stats = storage_level->GetStats();
-
-       // each dataspace can have a different parent level
-       for (unsigned pvi = 0; pvi < unsigned(workload_->GetShape()->NumDataSpaces); pvi++)
-       {
-         unsigned parent_storage_level_id = tiles[storage_level_id].data_movement_info.at(pvi).parent_level;
-         // if there is any overbooking, add the energy cost to parent level
-         if (child_level_stats.tile_confidence[pvi] != 1.0
-           && parent_storage_level_id != std::numeric_limits<unsigned>::max())
-         {
-           auto parent_storage_level = GetStorageLevel(parent_storage_level_id);
-           parent_storage_level->ComputeEnergyDueToChildLevelOverflow(child_level_stats, pvi);
-         }
-       }
-     }
-     // finalized energy data
-     for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
-     {
-       auto storage_level = GetStorageLevel(storage_level_id);
-       storage_level->ComputeLeaksPerCycle();
-       storage_level->FinalizeBufferEnergy(total_cycles);
-     }
-   }
+   success_accum &= EvaluateStorageLevels(layout, crypto_config, break_on_failure, eval_status);
 
    unsigned int numConnections = NumStorageLevels();
+   cache.network_status.assign(numConnections, { .success = true, .fail_reason = "" });
    for (uint32_t connection_id = 0; connection_id < numConnections; connection_id++)
    {
      auto connection = connection_map_[connection_id];
@@ -1548,9 +1522,11 @@
      EvalStatus s;
      if (!rf_net->IsEvaluated())
      {
-       s = rf_net->Evaluate(tiles[connection_id], workload, break_on_failure);
+       s = rf_net->Evaluate(cache.tiles[connection_id], workload, break_on_failure);
        eval_status.at(connection_id).success &= s.success;
        eval_status.at(connection_id).fail_reason += s.fail_reason;
+       cache.network_status.at(connection_id).success &= s.success;
+       cache.network_status.at(connection_id).fail_reason += s.fail_reason;
        success_accum &= s.success;
      }
 
@@ -1560,9 +1536,11 @@
      auto du_net = connection.drain_update_network;
      if (!du_net->IsEvaluated())
      {
-       s = du_net->Evaluate(tiles[connection_id], workload, break_on_failure);
+       s = du_net->Evaluate(cache.tiles[connection_id], workload, break_on_failure);
        eval_status.at(connection_id).success &= s.success;
        eval_status.at(connection_id).fail_reason += s.fail_reason;
+       cache.network_status.at(connection_id).success &= s.success;
+       cache.network_status.at(connection_id).fail_reason += s.fail_reason;
        success_accum &= s.success;
      }
 
@@ -1570,6 +1548,60 @@
        break;
    }
 
+   // Everything up to this point except the storage levels is independent of
+   // the layout, so later layouts can be evaluated via EvaluateLayout().
+   cache.valid = analysis->IsLayoutInitialized();
+
+   if (!break_on_failure || success_accum)
+   {
+     ComputeStats(success_accum);
+   }
+
+   if (success_accum)
+   {
+     is_evaluated_ = true;
+   }
+
+   return eval_status;
+ }
+
+ // EvaluateLayout(): re-evaluates the mapping from the most recent Evaluate()
+ // call under a different layout. The tiles, access counts, arithmetic and
+ // network results are taken from the cache built by Evaluate(); only the
+ // storage levels (bank-conflict slowdown, access correction, energy and
+ // performance) and the final roll-up are recomputed.
+ std::vector<EvalStatus> Topology::EvaluateLayout(const layout::Layouts& layout,
+                                                  crypto::CryptoConfig* crypto_config,
+                                                  bool break_on_failure)
+ {
+   assert(is_specced_);
+   assert(layout_eval_cache_.valid);
+   assert(layout.size() >= NumStorageLevels());
+
+   stats_.Reset();
+   for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+   {
+     GetStorageLevel(storage_level_id)->Reset();
+   }
+   is_evaluated_ = false;
+   is_cut_off_ = false;
+
+   std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
+   eval_status.at(specs_.ArithmeticMap()) = layout_eval_cache_.arithmetic_status;
+   bool success_accum = layout_eval_cache_.arithmetic_status.success;
+   if (break_on_failure && !success_accum)
+     return eval_status;
+
+   success_accum &= EvaluateStorageLevels(&layout, crypto_config, break_on_failure, eval_status);
+
+   for (unsigned connection_id = 0; connection_id < layout_eval_cache_.network_status.size(); connection_id++)
+   {
+     auto& s = layout_eval_cache_.network_status.at(connection_id);
+     eval_status.at(connection_id).success &= s.success;
+     eval_status.at(connection_id).fail_reason += s.fail_reason;
+     success_accum &= s.success;
+   }
+
    if (!break_on_failure || success_accum)
    {
      ComputeStats(success_accum);
@@ -1583,6 +1615,119 @@
    return eval_status;
  }
 
+ // EvaluateStorageLevels(): evaluates every storage level on the cached tiles
+ // and finalizes buffer energy. A null layout selects the bandwidth-only model.
+ bool Topology::EvaluateStorageLevels(const layout::Layouts* layout,
+                                      crypto::CryptoConfig* crypto_config,
+                                      bool break_on_failure,
+                                      std::vector<EvalStatus>& eval_status)
+ {
+   auto& cache = layout_eval_cache_;
+   problem::Workload* workload = workload_;
+   bool success_accum = true;
+   uint64_t total_cycles = cache.compute_cycles;
+
+   // Lower bound on the final energy: the arithmetic level is final by now,
+   // and every level evaluated so far only gains leakage and overflow energy.
+   bool use_cutoff = break_on_failure && cutoff_;
+   double partial_energy = use_cutoff ? GetArithmeticLevel()->Energy() : 0;
+
+   for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+   {
+     auto storage_level = GetStorageLevel(storage_level_id);
+
+     // Evaluate Loop Nest on hardware structures: calculate
+     // primary statistics.
+     auto level_id = specs_.StorageMap(storage_level_id);
+
+     // Stop before the (typically more expensive) outer levels once the
+     // partial result cannot be of use.
+     if (use_cutoff && storage_level_id > 0)
+     {
+       cutoff_bound_.Reset();
+       cutoff_bound_.cycles = total_cycles;
+       cutoff_bound_.energy = partial_energy;
+       if (cutoff_(cutoff_bound_))
+       {
+         is_cut_off_ = true;
+         eval_status.at(level_id) = { .success = false, .fail_reason = "evaluation cut off by lower bound" };
+         success_accum = false;
+         break;
+       }
+     }
+
+     // if analysis
+     if (layout != nullptr){
+#ifdef DEBUG
+       std::cout << "Evaluate Storage Level " << storage_level_id << " -- " << layout->at(storage_level_id).target << std::endl;
+#endif
+       assert(layout->size() > storage_level_id);
+       auto s = storage_level->Evaluate(cache.tiles[storage_level_id], cache.keep_masks[storage_level_id], layout->at(storage_level_id),
+                                      cache.analysis,
+                                      cache.current_level_loopnests[storage_level_id],
+                                      cache.subtile_mapping_loopnests[storage_level_id],
+                                      cache.subtile_mapping_parallelisms[storage_level_id],
+                                      workload,
+                                      cache.confidence_thresholds[storage_level_id],
+                                      cache.compute_cycles, break_on_failure,
+                                      crypto_config);
+       total_cycles = std::max(total_cycles, storage_level->Cycles());
+       eval_status.at(level_id) = s;
+       success_accum &= s.success;
+       if (break_on_failure && !s.success)
+         break;
+       if (use_cutoff)
+         partial_energy += storage_level->PartialEnergy();
+     }else{
+#ifdef DEBUG
+       std::cout << "Evaluate Storage Level " << storage_level_id  << std::endl;
+#endif
+       auto s = storage_level->Evaluate(cache.tiles[storage_level_id], cache.keep_masks[storage_level_id],
+                                  workload,
+                                   cache.confidence_thresholds[storage_level_id],
+                                   cache.compute_cycles, break_on_failure);
+       total_cycles = std::max(total_cycles, storage_level->Cycles());
+       eval_status.at(level_id) = s;
+       success_accum &= s.success;
+       if (break_on_failure && !s.success)
+         break;
+       if (use_cutoff)
+         partial_energy += storage_level->PartialEnergy();
+     }
+   }
+
+   if (!break_on_failure || success_accum)
+   {
+     for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+     {
+       auto storage_level = GetStorageLevel(storage_level_id);
+       auto child_level_stats = storage_level->GetStats();
+
+       // each dataspace can have a different parent level
+       for (unsigned pvi = 0; pvi < unsigned(workload_->GetShape()->NumDataSpaces); pvi++)
+       {
+         unsigned parent_storage_level_id = cache.tiles[storage_level_id].data_movement_info.at(pvi).parent_level;
+         // if there is any overbooking, add the energy cost to parent level
+         if (child_level_stats.tile_confidence[pvi] != 1.0
+           && parent_storage_level_id != std::numeric_limits<unsigned>::max())
+         {
+           auto parent_storage_level = GetStorageLevel(parent_storage_level_id);
+           parent_storage_level->ComputeEnergyDueToChildLevelOverflow(child_level_stats, pvi);
+         }
+       }
+     }
+     // finalized energy data
+     for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+     {
+       auto storage_level = GetStorageLevel(storage_level_id);
+       storage_level->ComputeLeaksPerCycle();
+       storage_level->FinalizeBufferEnergy(total_cycles);
+     }
+   }
+
+   return success_accum;
+ }
+
  void Topology::ComputeStats(bool eval_success)
  {
    if (eval_success)
@@ -104,6 +104,10 @@ void ExhaustiveSearch::Report(Status status, double cost)
   {
     valid_mappings_++;
   }
+  else if (status == Status::CutOff)
+  {
+    valid_mappings_++;
+  }
   else if (status == Status::MappingConstructionFailure)
   {
     // Accelerate search by invalidating bad spaces.
@@ -25,25 +25,35 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <iomanip>
+
 #include "search/hybrid.hpp"
 
 namespace search
 {
 
-HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id) :
+HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                            WorkPool* pool) :
     SearchAlgorithm(),
     mapspace_(mapspace),
     id_(id),
+    pool_(pool),
     if_pgen_(mapspace_->Size(mapspace::Dimension::IndexFactorization)),
     state_(State::Ready),
     valid_mappings_(0),
     eval_fail_count_(0),
+    visited_(nullptr),
     best_cost_(0)
 {
   (void) id_;
     
   filter_revisits_ = false;
   config.lookupValue("filter_revisits", filter_revisits_);    
+  // A work pool never hands out an index factorization twice.
+  if (filter_revisits_ && !pool_)
+  {
+    visited_ = ParseAndConstructVisitedSet(config, mapspace_->Size(mapspace::Dimension::IndexFactorization));
+  }
     
   for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
   {
@@ -57,6 +67,13 @@ HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace
   {
     state_ = State::Terminated;
   }
+  else if (pool_)
+  {
+    if (pool_->Next(id_, iterator_[unsigned(mapspace::Dimension::IndexFactorization)]))
+      mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+    else
+      state_ = State::Terminated;
+  }
   else
   {
     // Prune the mapspace for the first time.
@@ -71,6 +88,7 @@ HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace
 
 HybridSearch::~HybridSearch()
 {
+  delete visited_;
 #ifdef DUMP_COSTS
   best_cost_file_.close();
 #endif
@@ -86,18 +104,33 @@ bool HybridSearch::IncrementRecursive_(int position)
   {
     // Throw a random number to get the next index factorization.
     uint128_t n;
+    unsigned rejected = 0;
     while (true)
     {
+      if (pool_)
+      {
+        // Take the next index factorization from the shared pool.
+        if (!pool_->Next(id_, n))
+        {
+          return false;
+        }
+        break;
+      }
       n = if_pgen_.Next();
       if (filter_revisits_)
       {
-        if (visited_.size() == mapspace_->Size(mapspace::Dimension::IndexFactorization))
+        if (visited_->Size() == mapspace_->Size(mapspace::Dimension::IndexFactorization))
         {
           return false;
         }
-        else if (visited_.find(n) == visited_.end())
+        else if (visited_->Insert(n))
         {
-          visited_.insert(n);
+          break;
+        }
+        else if (!visited_->Exact() && ++rejected == kMaxVisitedRejections)
+        {
+          // The filter is saturated (or the space is exhausted up to false
+          // positives): accept a possible revisit rather than spin.
           break;
         }
       }
@@ -186,6 +219,12 @@ void HybridSearch::Report(Status status, double cost)
     else
       best_cost_ = std::min(best_cost_, cost);
   }
+  else if (status == Status::CutOff)
+  {
+    // Not an improvement, and the partial cost is only a lower bound, so it
+    // must not reach best_cost_.
+    valid_mappings_++;
+  }
   else if (status == Status::MappingConstructionFailure)
   {
     // Accelerate search by invalidating bad spaces.
@@ -237,4 +276,59 @@ void HybridSearch::Report(Status status, double cost)
   }
 }
 
+bool HybridSearch::SaveState(std::ostream& out) const
+{
+  assert(state_ != State::WaitingForStatus);
+
+  // The pool is shared between threads and cannot be restored per thread.
+  if (pool_)
+  {
+    return false;
+  }
+
+  if_pgen_.SaveState(out);
+  out << unsigned(state_) << ' ';
+  for (auto& i : iterator_)
+  {
+    out << i << ' ';
+  }
+  out << valid_mappings_ << ' ' << eval_fail_count_ << ' '
+      << std::setprecision(17) << best_cost_ << ' ';
+  if (visited_)
+  {
+    visited_->SaveState(out);
+  }
+  return true;
+}
+
+bool HybridSearch::LoadState(std::istream& in)
+{
+  assert(state_ != State::WaitingForStatus);
+
+  unsigned state;
+  if_pgen_.LoadState(in);
+  in >> state;
+  for (auto& i : iterator_)
+  {
+    in >> i;
+  }
+  in >> valid_mappings_ >> eval_fail_count_ >> best_cost_;
+  if (visited_ && in && !visited_->LoadState(in))
+  {
+    return false;
+  }
+  if (!in || state > unsigned(State::Terminated))
+  {
+    return false;
+  }
+  state_ = State(state);
+
+  // Bring the mapspace back to the pruned sub-space being searched.
+  if (state_ == State::Ready)
+  {
+    mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+  }
+  return true;
+}
+
 } // namespace search
@@ -30,10 +30,12 @@
 namespace search
 {
 
-LinearPrunedSearch::LinearPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id) :
+LinearPrunedSearch::LinearPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                                        WorkPool* pool) :
     SearchAlgorithm(),
     mapspace_(mapspace),
     id_(id),
+    pool_(pool),
     state_(State::Ready),
     valid_mappings_(0),
     eval_fail_count_(0),
@@ -54,6 +56,13 @@ LinearPrunedSearch::LinearPrunedSearch(config::CompoundConfigNode config, mapspa
   {
     state_ = State::Terminated;
   }
+  else if (pool_)
+  {
+    if (pool_->Next(id_, iterator_[unsigned(mapspace::Dimension::IndexFactorization)]))
+      mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+    else
+      state_ = State::Terminated;
+  }
   else
   {
     // Prune the mapspace for the first time.
@@ -74,7 +83,18 @@ LinearPrunedSearch::~LinearPrunedSearch()
 bool LinearPrunedSearch::IncrementRecursive_(int position)
 {
   auto dim = dim_order_[position];
-  if (iterator_[unsigned(dim)] + 1 < mapspace_->Size(dim))
+  if (pool_ && dim == mapspace::Dimension::IndexFactorization)
+  {
+    // The next index factorization comes from the shared pool.
+    if (!pool_->Next(id_, iterator_[unsigned(dim)]))
+    {
+      return false;
+    }
+    mapspace_->InitPruned(iterator_[unsigned(dim)]);
+    best_cost_ = 0;
+    return true;
+  }
+  else if (iterator_[unsigned(dim)] + 1 < mapspace_->Size(dim))
   {
     // Move to next integer in this mapspace dimension.
     iterator_[unsigned(dim)]++;
@@ -150,6 +170,12 @@ void LinearPrunedSearch::Report(Status status, double cost)
     else
       best_cost_ = std::min(best_cost_, cost);
   }
+  else if (status == Status::CutOff)
+  {
+    // Not an improvement, and the partial cost is only a lower bound, so it
+    // must not reach best_cost_.
+    valid_mappings_++;
+  }
   else if (status == Status::MappingConstructionFailure)
   {
     // Accelerate search by invalidating bad spaces.
@@ -25,20 +25,25 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <iomanip>
+
 #include "search/random-pruned.hpp"
 
 namespace search
 {
 
-RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id) :
+RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                                        WorkPool* pool) :
     SearchAlgorithm(),
     mapspace_(mapspace),
     id_(id),
+    pool_(pool),
     if_pgen_(mapspace_->Size(mapspace::Dimension::IndexFactorization)),
     lp_pgen_(mapspace_->Size(mapspace::Dimension::LoopPermutation)),
     state_(State::Ready),
     valid_mappings_(0),
     eval_fail_count_(0),
+    visited_(nullptr),
     best_cost_(0)
 {
   (void) id_;
@@ -46,6 +51,14 @@ RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspa
   unsigned x = 16;
   config.lookupValue("max_permutations_per_if_visit", x);
   max_permutations_per_if_visit_ = x;
+
+  filter_revisits_ = false;
+  config.lookupValue("filter_revisits", filter_revisits_);
+  // A work pool never hands out an index factorization twice.
+  if (filter_revisits_ && !pool_)
+  {
+    visited_ = ParseAndConstructVisitedSet(config, mapspace_->Size(mapspace::Dimension::IndexFactorization));
+  }
     
   for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
   {
@@ -62,8 +75,23 @@ RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspa
   else
   {
     // Prepare the first random subspace IDs.
-    iterator_[unsigned(mapspace::Dimension::IndexFactorization)] = if_pgen_.Next();      
+    if (pool_)
+    {
+      if (!pool_->Next(id_, iterator_[unsigned(mapspace::Dimension::IndexFactorization)]))
+        state_ = State::Terminated;
+    }
+    else
+    {
+      iterator_[unsigned(mapspace::Dimension::IndexFactorization)] = if_pgen_.Next();
+      if (filter_revisits_)
+      {
+        visited_->Insert(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+      }
+    }
+  }
 
+  if (state_ == State::Ready)
+  {
     // Prune the mapspace for the first time.
     mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
 
@@ -86,6 +114,7 @@ RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspa
 
 RandomPrunedSearch::~RandomPrunedSearch()
 {
+  delete visited_;
 #ifdef DUMP_COSTS
   best_cost_file_.close();
 #endif
@@ -98,7 +127,35 @@ bool RandomPrunedSearch::IncrementRecursive_(int position)
   if (dim == mapspace::Dimension::IndexFactorization)
   {
     // Throw a random number to get the next index factorization.
-    iterator_[unsigned(dim)] = if_pgen_.Next();
+    uint128_t n;
+    unsigned rejected = 0;
+    while (true)
+    {
+      if (pool_)
+      {
+        // Take the next index factorization from the shared pool.
+        if (!pool_->Next(id_, n))
+        {
+          return false;
+        }
+        break;
+      }
+      n = if_pgen_.Next();
+      if (!filter_revisits_ || visited_->Insert(n))
+      {
+        break;
+      }
+      else if (visited_->Size() == mapspace_->Size(mapspace::Dimension::IndexFactorization))
+      {
+        return false;
+      }
+      else if (!visited_->Exact() && ++rejected == kMaxVisitedRejections)
+      {
+        // Saturated approximate set: accept a possible revisit.
+        break;
+      }
+    }
+    iterator_[unsigned(dim)] = n;
       
     // We just changed the index factorization. Prune the sub-mapspace
     // for this specific factorization index.
@@ -206,6 +263,12 @@ void RandomPrunedSearch::Report(Status status, double cost)
     else
       best_cost_ = std::min(best_cost_, cost);
   }
+  else if (status == Status::CutOff)
+  {
+    // Not an improvement, and the partial cost is only a lower bound, so it
+    // must not reach best_cost_.
+    valid_mappings_++;
+  }
   else if (status == Status::MappingConstructionFailure)
   {
     // Accelerate search by invalidating bad spaces.
@@ -256,4 +319,63 @@ void RandomPrunedSearch::Report(Status status, double cost)
   }
 }
 
+bool RandomPrunedSearch::SaveState(std::ostream& out) const
+{
+  assert(state_ != State::WaitingForStatus);
+
+  // The pool is shared between threads and cannot be restored per thread.
+  if (pool_)
+  {
+    return false;
+  }
+
+  if_pgen_.SaveState(out);
+  lp_pgen_.SaveState(out);
+  out << unsigned(state_) << ' ';
+  for (auto& i : iterator_)
+  {
+    out << i << ' ';
+  }
+  out << permutations_to_visit_ << ' ' << permutations_visited_ << ' '
+      << valid_mappings_ << ' ' << eval_fail_count_ << ' '
+      << std::setprecision(17) << best_cost_ << ' ';
+  if (visited_)
+  {
+    visited_->SaveState(out);
+  }
+  return true;
+}
+
+bool RandomPrunedSearch::LoadState(std::istream& in)
+{
+  assert(state_ != State::WaitingForStatus);
+
+  unsigned state;
+  if_pgen_.LoadState(in);
+  lp_pgen_.LoadState(in);
+  in >> state;
+  for (auto& i : iterator_)
+  {
+    in >> i;
+  }
+  in >> permutations_to_visit_ >> permutations_visited_
+     >> valid_mappings_ >> eval_fail_count_ >> best_cost_;
+  if (visited_ && in && !visited_->LoadState(in))
+  {
+    return false;
+  }
+  if (!in || state > unsigned(State::Terminated))
+  {
+    return false;
+  }
+  state_ = State(state);
+
+  // Bring the mapspace back to the pruned sub-space being searched.
+  if (state_ == State::Ready)
+  {
+    mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+  }
+  return true;
+}
+
 } // namespace search
@@ -60,6 +60,7 @@ RandomSearch::RandomSearch(config::CompoundConfigNode config, mapspace::MapSpace
 {
   filter_revisits_ = false;
   config.lookupValue("filter_revisits", filter_revisits_);    
+  visited_ = filter_revisits_ ? ParseAndConstructVisitedSet(config, mapspace_->Size()) : nullptr;
 
   pgens_[int(mapspace::Dimension::IndexFactorization)] =
     new RandomGenerator128(mapspace_->Size(mapspace::Dimension::IndexFactorization));
@@ -83,6 +84,7 @@ RandomSearch::RandomSearch(config::CompoundConfigNode config, mapspace::MapSpace
 
 RandomSearch::~RandomSearch()
 {
+  delete visited_;
   delete static_cast<RandomGenerator128*>(
     pgens_[int(mapspace::Dimension::IndexFactorization)]);
   delete static_cast<RandomGenerator128*>(
@@ -104,6 +106,7 @@ bool RandomSearch::Next(mapspace::ID& mapping_id)
     
   if (masking_space_covered_ == mapspace_->Size(mapspace::Dimension::DatatypeBypass))
   {
+    unsigned rejected = 0;
     while (true)
     {
       Roll(mapspace::Dimension::IndexFactorization);
@@ -112,9 +115,9 @@ bool RandomSearch::Next(mapspace::ID& mapping_id)
       Roll(mapspace::Dimension::DatatypeBypass);
       if (filter_revisits_)
       {
-        if (visited_.find(mapping_id_.Integer()) == visited_.end())
+        if (visited_->Insert(mapping_id_.Integer()) ||
+            (!visited_->Exact() && ++rejected == kMaxVisitedRejections))
         {
-          visited_.insert(mapping_id_.Integer());
           break;
         }
       }
@@ -143,7 +146,7 @@ void RandomSearch::Report(Status status, double cost)
     
   assert(state_ == State::WaitingForStatus);
 
-  if (status == Status::Success)
+  if (status == Status::Success || status == Status::CutOff)
   {
     valid_mappings_++;
   }
@@ -42,7 +42,8 @@ namespace search
 
 SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
                                    mapspace::MapSpace* mapspace,
-                                   unsigned id)
+                                   unsigned id,
+                                   WorkPool* pool)
 {
   SearchAlgorithm* search = nullptr;
   
@@ -59,15 +60,15 @@ SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
   }
   else if (search_alg == "linear_pruned")
   {
-    search = new LinearPrunedSearch(config, mapspace, id);
+    search = new LinearPrunedSearch(config, mapspace, id, pool);
   }
   else if (search_alg == "hybrid")
   {
-    search = new HybridSearch(config, mapspace, id);
+    search = new HybridSearch(config, mapspace, id, pool);
   }
   else if (search_alg == "random_pruned")
   {
-    search = new RandomPrunedSearch(config, mapspace, id);
+    search = new RandomPrunedSearch(config, mapspace, id, pool);
   }
   else
   {
@@ -78,4 +79,11 @@ SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
   return search;
 }
 
+bool UsesWorkPool(config::CompoundConfigNode config)
+{
+  std::string search_alg = "hybrid";
+  config.lookupValue("algorithm", search_alg);
+  return search_alg == "hybrid" || search_alg == "random_pruned" || search_alg == "linear_pruned";
+}
+
 } // namespace search
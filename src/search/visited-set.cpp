@@ -0,0 +1,261 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <iomanip>
+
+#include "search/visited-set.hpp"
+
+namespace search
+{
+
+namespace
+{
+
+std::uint64_t Mix64(std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+void SaveWords(std::ostream& out, const std::vector<std::uint64_t>& words)
+{
+  out << words.size() << std::hex;
+  for (auto w : words)
+  {
+    out << ' ' << w;
+  }
+  out << std::dec << ' ';
+}
+
+bool LoadWords(std::istream& in, std::vector<std::uint64_t>& words)
+{
+  std::size_t num_words;
+  in >> num_words;
+  if (!in || num_words != words.size())
+  {
+    return false;
+  }
+  in >> std::hex;
+  for (auto& w : words)
+  {
+    in >> w;
+  }
+  in >> std::dec;
+  return bool(in);
+}
+
+} // namespace
+
+//
+// HashVisitedSet.
+//
+
+bool HashVisitedSet::Insert(uint128_t id)
+{
+  return visited_.insert(id).second;
+}
+
+void HashVisitedSet::SaveState(std::ostream& out) const
+{
+  out << "hash " << visited_.size() << ' ';
+  for (auto& id : visited_)
+  {
+    out << id << ' ';
+  }
+}
+
+bool HashVisitedSet::LoadState(std::istream& in)
+{
+  std::string kind;
+  std::size_t num_visited = 0;
+  in >> kind >> num_visited;
+  if (!in || kind != "hash")
+  {
+    return false;
+  }
+  visited_.clear();
+  for (std::size_t v = 0; v < num_visited && in; v++)
+  {
+    uint128_t id;
+    in >> id;
+    visited_.insert(id);
+  }
+  return bool(in);
+}
+
+//
+// BitmapVisitedSet.
+//
+
+BitmapVisitedSet::BitmapVisitedSet(uint128_t space_size) :
+    words_(std::size_t((space_size + 63) / 64), 0),
+    size_(0)
+{
+}
+
+bool BitmapVisitedSet::Insert(uint128_t id)
+{
+  auto& word = words_.at(std::size_t(id / 64));
+  std::uint64_t bit = std::uint64_t(1) << unsigned(id % 64);
+  if (word & bit)
+  {
+    return false;
+  }
+  word |= bit;
+  size_++;
+  return true;
+}
+
+void BitmapVisitedSet::SaveState(std::ostream& out) const
+{
+  out << "bitmap " << size_ << ' ';
+  SaveWords(out, words_);
+}
+
+bool BitmapVisitedSet::LoadState(std::istream& in)
+{
+  std::string kind;
+  in >> kind >> size_;
+  return in && kind == "bitmap" && LoadWords(in, words_);
+}
+
+//
+// BloomVisitedSet.
+//
+
+BloomVisitedSet::BloomVisitedSet(std::uint64_t num_bits, double false_positive_rate) :
+    words_(std::max<std::uint64_t>((num_bits + 63) / 64, 1), 0),
+    size_(0)
+{
+  num_bits_ = 64 * words_.size();
+  // k = log2(1/p) hashes is optimal once the filter holds its capacity.
+  num_hashes_ = unsigned(std::ceil(-std::log2(false_positive_rate)));
+  num_hashes_ = std::max(num_hashes_, 1U);
+}
+
+std::uint64_t BloomVisitedSet::Capacity() const
+{
+  return std::uint64_t(double(num_bits_) * std::log(2.0) / num_hashes_);
+}
+
+bool BloomVisitedSet::Insert(uint128_t id)
+{
+  std::uint64_t h1 = Mix64(std::uint64_t(id) ^ Mix64(std::uint64_t(id >> 64)));
+  std::uint64_t h2 = Mix64(h1) | 1;
+
+  bool present = true;
+  for (unsigned i = 0; i < num_hashes_; i++)
+  {
+    std::uint64_t pos = (h1 + i * h2) % num_bits_;
+    auto& word = words_[pos / 64];
+    std::uint64_t bit = std::uint64_t(1) << (pos % 64);
+    if (!(word & bit))
+    {
+      present = false;
+      word |= bit;
+    }
+  }
+
+  if (present)
+  {
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+void BloomVisitedSet::SaveState(std::ostream& out) const
+{
+  out << "bloom " << num_hashes_ << ' ' << size_ << ' ';
+  SaveWords(out, words_);
+}
+
+bool BloomVisitedSet::LoadState(std::istream& in)
+{
+  std::string kind;
+  unsigned num_hashes;
+  in >> kind >> num_hashes >> size_;
+  return in && kind == "bloom" && num_hashes == num_hashes_ && LoadWords(in, words_);
+}
+
+//--------------------------------------------//
+//             Parser and Factory             //
+//--------------------------------------------//
+
+VisitedSet* ParseAndConstructVisitedSet(config::CompoundConfigNode config,
+                                        uint128_t space_size)
+{
+  std::string kind = "auto";
+  config.lookupValue("visited_set", kind);
+
+  unsigned max_mb = 16;
+  config.lookupValue("visited_set_max_mb", max_mb);
+  uint128_t max_bits = uint128_t(max_mb) * 8 * 1024 * 1024;
+
+  double false_positive_rate = 0.001;
+  config.lookupValue("visited_set_false_positive_rate", false_positive_rate);
+  if (false_positive_rate <= 0 || false_positive_rate >= 1)
+  {
+    std::cerr << "ERROR: visited_set_false_positive_rate must be in (0, 1), got "
+              << false_positive_rate << std::endl;
+    exit(1);
+  }
+
+  if (kind == "auto")
+  {
+    kind = (space_size <= max_bits) ? "bitmap" : "bloom";
+  }
+
+  if (kind == "hash")
+  {
+    return new HashVisitedSet();
+  }
+  else if (kind == "bitmap")
+  {
+    if (space_size > max_bits)
+    {
+      std::cerr << "WARNING: bitmap visited set for " << space_size
+                << " IDs exceeds visited_set_max_mb (" << max_mb << ")." << std::endl;
+    }
+    return new BitmapVisitedSet(space_size);
+  }
+  else if (kind == "bloom")
+  {
+    // Never more bits than IDs in the space.
+    return new BloomVisitedSet(std::uint64_t(std::min(max_bits, space_size)), false_positive_rate);
+  }
+  else
+  {
+    std::cerr << "ERROR: unsupported visited set: " << kind << std::endl;
+    exit(1);
+  }
+}
+
+} // namespace search
@@ -0,0 +1,118 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cassert>
+
+#include "search/work-pool.hpp"
+
+namespace search
+{
+
+namespace
+{
+
+uint128_t GCD(uint128_t a, uint128_t b)
+{
+  while (b != 0)
+  {
+    uint128_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+} // namespace
+
+WorkPool::WorkPool(uint128_t size, unsigned num_threads, uint128_t chunk_size, bool scatter) :
+    size_(size),
+    chunk_size_(std::max(chunk_size, uint128_t(1))),
+    stride_(1),
+    cursor_(0),
+    ranges_(num_threads),
+    steals_(0)
+{
+  if (scatter && size_ > 2)
+  {
+    // Roughly the golden ratio of the space, nudged to be coprime to it.
+    stride_ = size_ / 8 * 5 + 1;
+    while (GCD(stride_, size_) != 1)
+    {
+      stride_++;
+    }
+  }
+}
+
+bool WorkPool::Next(unsigned thread_id, uint128_t& index_factorization_id)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  assert(thread_id < ranges_.size());
+  auto& range = ranges_[thread_id];
+  if (range.begin == range.end)
+  {
+    if (cursor_ < size_)
+    {
+      range.begin = cursor_;
+      range.end = std::min(cursor_ + chunk_size_, size_);
+      cursor_ = range.end;
+    }
+    else
+    {
+      // Steal the upper half of the largest remaining range.
+      Range* victim = nullptr;
+      for (auto& other : ranges_)
+      {
+        if (!victim || other.end - other.begin > victim->end - victim->begin)
+        {
+          victim = &other;
+        }
+      }
+      if (victim->begin == victim->end)
+      {
+        return false;
+      }
+      uint128_t mid = victim->begin + (victim->end - victim->begin) / 2;
+      range.begin = mid;
+      range.end = victim->end;
+      victim->end = mid;
+      steals_++;
+    }
+  }
+
+  uint128_t position = range.begin++;
+  index_factorization_id = static_cast<uint128_t>(uint256_t(position) * stride_ % size_);
+  return true;
+}
+
+std::uint64_t WorkPool::Steals()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return steals_;
+}
+
+} // namespace search
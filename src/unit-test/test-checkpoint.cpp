@@ -0,0 +1,69 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <sstream>
+
+#include "applications/mapper/checkpoint.hpp"
+
+BOOST_AUTO_TEST_CASE(TestCheckpointRoundTrip)
+{
+  auto path = (std::filesystem::temp_directory_path() / "timeloop-test.checkpoint").string();
+  std::filesystem::remove(path);
+
+  MapperCheckpoint checkpoint;
+  BOOST_CHECK(!ReadCheckpoint(path, checkpoint));
+
+  layout::LayoutNest nest;
+  nest.data_space = "Inputs";
+  nest.type = "intraline";
+  nest.ranks = {"C", "H"};
+  nest.factors = {{"C", 4}, {"H", 2}};
+
+  ThreadCheckpoint thread;
+  thread.resumable = true;
+  thread.search_state = "1 2 3";
+  thread.total_mappings = uint128_t(1) << 100;
+  thread.mappings_since_last_best_update = 42;
+  thread.best_valid = true;
+  thread.best_mapping_id = (uint128_t(1) << 64) + 7;
+  thread.best_nests = {{nest}, {}};
+  thread.fails.push_back({2, 1, 5, "capacity", 9});
+
+  checkpoint.key = 0x123456789abcdef0ull;
+  checkpoint.threads = {thread, ThreadCheckpoint()};
+  BOOST_CHECK(WriteCheckpoint(path, checkpoint));
+
+  MapperCheckpoint loaded;
+  BOOST_CHECK(ReadCheckpoint(path, loaded));
+  BOOST_CHECK(loaded.key == checkpoint.key);
+  BOOST_CHECK(loaded.threads.size() == 2);
+  BOOST_CHECK(!loaded.threads[1].resumable);
+
+  auto& t = loaded.threads[0];
+  BOOST_CHECK(t.resumable);
+  BOOST_CHECK(t.search_state == "1 2 3");
+  BOOST_CHECK(t.total_mappings == thread.total_mappings);
+  BOOST_CHECK(t.mappings_since_last_best_update == 42);
+  BOOST_CHECK(t.best_mapping_id == thread.best_mapping_id);
+  BOOST_CHECK(t.best_nests.size() == 2 && t.best_nests[0].size() == 1);
+  BOOST_CHECK(t.best_nests[0][0].factors == nest.factors);
+  BOOST_CHECK(t.fails.size() == 1 && t.fails[0].reason == "capacity" && t.fails[0].mapping_id == 9);
+
+  std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(TestGeneratorStateRoundTrip)
+{
+  RandomGenerator128 a(uint128_t(1) << 80);
+  a.Next();
+
+  std::stringstream state;
+  a.SaveState(state);
+  RandomGenerator128 b(uint128_t(1) << 80);
+  b.LoadState(state);
+
+  for (int i = 0; i < 8; i++)
+  {
+    BOOST_CHECK(a.Next() == b.Next());
+  }
+}
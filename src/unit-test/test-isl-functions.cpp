@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
+
 #include <barvinok/isl.h>
 
 #include "isl-wrapper/ctx-manager.hpp"
@@ -34,3 +36,28 @@ BOOST_AUTO_TEST_CASE(TestIslFunctions_aff_from_qpolynomial)
 
   BOOST_CHECK(result == nullptr);
 }
+
+BOOST_AUTO_TEST_CASE(TestIslFunctions_TransferToIslCtx)
+{
+  auto map = isl::map(GetIslCtx(), "{ [i] -> [j] : 0 <= i < 4 and 0 <= j <= i }");
+
+  bool same_ctx = true;
+  bool equal = false;
+  double count = 0;
+  std::thread worker([&]()
+  {
+    auto transferred = TransferToIslCtx(map);
+    same_ctx = isl_map_get_ctx(transferred.get()) == isl_map_get_ctx(map.get());
+    equal = transferred.is_equal(
+      isl::map(GetIslCtx(), "{ [i] -> [j] : 0 <= i < 4 and 0 <= j <= i }")
+    );
+    count = isl::val_to_double(isl::get_val_from_singular(
+      isl::pw_qpolynomial_sum(isl::sum_map_range_card(transferred))
+    ));
+  });
+  worker.join();
+
+  BOOST_CHECK(!same_ctx);
+  BOOST_CHECK(equal);
+  BOOST_CHECK(count == 10);
+}
@@ -0,0 +1,422 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <thread>
+
+#include "applications/mapper/layout-search-pool.hpp"
+#include "compound-config/compound-config.hpp"
+#include "crypto/crypto.hpp"
+#include "layout/layout.hpp"
+#include "mapping/parser.hpp"
+#include "model/buffer.hpp"
+#include "model/engine.hpp"
+#include "model/sparse-optimization-parser.hpp"
+
+extern bool gEnableSlowdownCache;
+extern bool gFactoredTileTypeCounting;
+extern bool gPeriodicTileTypeCounting;
+extern double gSlowdownWeightTolerance;
+
+namespace
+{
+
+const auto LAYOUT_CONV_CONFIG_PATH =
+  std::filesystem::absolute(__FILE__).parent_path() / "configs" / "layout-conv.yaml";
+
+struct EvaluationResult
+{
+  bool success;
+  std::uint64_t cycles;
+  double energy;
+};
+
+// A padded convolution with imperfectly factorized P and Q on a
+// DRAM/SRAM/register-file hierarchy, evaluated with layouts that differ in
+// their MainMemory intraline factors.
+struct LayoutEvaluationFixture
+{
+  config::CompoundConfig config;
+  problem::Workload workload;
+  model::Engine::Specs arch_specs;
+  Mapping mapping;
+  sparse::SparseOptimizationInfo sparse_optimizations;
+  crypto::CryptoConfig crypto;
+  layout::Layouts base_layout;
+
+  LayoutEvaluationFixture() :
+      config({LAYOUT_CONV_CONFIG_PATH.native()})
+  {
+    auto root = config.getRoot();
+    problem::ParseWorkload(root.lookup("problem"), workload);
+    arch_specs = model::Engine::ParseSpecs(root.lookup("architecture"), false);
+    mapping = mapping::ParseAndConstruct(root.lookup("mapping"), arch_specs, workload);
+    sparse_optimizations = sparse::ParseAndConstruct(config::CompoundConfigNode(), arch_specs);
+    workload.SetDefaultDenseTensorFlag(sparse_optimizations.compression_info.all_ranks_default_dense);
+
+    std::vector<std::pair<std::string, std::pair<uint32_t, uint32_t>>> ports;
+    for (auto& name : arch_specs.topology.StorageLevelNames())
+    {
+      auto num_ports = arch_specs.topology.GetStorageLevel(name)->num_ports.Get();
+      ports.push_back({name, {num_ports, num_ports}});
+    }
+    base_layout = layout::InitializeDummyLayout(root.lookup("knobs"), workload, ports);
+  }
+
+  // The base layout with the given intraline factors (rank -> factor) of the
+  // target level applied to every data space that has the rank.
+  layout::Layouts MakeLayout(const std::map<std::string, std::uint32_t>& factors,
+                             const std::string& target = "MainMemory") const
+  {
+    auto layouts = base_layout;
+    for (auto& level_layout : layouts)
+    {
+      if (level_layout.target != target)
+        continue;
+      for (auto& nest : level_layout.intraline)
+        for (auto& [rank, factor] : factors)
+          if (nest.factors.count(rank))
+            nest.factors[rank] = factor;
+    }
+    return layouts;
+  }
+
+  EvaluationResult Evaluate(const layout::Layouts& layouts)
+  {
+    model::Engine engine;
+    engine.Spec(arch_specs);
+    Mapping engine_mapping = mapping;
+    auto status = engine.Evaluate(engine_mapping, workload, layouts, &sparse_optimizations, &crypto);
+    return Summarize(engine, status);
+  }
+
+  static EvaluationResult Summarize(const model::Engine& engine, const std::vector<model::EvalStatus>& status)
+  {
+    bool success = !status.empty();
+    for (auto& s : status)
+      success &= s.success;
+    return { success, engine.Cycles(), engine.Energy() };
+  }
+};
+
+// MainMemory intraline factors covering line factors that divide the tile
+// extents, that do not, and that exceed the number of tiles along a rank.
+const std::vector<std::map<std::string, std::uint32_t>> kLayoutVariants = {
+  {},
+  {{"V", 2}, {"W", 4}, {"C", 4}, {"L", 2}, {"Q", 4}},
+  {{"H", 3}, {"W", 5}, {"M", 8}, {"P", 7}},
+  {{"H", 4}, {"W", 16}, {"Q", 16}, {"S", 3}},
+};
+
+void CheckSameResult(const EvaluationResult& actual, const EvaluationResult& expected)
+{
+  BOOST_CHECK(expected.success);
+  BOOST_CHECK_EQUAL(actual.success, expected.success);
+  BOOST_CHECK_EQUAL(actual.cycles, expected.cycles);
+  BOOST_CHECK_CLOSE(actual.energy, expected.energy, 1e-9);
+}
+
+// Records every report and takes the best valid candidate, like the real
+// searches do.
+class RecordingLayoutSearch : public layoutspace::LayoutSearchAlgorithm
+{
+ public:
+  std::vector<bool> reported_valid;
+  bool has_best = false;
+  std::uint64_t best_cycles = 0;
+  double best_energy_per_compute = 0.0;
+
+  void Init(const layoutspace::Legal&, bool) override {}
+  bool Next(layoutspace::LayoutID&) override { return false; }
+  bool Report(const layoutspace::LayoutID&, bool valid, std::uint64_t cycles, double energy_per_compute) override
+  {
+    reported_valid.push_back(valid);
+    if (!valid || (has_best && !layoutspace::IsBetterLayout(cycles, energy_per_compute,
+                                                            best_cycles, best_energy_per_compute)))
+      return false;
+    has_best = true;
+    best_cycles = cycles;
+    best_energy_per_compute = energy_per_compute;
+    return true;
+  }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(TestLayoutReevaluationMatchesFullEvaluation, LayoutEvaluationFixture)
+{
+  // One full evaluation, then only the layout-dependent models per layout.
+  model::Engine engine;
+  engine.Spec(arch_specs);
+  Mapping engine_mapping = mapping;
+  auto first_layout = MakeLayout(kLayoutVariants.back());
+  engine.Evaluate(engine_mapping, workload, first_layout, &sparse_optimizations, &crypto);
+  BOOST_REQUIRE(engine.GetTopology().LayoutEvaluationReady());
+
+  for (auto& factors : kLayoutVariants)
+  {
+    auto layouts = MakeLayout(factors);
+    auto status = engine.EvaluateLayout(layouts, &crypto);
+    CheckSameResult(Summarize(engine, status), Evaluate(layouts));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(TestFactoredTileCountingMatchesPerCaseCounting, LayoutEvaluationFixture)
+{
+  // Every imperfect-factorization case is kept, so sharing the per-group
+  // tile counts across cases must not change the expected slowdown.
+  auto saved_factored = gFactoredTileTypeCounting;
+  auto saved_tolerance = gSlowdownWeightTolerance;
+  auto saved_cache = gEnableSlowdownCache;
+  gEnableSlowdownCache = false;
+  gSlowdownWeightTolerance = 0.0;
+
+  for (auto& factors : kLayoutVariants)
+  {
+    auto layouts = MakeLayout(factors);
+    gFactoredTileTypeCounting = false;
+    auto expected = Evaluate(layouts);
+    gFactoredTileTypeCounting = true;
+    CheckSameResult(Evaluate(layouts), expected);
+
+    // A tolerance below every case weight prunes nothing.
+    gSlowdownWeightTolerance = 1e-300;
+    CheckSameResult(Evaluate(layouts), expected);
+    gSlowdownWeightTolerance = 0.0;
+  }
+
+  gFactoredTileTypeCounting = saved_factored;
+  gSlowdownWeightTolerance = saved_tolerance;
+  gEnableSlowdownCache = saved_cache;
+}
+
+BOOST_FIXTURE_TEST_CASE(TestIndependentRankGroupsMatchJointEnumeration, LayoutEvaluationFixture)
+{
+  // Two rank groups with imperfect ranks. Groups whose tile types do not
+  // depend on their residuals are combined in expectation instead of being
+  // enumerated jointly, which must not change the result.
+  mapping = mapping::ParseAndConstruct(config.getRoot().lookup("two_imperfect_mapping"), arch_specs, workload);
+
+  auto saved_factored = gFactoredTileTypeCounting;
+  auto saved_tolerance = gSlowdownWeightTolerance;
+  auto saved_cache = gEnableSlowdownCache;
+  gEnableSlowdownCache = false;
+  gSlowdownWeightTolerance = 0.0;
+
+  for (auto& factors : kLayoutVariants)
+  {
+    auto layouts = MakeLayout(factors);
+    gFactoredTileTypeCounting = false;
+    auto expected = Evaluate(layouts);
+    gFactoredTileTypeCounting = true;
+    CheckSameResult(Evaluate(layouts), expected);
+  }
+
+  gFactoredTileTypeCounting = saved_factored;
+  gSlowdownWeightTolerance = saved_tolerance;
+  gEnableSlowdownCache = saved_cache;
+}
+
+BOOST_AUTO_TEST_CASE(TestCoupledImperfectBits)
+{
+  typedef model::BufferLevel::TileTypeHistogram Histogram;
+  auto make_histogram = [](int lines, int count)
+  {
+    model::BufferLevel::TileTypeDescriptor desc;
+    desc.num_lines = { lines };
+    desc.dataspace_mask = { true };
+    desc.dataspace_rb = { false };
+    desc.first_tile = false;
+    return Histogram({ { desc, count } });
+  };
+
+  // Group 0 (bits 0 and 1) changes its tile types with bit 1, group 1
+  // (bit 2) does not, and group 2 has no imperfect ranks.
+  std::vector<std::unordered_map<std::uint32_t, Histogram>> group_tile_types(3);
+  group_tile_types[0] = { { 0, make_histogram(2, 4) }, { 1, make_histogram(2, 4) },
+                          { 2, make_histogram(3, 4) }, { 3, make_histogram(3, 4) } };
+  group_tile_types[1] = { { 0, make_histogram(1, 7) }, { 4, make_histogram(1, 7) } };
+  group_tile_types[2] = { { 0, make_histogram(1, 1) } };
+  std::vector<std::uint32_t> group_imperfect_bits = { 3, 4, 0 };
+
+  // Only group 0's bits are enumerated: 4 cases instead of 8.
+  BOOST_CHECK_EQUAL(model::BufferLevel::CoupledImperfectBits(group_tile_types, group_imperfect_bits), 3u);
+
+  // Once group 1 depends on its bit too, every bit is coupled.
+  group_tile_types[1][4] = make_histogram(2, 7);
+  BOOST_CHECK_EQUAL(model::BufferLevel::CoupledImperfectBits(group_tile_types, group_imperfect_bits), 7u);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestPeriodicTileCountingMatchesFullWalk, LayoutEvaluationFixture)
+{
+  // The GlobalBuffer walks C4 P4,2 Q7 tiles, so short line factors leave
+  // several periods of interior tiles around the padded and residual
+  // boundary tiles, while long ones have a period beyond the tile count.
+  const std::vector<std::map<std::string, std::uint32_t>> global_buffer_variants = {
+    {{"Q", 2}, {"W", 2}, {"C", 1}},
+    {{"P", 3}, {"H", 3}, {"Q", 2}, {"W", 2}},
+    {{"C", 2}, {"V", 2}, {"Q", 3}, {"W", 3}},
+  };
+
+  auto saved_periodic = gPeriodicTileTypeCounting;
+  auto saved_cache = gEnableSlowdownCache;
+  gEnableSlowdownCache = false;
+
+  auto check = [&](const layout::Layouts& layouts)
+  {
+    gPeriodicTileTypeCounting = false;
+    auto expected = Evaluate(layouts);
+    gPeriodicTileTypeCounting = true;
+    CheckSameResult(Evaluate(layouts), expected);
+  };
+  for (auto& factors : kLayoutVariants)
+  {
+    check(MakeLayout(factors));
+    check(MakeLayout(factors, "GlobalBuffer"));
+  }
+  for (auto& factors : global_buffer_variants)
+  {
+    check(MakeLayout(factors, "GlobalBuffer"));
+  }
+
+  gPeriodicTileTypeCounting = saved_periodic;
+  gEnableSlowdownCache = saved_cache;
+}
+
+BOOST_FIXTURE_TEST_CASE(TestIncumbentCutoffDuringLayoutSearch, LayoutEvaluationFixture)
+{
+  // The incumbent cuts off the first candidate at its first outer level and
+  // lets every later one through.
+  model::Engine engine;
+  engine.Spec(arch_specs);
+  bool incumbent_cuts_off = true;
+  engine.SetCutoff([&](const model::Topology::Stats&)
+                   {
+                     bool cut_off = incumbent_cuts_off;
+                     incumbent_cuts_off = false;
+                     return cut_off;
+                   });
+
+  auto layouts = base_layout;
+  layoutspace::Legal layoutspace(arch_specs, layouts);
+  layoutspace.Init(arch_specs, mapping, layouts, true);
+  std::vector<layoutspace::IntralineConstraint> constraints;
+
+  LayoutSearchPool pool(1);
+  pool.Attach(0, &engine);
+  auto context = pool.NewMappingContext(mapping, workload, &sparse_optimizations, &crypto, true);
+  LayoutSearchPool::AttachLayoutSpace(context, 0, layoutspace, arch_specs, constraints, true);
+
+  // A construction failure, the cut-off candidate, then the valid one.
+  std::vector<LayoutSearchPool::Candidate> candidates(3);
+  candidates[0].id.splitting = layoutspace.splitting_candidates + 1;
+  pool.EvaluateCandidates(0, context, candidates);
+  BOOST_CHECK(!candidates[0].success);
+  BOOST_CHECK(!candidates[1].success);
+  BOOST_CHECK(candidates[2].success);
+
+  RecordingLayoutSearch search;
+  std::uint64_t actual_computes = 0;
+  int best = LayoutSearchPool::ReportCandidates(search, candidates, actual_computes);
+
+  BOOST_CHECK(search.reported_valid == std::vector<bool>({ false, false, true }));
+  BOOST_CHECK_EQUAL(best, 2);
+  BOOST_CHECK_EQUAL(search.best_cycles, candidates[2].cycles);
+  BOOST_CHECK(actual_computes > 0);
+  BOOST_CHECK_EQUAL(actual_computes, candidates[2].actual_computes);
+
+  // Only failed and cut-off candidates: nothing becomes the best layout.
+  candidates.pop_back();
+  RecordingLayoutSearch cut_off_search;
+  std::uint64_t no_computes = 0;
+  BOOST_CHECK_EQUAL(LayoutSearchPool::ReportCandidates(cut_off_search, candidates, no_computes), -1);
+  BOOST_CHECK_EQUAL(no_computes, 0);
+  BOOST_CHECK(!cut_off_search.has_best);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestStolenLayoutCandidatesMatchOwnerEvaluation, LayoutEvaluationFixture)
+{
+  // Candidates are built from their IDs by whichever worker evaluates them,
+  // in the owner's layout space or in a private one of a stealing worker.
+  auto layouts = base_layout;
+  layoutspace::Legal layoutspace(arch_specs, layouts);
+  layoutspace.Init(arch_specs, mapping, layouts, true);
+  std::vector<layoutspace::IntralineConstraint> constraints;
+
+  std::vector<LayoutSearchPool::Candidate> candidates;
+  for (std::uint64_t packing = 0; packing < std::min<std::uint64_t>(layoutspace.packing_candidates, 8); packing++)
+  {
+    candidates.emplace_back();
+    candidates.back().id.packing = packing;
+  }
+  BOOST_REQUIRE(!candidates.empty());
+
+  model::Engine owner_engine;
+  owner_engine.Spec(arch_specs);
+  LayoutSearchPool single_pool(1);
+  single_pool.Attach(0, &owner_engine);
+  auto single_context = single_pool.NewMappingContext(mapping, workload, &sparse_optimizations, &crypto, true);
+  LayoutSearchPool::AttachLayoutSpace(single_context, 0, layoutspace, arch_specs, constraints, true);
+  auto expected = candidates;
+  single_pool.EvaluateCandidates(0, single_context, expected);
+
+  model::Engine engines[2];
+  LayoutSearchPool pool(2);
+  for (unsigned w = 0; w < 2; w++)
+  {
+    engines[w].Spec(arch_specs);
+    pool.Attach(w, &engines[w]);
+  }
+  auto context = pool.NewMappingContext(mapping, workload, &sparse_optimizations, &crypto, true);
+  LayoutSearchPool::AttachLayoutSpace(context, 0, layoutspace, arch_specs, constraints, true);
+  std::thread thief([&pool] { pool.Retire(1); });
+  pool.EvaluateCandidates(0, context, candidates);
+  pool.Retire(0);
+  thief.join();
+
+  for (unsigned i = 0; i < candidates.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(candidates[i].success, expected[i].success);
+    BOOST_CHECK_EQUAL(candidates[i].cycles, expected[i].cycles);
+    BOOST_CHECK_CLOSE(candidates[i].energy_per_compute, expected[i].energy_per_compute, 1e-9);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(TestLayoutSpaceRebindsMappingAtSameAddress, LayoutEvaluationFixture)
+{
+  auto other_mapping = mapping::ParseAndConstruct(config.getRoot().lookup("two_imperfect_mapping"), arch_specs, workload);
+
+  // Layout ID 0 built by a layout space that only ever saw the given mapping.
+  auto fresh_layout = [&](const Mapping& m)
+  {
+    auto layouts = base_layout;
+    layoutspace::Legal layoutspace(arch_specs, layouts);
+    layoutspace.Init(arch_specs, m, layouts, true);
+    layoutspace.ConstructLayout(0, 0, 0, nullptr, m, true, false);
+    return layouts;
+  };
+  auto same_factors = [](const layout::Layouts& a, const layout::Layouts& b)
+  {
+    BOOST_REQUIRE_EQUAL(a.size(), b.size());
+    for (unsigned lvl = 0; lvl < a.size(); lvl++)
+    {
+      for (unsigned ds = 0; ds < a[lvl].intraline.size(); ds++)
+      {
+        BOOST_CHECK(a[lvl].intraline[ds].factors == b[lvl].intraline[ds].factors);
+        BOOST_CHECK(a[lvl].interline[ds].factors == b[lvl].interline[ds].factors);
+      }
+    }
+  };
+
+  // One mapping object, reassigned in place like the mapper's loop variable.
+  Mapping current = mapping;
+  auto layouts = base_layout;
+  layoutspace::Legal layoutspace(arch_specs, layouts);
+  layoutspace.Init(arch_specs, current, layouts, true);
+  layoutspace.ConstructLayout(0, 0, 0, nullptr, current, true, false);
+  same_factors(layouts, fresh_layout(mapping));
+
+  current = other_mapping;
+  layoutspace.Init(arch_specs, current, layouts, true);
+  layoutspace.ConstructLayout(0, 0, 0, nullptr, current, true, false);
+  same_factors(layouts, fresh_layout(other_mapping));
+}
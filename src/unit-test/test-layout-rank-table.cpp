@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+
+#include "layout/layout.hpp"
+
+namespace
+{
+
+layout::Layout MakeConvLayout()
+{
+  // H = P + R and W = Q + S share dimensions with P/R and Q/S; C is alone.
+  layout::Layout layout;
+  layout.rankToFactorizedDimensionID = {
+    {"C", {0}}, {"H", {1, 2}}, {"P", {1}}, {"R", {2}}, {"W", {3, 4}}
+  };
+  layout.rankToCoefficientValue = {{"H", {1, 1}}, {"W", {2, 1}}};
+  layout.rankToZeroPadding = {{"H", 1}};
+  return layout;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestRankTableInterning)
+{
+  auto table = layout::BuildRankTable(MakeConvLayout());
+
+  BOOST_CHECK(table->NumRanks() == 5);
+  BOOST_CHECK(table->names == std::vector<std::string>({"C", "H", "P", "R", "W"}));
+  BOOST_CHECK(table->ID("R") == 3);
+  BOOST_CHECK(table->dims[table->ID("W")] == std::vector<std::uint32_t>({3, 4}));
+  BOOST_CHECK(table->coefficients[table->ID("W")] == std::vector<std::uint32_t>({2, 1}));
+  BOOST_CHECK(table->coefficients[table->ID("C")].empty());
+  BOOST_CHECK(table->zero_padding[table->ID("H")] == 1);
+  BOOST_CHECK(table->zero_padding[table->ID("P")] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestRankTableGroups)
+{
+  auto table = layout::BuildRankTable(MakeConvLayout());
+
+  // {C}, {H, P, R} and {W}, each with the dimensions it spans.
+  BOOST_CHECK(table->rank_groups.size() == 3);
+  BOOST_CHECK(table->rank_groups.size() == table->dim_groups.size());
+  for (unsigned g = 0; g < table->rank_groups.size(); g++)
+  {
+    auto& ranks = table->rank_groups[g];
+    if (ranks.front() == table->ID("H"))
+    {
+      BOOST_CHECK(ranks == std::vector<unsigned>({1, 2, 3}));
+      BOOST_CHECK(table->dim_groups[g] == std::vector<std::uint32_t>({1, 2}));
+    }
+    else
+    {
+      BOOST_CHECK(ranks.size() == 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRankTableFactors)
+{
+  auto table = layout::BuildRankTable(MakeConvLayout());
+
+  layout::LayoutNest nest;
+  nest.ranks = {"H", "W"};
+  nest.factors = {{"H", 4}, {"W", 8}, {"K", 2}};
+
+  std::vector<std::uint32_t> factors;
+  table->Factors(nest, factors);
+  BOOST_CHECK(factors.size() == table->NumRanks());
+  BOOST_CHECK(factors[table->ID("H")] == 4);
+  BOOST_CHECK(factors[table->ID("W")] == 8);
+  BOOST_CHECK(factors[table->ID("C")] == 1);
+  BOOST_CHECK(table->IDs(nest.ranks) == std::vector<unsigned>({1, 4}));
+
+  // Refilling the same array leaves nothing of the previous nest behind.
+  layout::LayoutNest other;
+  other.factors = {{"C", 3}};
+  table->Factors(other, factors);
+  BOOST_CHECK(factors.size() == table->NumRanks());
+  BOOST_CHECK(factors[table->ID("C")] == 3);
+  BOOST_CHECK(factors[table->ID("H")] == 1);
+  BOOST_CHECK(factors[table->ID("W")] == 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestRankTableContentEquality)
+{
+  // Tables rebuilt from the same layout are distinct but interchangeable.
+  auto table = layout::BuildRankTable(MakeConvLayout());
+  auto rebuilt = layout::BuildRankTable(MakeConvLayout());
+  BOOST_CHECK(table != rebuilt);
+  BOOST_CHECK(*table == *rebuilt);
+
+  auto padded = MakeConvLayout();
+  padded.rankToZeroPadding["W"] = 2;
+  BOOST_CHECK(*table != *layout::BuildRankTable(padded));
+}
@@ -0,0 +1,104 @@
+#include <set>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "layoutspaces/layoutspace.hpp"
+
+BOOST_AUTO_TEST_CASE(TestSamplerExhaustiveWhenSmall)
+{
+  std::mt19937_64 generator(7);
+  layoutspace::Sampler sampler(10, 0, 64, generator);
+
+  BOOST_CHECK(sampler.Exhaustive());
+  std::uint64_t id;
+  for (std::uint64_t expected = 0; expected < 10; expected++)
+  {
+    BOOST_CHECK(sampler.Next(id));
+    BOOST_CHECK(id == expected);
+  }
+  BOOST_CHECK(!sampler.Next(id));
+}
+
+BOOST_AUTO_TEST_CASE(TestSamplerWithoutReplacement)
+{
+  std::mt19937_64 generator(7);
+  layoutspace::Sampler sampler(1000, 0, 64, generator);
+
+  BOOST_CHECK(!sampler.Exhaustive());
+  std::set<std::uint64_t> drawn;
+  std::uint64_t id;
+  while (sampler.Next(id))
+  {
+    BOOST_CHECK(id < 1000);
+    drawn.insert(id);
+  }
+  // A full permutation of the space: every ID exactly once.
+  BOOST_CHECK(drawn.size() == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(TestSamplerBudget)
+{
+  std::mt19937_64 generator(7);
+  // The budget does not cover the small space, so it is sampled instead.
+  layoutspace::Sampler sampler(50, 20, 64, generator);
+
+  BOOST_CHECK(!sampler.Exhaustive());
+  std::set<std::uint64_t> drawn;
+  std::uint64_t id;
+  while (sampler.Next(id))
+  {
+    drawn.insert(id);
+  }
+  BOOST_CHECK(drawn.size() == 20);
+}
+
+BOOST_AUTO_TEST_CASE(TestSamplerPrefixIsUniform)
+{
+  // Early stopping only ever consumes a short prefix of the draws, so the
+  // prefix itself must spread over the whole space, not along a lattice.
+  std::mt19937_64 generator(7);
+  layoutspace::Sampler sampler(1 << 20, 0, 64, generator);
+
+  const unsigned num_draws = 400;
+  const unsigned num_buckets = 8;
+  std::vector<unsigned> buckets(num_buckets, 0);
+  std::set<std::uint64_t> strides;
+  std::uint64_t id, prev_id = 0;
+  for (unsigned i = 0; i < num_draws; i++)
+  {
+    BOOST_CHECK(sampler.Next(id));
+    buckets[id / ((1 << 20) / num_buckets)]++;
+    if (i > 0)
+      strides.insert((id + (1 << 20) - prev_id) % (1 << 20));
+    prev_id = id;
+  }
+  for (auto count : buckets)
+  {
+    BOOST_CHECK(count > 25 && count < 75);
+  }
+  BOOST_CHECK(strides.size() > num_draws / 2);
+}
+
+BOOST_AUTO_TEST_CASE(TestSamplerFirstDrawIsUniform)
+{
+  std::mt19937_64 generator(7);
+  const unsigned size = 10;
+  const unsigned num_samplers = 5000;
+  std::vector<unsigned> first(size, 0);
+  std::vector<unsigned> second(size, 0);
+  for (unsigned s = 0; s < num_samplers; s++)
+  {
+    layoutspace::Sampler sampler(size, 0, 0, generator);
+    std::uint64_t a, b;
+    BOOST_CHECK(sampler.Next(a) && sampler.Next(b));
+    BOOST_CHECK(a != b);
+    first[a]++;
+    second[b]++;
+  }
+  for (unsigned i = 0; i < size; i++)
+  {
+    BOOST_CHECK(first[i] > 400 && first[i] < 600);
+    BOOST_CHECK(second[i] > 400 && second[i] < 600);
+  }
+}
@@ -0,0 +1,42 @@
+#include <set>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+#include "layoutspaces/best-first.hpp"
+
+BOOST_AUTO_TEST_CASE(TestBestFirstJointStageSpendsBudgetOnNewPairs)
+{
+  // Only the space sizes of the layout space are consulted.
+  model::Engine::Specs arch_specs;
+  layout::Layouts layouts;
+  layoutspace::Legal layoutspace(arch_specs, layouts);
+  layoutspace.splitting_candidates = 3;
+  layoutspace.packing_candidates = 3;
+  layoutspace.authblock_candidates = 1;
+
+  // Sample every phase, with a budget that covers the 2 * 2 pairs left for
+  // the joint stage but not the 9 pairs of the whole space.
+  layoutspace::SamplingConfig sampling;
+  sampling.exhaustive_threshold = 0;
+  sampling.packing_budget = 4;
+  layoutspace::BestFirstLayoutSearch search(sampling, 100);
+  search.Init(layoutspace, false);
+
+  // Splitting 1 has the best estimate, so the packing stage samples (1, p).
+  const std::uint64_t best_splitting = 1;
+  std::set<std::pair<std::uint64_t, std::uint64_t>> visited;
+  unsigned joint_candidates = 0;
+  layoutspace::LayoutID layout_id;
+  while (search.Next(layout_id))
+  {
+    BOOST_CHECK(visited.insert({ layout_id.splitting, layout_id.packing }).second);
+    if (layout_id.splitting != best_splitting && layout_id.packing != 0)
+      joint_candidates++;
+    std::uint64_t cycles = (layout_id.splitting == best_splitting ? 50 : 100) + layout_id.packing;
+    search.Report(layout_id, true, cycles, 1.0);
+  }
+
+  BOOST_CHECK_EQUAL(joint_candidates, 4u);
+  BOOST_CHECK_EQUAL(visited.size(), 9u);
+}
@@ -0,0 +1,39 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+
+#include "applications/mapper/result-cache.hpp"
+
+BOOST_AUTO_TEST_CASE(TestResultCacheCanonicalText)
+{
+  auto a = YAML::Load("{mapper: {num_threads: 4, timeout: 10}, arch: [x, y]}");
+  auto b = YAML::Load("arch:\n  - x\n  - y\nmapper:\n  timeout: 10\n  num_threads: 4\n");
+  auto c = YAML::Load("{mapper: {num_threads: 4, timeout: 10}, arch: [y, x]}");
+
+  BOOST_CHECK(ResultCache::CanonicalText(a) == ResultCache::CanonicalText(b));
+  // Sequence order is significant.
+  BOOST_CHECK(ResultCache::CanonicalText(a) != ResultCache::CanonicalText(c));
+  BOOST_CHECK(ResultCache::CanonicalText(a, {"arch"}) == ResultCache::CanonicalText(c, {"arch"}));
+}
+
+BOOST_AUTO_TEST_CASE(TestResultCacheStoreLookup)
+{
+  auto dir = std::filesystem::temp_directory_path() / "timeloop-test-result-cache";
+  std::filesystem::remove_all(dir);
+
+  ResultCache cache(dir.string());
+  std::string value;
+  BOOST_CHECK(!cache.Lookup("key", value));
+
+  std::string stored("binary\0value\n", 13);
+  cache.Store("key", stored);
+  BOOST_CHECK(cache.Lookup("key", value));
+  BOOST_CHECK(value == stored);
+  BOOST_CHECK(!cache.Lookup("other key", value));
+
+  cache.Store("key", "replaced");
+  BOOST_CHECK(cache.Lookup("key", value));
+  BOOST_CHECK(value == "replaced");
+
+  std::filesystem::remove_all(dir);
+}
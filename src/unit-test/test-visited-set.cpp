@@ -0,0 +1,62 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "search/visited-set.hpp"
+
+BOOST_AUTO_TEST_CASE(TestVisitedSetExact)
+{
+  search::HashVisitedSet hash;
+  search::BitmapVisitedSet bitmap(130);
+  for (search::VisitedSet* set : std::vector<search::VisitedSet*>{&hash, &bitmap})
+  {
+    BOOST_CHECK(set->Exact());
+    BOOST_CHECK(set->Insert(0));
+    BOOST_CHECK(set->Insert(129));
+    BOOST_CHECK(!set->Insert(129));
+    BOOST_CHECK(set->Insert(64));
+    BOOST_CHECK(set->Size() == 3);
+  }
+
+  std::stringstream state;
+  bitmap.SaveState(state);
+  search::BitmapVisitedSet loaded(130);
+  BOOST_CHECK(loaded.LoadState(state));
+  BOOST_CHECK(loaded.Size() == 3);
+  BOOST_CHECK(!loaded.Insert(64));
+  BOOST_CHECK(loaded.Insert(65));
+
+  // A state of another kind is rejected.
+  std::stringstream hash_state;
+  hash.SaveState(hash_state);
+  BOOST_CHECK(!loaded.LoadState(hash_state));
+}
+
+BOOST_AUTO_TEST_CASE(TestVisitedSetBloom)
+{
+  search::BloomVisitedSet bloom(1 << 16, 0.01);
+  BOOST_CHECK(!bloom.Exact());
+
+  const unsigned n = 2000;
+  BOOST_CHECK(n < bloom.Capacity());
+  uint128_t base = uint128_t(1) << 90;
+  unsigned inserted = 0;
+  for (unsigned i = 0; i < n; i++)
+  {
+    inserted += bloom.Insert(base + i * 7919);
+  }
+  // Every visited ID is rejected; few unvisited ones are.
+  for (unsigned i = 0; i < n; i++)
+  {
+    BOOST_CHECK(!bloom.Insert(base + i * 7919));
+  }
+  BOOST_CHECK(inserted > n * 0.98);
+  BOOST_CHECK(bloom.Size() == inserted);
+
+  std::stringstream state;
+  bloom.SaveState(state);
+  search::BloomVisitedSet loaded(1 << 16, 0.01);
+  BOOST_CHECK(loaded.LoadState(state));
+  BOOST_CHECK(loaded.Size() == bloom.Size());
+  BOOST_CHECK(!loaded.Insert(base));
+}
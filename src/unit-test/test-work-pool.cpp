@@ -0,0 +1,45 @@
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+
+#include "search/work-pool.hpp"
+
+BOOST_AUTO_TEST_CASE(TestWorkPoolCoversSpaceOnce)
+{
+  for (bool scatter : {false, true})
+  {
+    const unsigned size = 1000;
+    search::WorkPool pool(size, 3, 16, scatter);
+
+    // Thread 0 claims everything it can; the others come late and steal.
+    std::set<uint128_t> seen;
+    uint128_t id;
+    unsigned claimed = 0;
+    for (unsigned i = 0; i < 900 && pool.Next(0, id); i++)
+    {
+      BOOST_CHECK(seen.insert(id).second);
+      claimed++;
+    }
+    for (unsigned t = 1; pool.Next(t, id); t = 1 + t % 2)
+    {
+      BOOST_CHECK(id < size);
+      BOOST_CHECK(seen.insert(id).second);
+      claimed++;
+    }
+    BOOST_CHECK(claimed == size);
+    BOOST_CHECK(seen.size() == size);
+    BOOST_CHECK(!pool.Next(0, id));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestWorkPoolSteal)
+{
+  search::WorkPool pool(100, 2, 100, false);
+
+  // Thread 0 holds the whole space after its first claim.
+  uint128_t id;
+  BOOST_CHECK(pool.Next(0, id) && id == 0);
+  BOOST_CHECK(pool.Next(1, id) && id == 50);
+  BOOST_CHECK(pool.Steals() == 1);
+  BOOST_CHECK(pool.Next(0, id) && id == 1);
+}
@@ -34,12 +34,26 @@ bool ParseArgs(int argc, char* argv[],
                std::vector<std::string>& input_files,
                std::string& output_dir)
 {
-  // Very rudimentary argument parsing. The only recognized pattern is "-o <odir>"
-  // and a set of .yaml or .cfg files.
+  std::set<std::string> options;
+  return ParseArgs(argc, argv, input_files, output_dir, {}, options);
+}
+
+bool ParseArgs(int argc, char* argv[],
+               std::vector<std::string>& input_files,
+               std::string& output_dir,
+               const std::set<std::string>& known_options,
+               std::set<std::string>& options)
+{
+  // Very rudimentary argument parsing. The only recognized patterns are "-o <odir>",
+  // the given "--<option>" flags and a set of .yaml or .cfg files.
   std::vector<std::string> input_args(argv + 1, argv + argc);
   for (auto arg = input_args.begin(); arg != input_args.end(); arg++)
   {
-    if (arg->compare("-o") == 0)
+    if (known_options.count(*arg))
+    {
+      options.insert(*arg);
+    }
+    else if (arg->compare("-o") == 0)
     {
       arg++;
       output_dir = *arg;
@@ -844,6 +844,15 @@ uint128_t SequenceGenerator128::Next()
   return retval;
 }
 
+void SequenceGenerator128::SaveState(std::ostream& out) const
+{
+  out << cur_ << ' ';
+}
+
+void SequenceGenerator128::LoadState(std::istream& in)
+{
+  in >> cur_;
+}
 
 RandomGenerator128::RandomGenerator128(uint128_t bound) :
     PatternGenerator128(bound),
@@ -869,6 +878,16 @@ uint128_t RandomGenerator128::Next()
   return rand;
 }
 
+void RandomGenerator128::SaveState(std::ostream& out) const
+{
+  out << engine_ << ' ' << low_gen_ << ' ' << high_gen_ << ' ';
+}
+
+void RandomGenerator128::LoadState(std::istream& in)
+{
+  in >> engine_ >> low_gen_ >> high_gen_;
+}
+
 
 //------------------------------------
 //           Miscellaneous
@@ -502,6 +502,11 @@ bool OperationSpace::CheckEquality(const OperationSpace& rhs, const int t) const
   return data_spaces_.at(t) == rhs.data_spaces_.at(t);
 }
 
+std::size_t OperationSpace::Hash(const int t) const
+{
+  return data_spaces_.at(t).Hash();
+}
+
 void OperationSpace::PrintSizes()
 {
   for (unsigned i = 0; i < data_spaces_.size()-1; i++)